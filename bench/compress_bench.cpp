@@ -0,0 +1,194 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "data_compress.h"
+#include "data_writer.h"
+#include "signal_fragment.h"
+#include "signal_header.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace efis_signals;
+
+// Define the benchmark parameters
+static const size_t BENCH_MTU = 1400;
+static const size_t BENCH_ITERATIONS = 2000;
+
+/**
+ * @brief make_terrain_tile provides a smooth grid of big-endian 16-bit elevations
+ * @param size is the number of bytes to generate
+ * @return the generated tile data
+ */
+static std::vector<uint8_t> make_terrain_tile(const size_t size)
+{
+    std::vector<uint8_t> data(size);
+    const size_t width = 32;
+    for (size_t i = 0; i + 1 < size; i += 2)
+    {
+        const size_t x = (i / 2) % width;
+        const size_t y = (i / 2) / width;
+        const double elevation = 1500.0 + 400.0 * std::sin(x * 0.15) * std::cos(y * 0.1);
+        const uint16_t value = static_cast<uint16_t>(elevation) & 0xFFF0;
+        data[i] = static_cast<uint8_t>(value >> 8);
+        data[i + 1] = static_cast<uint8_t>(value);
+    }
+    return data;
+}
+
+/**
+ * @brief make_flight_plan provides fixed-size waypoint records with text identifiers
+ * @param size is the number of bytes to generate
+ * @return the generated flight plan data
+ */
+static std::vector<uint8_t> make_flight_plan(const size_t size)
+{
+    std::vector<uint8_t> data(size, 0);
+    const size_t record_size = 32;
+    for (size_t record = 0; (record + 1) * record_size <= size; ++record)
+    {
+        uint8_t* ptr = data.data() + record * record_size;
+        snprintf(reinterpret_cast<char*>(ptr), 8, "WPT%03u", static_cast<unsigned>(record % 1000));
+
+        const int32_t latitude = 47000000 + static_cast<int32_t>(record) * 1375;
+        const int32_t longitude = -122000000 - static_cast<int32_t>(record) * 2250;
+        const uint16_t altitude = static_cast<uint16_t>(5000 + (record % 4) * 500);
+        memcpy(ptr + 8, &latitude, sizeof(latitude));
+        memcpy(ptr + 12, &longitude, sizeof(longitude));
+        memcpy(ptr + 16, &altitude, sizeof(altitude));
+    }
+    return data;
+}
+
+/**
+ * @brief make_random provides incompressible data
+ * @param size is the number of bytes to generate
+ * @return the generated random data
+ */
+static std::vector<uint8_t> make_random(const size_t size)
+{
+    std::vector<uint8_t> data(size);
+    srand(1);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<uint8_t>(rand());
+    }
+    return data;
+}
+
+/**
+ * @brief frames_for_size determines the number of fragment frames required to send the payload
+ * @param size is the payload size
+ * @return the number of frames
+ */
+static size_t frames_for_size(const size_t size)
+{
+    const size_t chunk = BENCH_MTU - SignalHeader::HEADER_SIZE - FragmentHeader::HEADER_SIZE;
+    return size > 0 ? (size + chunk - 1) / chunk : 1;
+}
+
+/**
+ * @brief run_dataset benchmarks compression of the provided dataset against sending
+ * the raw values, printing a single CSV result line
+ * @param name is the name of the dataset
+ * @param data is the dataset values
+ */
+static void run_dataset(
+        const char* name,
+        const std::vector<uint8_t>& data)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<uint8_t> compressed(data.size());
+    std::vector<uint8_t> decompressed(data.size());
+    std::vector<uint8_t> raw_frame(data.size());
+
+    // Time the raw copy into a frame buffer
+    const clock::time_point raw_start = clock::now();
+    for (size_t i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        DataWriter writer;
+        writer.set_buffer(raw_frame.data(), raw_frame.size());
+        writer.add_bytes(data.data(), data.size());
+    }
+    const double raw_seconds = std::chrono::duration<double>(clock::now() - raw_start).count();
+
+    // Time compression
+    size_t compressed_size = 0;
+    const clock::time_point compress_start = clock::now();
+    for (size_t i = 0; i < BENCH_ITERATIONS; ++i)
+    {
+        compressed_size = lz_compress(data.data(), data.size(), compressed.data(), data.size() - 1);
+    }
+    const double compress_seconds = std::chrono::duration<double>(clock::now() - compress_start).count();
+
+    // Time decompression, if the data was compressible
+    double decompress_seconds = 0.0;
+    bool valid = true;
+    if (compressed_size > 0)
+    {
+        const clock::time_point decompress_start = clock::now();
+        for (size_t i = 0; i < BENCH_ITERATIONS; ++i)
+        {
+            valid &= lz_decompress(compressed.data(), compressed_size, decompressed.data(), data.size());
+        }
+        decompress_seconds = std::chrono::duration<double>(clock::now() - decompress_start).count();
+        valid &= memcmp(decompressed.data(), data.data(), data.size()) == 0;
+    }
+
+    const double megabytes = static_cast<double>(data.size()) * BENCH_ITERATIONS / 1.0e6;
+    const size_t sent_size = compressed_size > 0 ? compressed_size : data.size();
+
+    printf("%s,%zu,%zu,%.3f,%.1f,%.1f,%.1f,%zu,%zu,%s\n",
+           name,
+           data.size(),
+           sent_size,
+           static_cast<double>(sent_size) / data.size(),
+           megabytes / compress_seconds,
+           decompress_seconds > 0.0 ? megabytes / decompress_seconds : 0.0,
+           megabytes / raw_seconds,
+           frames_for_size(data.size()),
+           frames_for_size(sent_size),
+           valid ? "ok" : "mismatch");
+}
+
+int main()
+{
+    printf("dataset,raw_bytes,sent_bytes,ratio,compress_mbps,decompress_mbps,raw_copy_mbps,raw_frames,sent_frames,check\n");
+
+    const size_t sizes[] = { 1024, 4096, 65536 };
+    for (const size_t size : sizes)
+    {
+        char name[64];
+
+        snprintf(name, sizeof(name), "terrain_%zu", size);
+        run_dataset(name, make_terrain_tile(size));
+
+        snprintf(name, sizeof(name), "flight_plan_%zu", size);
+        run_dataset(name, make_flight_plan(size));
+
+        snprintf(name, sizeof(name), "random_%zu", size);
+        run_dataset(name, make_random(size));
+    }
+
+    return 0;
+}
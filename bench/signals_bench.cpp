@@ -0,0 +1,787 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "crc16.h"
+#include "data_reader.h"
+#include "data_writer.h"
+#include "gen_signal_def.h"
+#include "gen_signal_types.h"
+#include "signal_compact.h"
+#include "signal_database.h"
+#include "signal_header.h"
+#include "signal_packer.h"
+#include "signal_redundancy.h"
+#include "signal_trace.h"
+#include "signal_type_scaled.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace efis_signals;
+
+/**
+ * @brief bench_sink receives benchmark results so that the measured work is not optimized away
+ */
+static volatile uint64_t bench_sink = 0;
+
+/**
+ * @brief The BenchResult struct provides the measured result of a single benchmark
+ */
+struct BenchResult
+{
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    size_t bytes_per_op;
+};
+
+/**
+ * @brief The BenchRunner class runs each benchmark for a calibrated number of
+ * iterations, reporting the median of several timed batches
+ */
+class BenchRunner
+{
+public:
+    /**
+     * @brief BenchRunner constructs the benchmark runner
+     * @param min_seconds is the minimum total time to spend timing each benchmark
+     * @param filter is a substring that benchmark names must contain to be run
+     */
+    BenchRunner(
+            const double min_seconds,
+            const std::string& filter) :
+        min_seconds(min_seconds),
+        filter(filter)
+    {
+        // Empty Constructor
+    }
+
+    /**
+     * @brief run times the provided operation
+     * @param name is the benchmark name
+     * @param bytes_per_op is the number of bytes processed per operation, or 0 if not applicable
+     * @param op is the operation to time
+     */
+    template <typename F>
+    void run(
+            const std::string& name,
+            const size_t bytes_per_op,
+            F op)
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+        {
+            return;
+        }
+
+        // Calibrate the number of iterations so that each batch takes a fraction of the minimum time
+        const double batch_seconds = min_seconds / BATCH_COUNT;
+        uint64_t iterations = 1;
+        while (time_batch(op, iterations) < batch_seconds && iterations < (static_cast<uint64_t>(1) << 40))
+        {
+            iterations *= 2;
+        }
+
+        // Time each batch, reporting the median time per operation
+        std::vector<double> samples;
+        for (size_t i = 0; i < BATCH_COUNT; ++i)
+        {
+            samples.push_back(time_batch(op, iterations) * 1.0e9 / iterations);
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.ns_per_op = samples[samples.size() / 2];
+        result.bytes_per_op = bytes_per_op;
+        results.push_back(result);
+    }
+
+    /**
+     * @brief print writes the results to the standard output
+     * @param json writes the results as a JSON array if true, or as CSV otherwise
+     */
+    void print(const bool json) const
+    {
+        if (json)
+        {
+            printf("[\n");
+        }
+        else
+        {
+            printf("benchmark,iterations,ns_per_op,ops_per_sec,bytes_per_op,mb_per_sec\n");
+        }
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult& result = results[i];
+            const double ops_per_sec = result.ns_per_op > 0.0 ? 1.0e9 / result.ns_per_op : 0.0;
+            const double mb_per_sec = ops_per_sec * result.bytes_per_op / 1.0e6;
+
+            if (json)
+            {
+                printf("  {\"benchmark\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                       "\"ops_per_sec\": %.1f, \"bytes_per_op\": %zu, \"mb_per_sec\": %.1f}%s\n",
+                       result.name.c_str(),
+                       static_cast<unsigned long long>(result.iterations),
+                       result.ns_per_op,
+                       ops_per_sec,
+                       result.bytes_per_op,
+                       mb_per_sec,
+                       i + 1 < results.size() ? "," : "");
+            }
+            else
+            {
+                printf("%s,%llu,%.3f,%.1f,%zu,%.1f\n",
+                       result.name.c_str(),
+                       static_cast<unsigned long long>(result.iterations),
+                       result.ns_per_op,
+                       ops_per_sec,
+                       result.bytes_per_op,
+                       mb_per_sec);
+            }
+        }
+
+        if (json)
+        {
+            printf("]\n");
+        }
+    }
+
+protected:
+    /**
+     * @brief time_batch runs the operation the provided number of times
+     * @param op is the operation to run
+     * @param iterations is the number of times to run the operation
+     * @return the elapsed time in seconds
+     */
+    template <typename F>
+    static double time_batch(
+            F& op,
+            const uint64_t iterations)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            op();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief BATCH_COUNT provides the number of timed batches per benchmark
+     */
+    static const size_t BATCH_COUNT = 5;
+
+protected:
+    double min_seconds;
+    std::string filter;
+    std::vector<BenchResult> results;
+};
+
+/**
+ * @brief set_scaled_source_type sets the source type of every scaled signal in the database
+ * @param signals is the list of scaled signals
+ * @param type is the source type to set
+ */
+static void set_scaled_source_type(
+        const std::vector<SignalTypeScaled*>& signals,
+        const SignalSourceType type)
+{
+    for (SignalTypeScaled* signal : signals)
+    {
+        signal->set_source_type(type);
+    }
+}
+
+/**
+ * @brief build_frame writes count scaled records into the buffer, cycling through the signals
+ * @param signals is the list of transmitted scaled signals
+ * @param count is the number of records to write
+ * @param format is the wire format to write the records with
+ * @param buffer is the buffer to write into
+ * @return the number of bytes written
+ */
+static size_t build_frame(
+        const std::vector<SignalTypeScaled*>& signals,
+        const size_t count,
+        const WireFormat format,
+        std::vector<uint8_t>& buffer)
+{
+    DataWriter writer;
+    writer.set_buffer(buffer.data(), buffer.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SignalTypeScaled* signal = signals[i % signals.size()];
+        const size_t payload_size = signal->packet_size();
+        size_t payload_start = 0;
+        signal->get_header().write_record_start(writer, format, payload_size, payload_start);
+        signal->serialize(writer);
+        SignalHeader::write_record_end(writer, format, payload_size, payload_start);
+    }
+
+    return buffer.size() - writer.bytes_available();
+}
+
+static void add_codec_benchmarks(BenchRunner& runner)
+{
+    static std::vector<uint8_t> buffer(16384);
+    static std::vector<double> values(1024);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<double>(i) * 0.37 - 100.0;
+    }
+
+    runner.run("codec/write_uint_x1024", 4096, []()
+    {
+        DataWriter writer;
+        writer.set_buffer(buffer.data(), buffer.size());
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            writer.add_uint(i);
+        }
+        bench_sink += buffer[100];
+    });
+
+    runner.run("codec/read_uint_x1024", 4096, []()
+    {
+        DataReader reader;
+        reader.set_buffer(buffer.data(), buffer.size());
+        uint32_t total = 0;
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            uint32_t value = 0;
+            reader.read_uint(value);
+            total += value;
+        }
+        bench_sink += total;
+    });
+
+    runner.run("codec/write_bytes_4096", 4096, []()
+    {
+        DataWriter writer;
+        writer.set_buffer(buffer.data(), buffer.size());
+        writer.add_bytes(buffer.data() + 8192, 4096);
+        bench_sink += buffer[100];
+    });
+
+    runner.run("codec/read_bytes_4096", 4096, []()
+    {
+        DataReader reader;
+        reader.set_buffer(buffer.data(), buffer.size());
+        reader.read_bytes(buffer.data() + 8192, 4096);
+        bench_sink += buffer[8192 + 100];
+    });
+
+    runner.run("codec/write_scaled_array_x1024", 4096, []()
+    {
+        DataWriter writer;
+        writer.set_buffer(buffer.data(), buffer.size());
+        writer.add_scaled_array(values.data(), values.size(), 0.01);
+        bench_sink += buffer[100];
+    });
+
+    runner.run("codec/read_scaled_array_x1024", 4096, []()
+    {
+        DataReader reader;
+        reader.set_buffer(buffer.data(), buffer.size());
+        reader.read_scaled_array(values.data(), values.size(), 0.01);
+        bench_sink += static_cast<uint64_t>(values[100]);
+    });
+}
+
+static void add_header_benchmarks(BenchRunner& runner)
+{
+    static std::vector<uint8_t> buffer(SignalHeader::HEADER_SIZE * 256);
+
+    runner.run("header/encode_x256", SignalHeader::HEADER_SIZE * 256, []()
+    {
+        DataWriter writer;
+        writer.set_buffer(buffer.data(), buffer.size());
+
+        SignalHeader header;
+        header.priority = 0x80;
+        header.from_device = 10;
+        for (size_t i = 0; i < 256; ++i)
+        {
+            header.cat_id = static_cast<uint8_t>(i);
+            header.sub_id = static_cast<uint8_t>(i * 7);
+            header.timestamp = static_cast<uint32_t>(i);
+            header.write_header(writer);
+        }
+        bench_sink += buffer[100];
+    });
+
+    runner.run("header/decode_x256", SignalHeader::HEADER_SIZE * 256, []()
+    {
+        DataReader reader;
+        reader.set_buffer(buffer.data(), buffer.size());
+
+        SignalHeader header;
+        uint32_t total = 0;
+        for (size_t i = 0; i < 256; ++i)
+        {
+            header.read_header(reader);
+            total += header.timestamp;
+        }
+        bench_sink += total;
+    });
+}
+
+static void add_lookup_benchmarks(
+        BenchRunner& runner,
+        const std::vector<SignalDef>& defs)
+{
+    static std::vector<SignalDef> lookup_defs;
+    static std::vector<std::string> lookup_names;
+
+    lookup_defs = defs;
+    lookup_names.clear();
+    for (const SignalDef& def : lookup_defs)
+    {
+        std::string name;
+        get_signal_name_for_def(def, name);
+        lookup_names.push_back(name);
+    }
+
+    const std::string count = std::to_string(lookup_defs.size());
+
+    runner.run("lookup/cat_sub_to_def_x" + count, 0, []()
+    {
+        SignalDef def = SIGNAL_DEF_NULL;
+        uint32_t total = 0;
+        for (const SignalDef& lookup : lookup_defs)
+        {
+            get_signal_for_cat_sub_id(lookup.category_id, lookup.sub_id, def);
+            total += def.timeout_millis;
+        }
+        bench_sink += total;
+    });
+
+    runner.run("lookup/name_to_def_x" + count, 0, []()
+    {
+        SignalDef def = SIGNAL_DEF_NULL;
+        uint32_t total = 0;
+        for (const std::string& name : lookup_names)
+        {
+            get_signal_def_for_name(name, def);
+            total += def.timeout_millis;
+        }
+        bench_sink += total;
+    });
+
+    runner.run("lookup/def_to_name_x" + count, 0, []()
+    {
+        std::string name;
+        size_t total = 0;
+        for (const SignalDef& def : lookup_defs)
+        {
+            get_signal_name_for_def(def, name);
+            total += name.size();
+        }
+        bench_sink += total;
+    });
+
+    runner.run("lookup/database_get_signal_x" + count, 0, []()
+    {
+        const SignalDatabase& database = SignalDatabase::get_instance();
+        SignalTypeBase* signal = nullptr;
+        size_t total = 0;
+        for (const SignalDef& def : lookup_defs)
+        {
+            database.get_signal(def, &signal);
+            total += reinterpret_cast<uintptr_t>(signal) & 0xFF;
+        }
+        bench_sink += total;
+    });
+}
+
+static void add_crc_benchmarks(BenchRunner& runner)
+{
+    static std::vector<uint8_t> buffer(1400);
+    static CRC16 crc;
+
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        buffer[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    runner.run("crc16/compute_1400", buffer.size(), []()
+    {
+        bench_sink += crc.compute(buffer.data(), static_cast<uint32_t>(buffer.size()));
+    });
+}
+
+static void add_redundancy_benchmarks(BenchRunner& runner)
+{
+    // Build a frame holding only the frame information record, so that the sequence
+    // number can be advanced in place. The payload holds the sequence number and the
+    // signal list fingerprint
+    static uint8_t frame[SignalHeader::HEADER_SIZE + 8];
+    static uint32_t sequence;
+    static RedundancyManager redundancy;
+
+    DataWriter writer;
+    writer.set_buffer(frame, sizeof(frame));
+    SignalDatabase::get_instance().write_frame_info(10, writer);
+    sequence = 0;
+
+    // Each frame arrives on both networks, with the second copy dropped
+    runner.run("redundancy/accept_frame_pair", sizeof(frame) * 2, []()
+    {
+        sequence += 1;
+        frame[SignalHeader::HEADER_SIZE + 0] = static_cast<uint8_t>(sequence >> 24);
+        frame[SignalHeader::HEADER_SIZE + 1] = static_cast<uint8_t>(sequence >> 16);
+        frame[SignalHeader::HEADER_SIZE + 2] = static_cast<uint8_t>(sequence >> 8);
+        frame[SignalHeader::HEADER_SIZE + 3] = static_cast<uint8_t>(sequence);
+
+        DataReader reader;
+        reader.set_buffer(frame, sizeof(frame));
+        bench_sink += redundancy.accept_frame(0, reader, 0);
+        bench_sink += redundancy.accept_frame(1, reader, 0);
+    });
+}
+
+static void add_database_benchmarks(
+        BenchRunner& runner,
+        const std::vector<SignalTypeScaled*>& scaled_signals)
+{
+    static std::vector<SignalTypeScaled*> signals;
+    static std::vector<uint8_t> frame(65536);
+    static std::vector<SignalTypeBase*> all_signals;
+
+    signals = scaled_signals;
+
+    SignalDatabase& database = SignalDatabase::get_instance();
+    all_signals.clear();
+    for (size_t i = 0; i < database.size(); ++i)
+    {
+        SignalTypeBase* signal = nullptr;
+        if (database.get_signal_for_index(i, &signal))
+        {
+            all_signals.push_back(signal);
+        }
+    }
+
+    // Benchmark the transmit side, with valid transmitted values
+    set_scaled_source_type(signals, SignalSourceType::Transmitted);
+    for (SignalTypeScaled* signal : signals)
+    {
+        signal->set_priority(0x80);
+        signal->set_value(1.0);
+    }
+
+    runner.run("database/write_record_scaled", 0, []()
+    {
+        static uint8_t buffer[64];
+        DataWriter writer;
+        writer.set_buffer(buffer, sizeof(buffer));
+        SignalDatabase::get_instance().write_data_from_dictionary(signals[0]->get_header().get_signal_def(), writer);
+        bench_sink += buffer[10];
+    });
+
+    runner.run("database/write_due_sweep", 0, []()
+    {
+        DataWriter writer;
+        writer.set_buffer(frame.data(), frame.size());
+        bench_sink += SignalDatabase::get_instance().write_due_from_dictionary(writer);
+    });
+
+    // Compare the shared resolution accessors with the compile-time resolution
+    // accessors of the concrete signal type
+    static SignalTypeAltitudeMsl* altitude = nullptr;
+    if (database.get_signal_type(SIGNAL_DEF_ALTITUDE_MSL, &altitude))
+    {
+        runner.run("database/scaled_set_get_x256", 0, []()
+        {
+            SignalTypeScaled* signal = altitude;
+            double total = 0.0;
+            for (size_t i = 0; i < 256; ++i)
+            {
+                signal->set_value(static_cast<double>(i) * 12.5);
+                total += signal->get_value();
+            }
+            bench_sink += static_cast<uint64_t>(total);
+        });
+
+        runner.run("database/unit_set_get_x256", 0, []()
+        {
+            double total = 0.0;
+            for (size_t i = 0; i < 256; ++i)
+            {
+                altitude->set(static_cast<double>(i) * 12.5);
+                total += altitude->value();
+            }
+            bench_sink += static_cast<uint64_t>(total);
+        });
+    }
+
+    // Record frames of varying sizes for the receive side
+    const size_t frame_counts[] = { 1, 8, 32, 128 };
+    static std::vector<std::vector<uint8_t>> frames;
+    frames.clear();
+    for (const size_t count : frame_counts)
+    {
+        std::vector<uint8_t> buffer(65536);
+        buffer.resize(build_frame(signals, count, WireFormat::V1, buffer));
+        frames.push_back(buffer);
+    }
+
+    // Benchmark the receive side
+    set_scaled_source_type(signals, SignalSourceType::Received);
+
+    runner.run("database/read_record_scaled", frames[0].size(), []()
+    {
+        DataReader reader;
+        reader.set_buffer(frames[0].data(), frames[0].size());
+        bench_sink += SignalDatabase::get_instance().read_data_into_dictionary(reader);
+    });
+
+    runner.run("database/is_valid_sweep_x" + std::to_string(all_signals.size()), 0, []()
+    {
+        size_t total = 0;
+        for (const SignalTypeBase* signal : all_signals)
+        {
+            total += signal->is_valid();
+        }
+        bench_sink += total;
+    });
+
+    // Run the ingest benchmarks with statistics disabled and then enabled, to
+    // measure the cost of the ingest statistics
+    for (const bool statistics_enabled : { false, true })
+    {
+        SignalDatabase::get_instance().get_statistics().set_enabled(statistics_enabled);
+        const std::string suffix = statistics_enabled ? "_stats" : "";
+
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            static size_t frame_index;
+            frame_index = i;
+
+            runner.run("macro/frame_ingest_" + std::to_string(frame_counts[i]) + suffix, frames[i].size(), []()
+            {
+                const std::vector<uint8_t>& ingest_frame = frames[frame_index];
+                SignalDatabase& ingest_database = SignalDatabase::get_instance();
+
+                DataReader reader;
+                reader.set_buffer(ingest_frame.data(), ingest_frame.size());
+
+                size_t total = 0;
+                while (reader.bytes_available() > 0 && ingest_database.read_data_into_dictionary(reader))
+                {
+                    total += 1;
+                }
+                bench_sink += total;
+            });
+        }
+    }
+
+    SignalDatabase::get_instance().get_statistics().set_enabled(false);
+
+    // Run the largest frame with only the engine category accepted, as on an
+    // engine monitor that does not show the remaining signals
+    SignalFilter& filter = SignalDatabase::get_instance().get_filter();
+    filter.set_all_categories_accepted(false);
+    filter.set_category_accepted(SignalCategory::Engine, true);
+
+    runner.run("macro/frame_ingest_" + std::to_string(frame_counts[frames.size() - 1]) + "_filtered", frames.back().size(), []()
+    {
+        SignalDatabase& ingest_database = SignalDatabase::get_instance();
+
+        DataReader reader;
+        reader.set_buffer(frames.back().data(), frames.back().size());
+
+        size_t total = 0;
+        while (reader.bytes_available() > 0 && ingest_database.read_data_into_dictionary(reader))
+        {
+            total += 1;
+        }
+        bench_sink += total;
+    });
+
+    filter.accept_all();
+
+    // Repeat the largest frame with the V2 wire format, to measure the cost of the
+    // record length, with and without the filter skipping records by their length
+    SignalDatabase::get_instance().set_wire_format(WireFormat::V2);
+
+    static std::vector<uint8_t> frame_v2;
+    set_scaled_source_type(signals, SignalSourceType::Transmitted);
+    frame_v2.resize(65536);
+    frame_v2.resize(build_frame(signals, frame_counts[frames.size() - 1], WireFormat::V2, frame_v2));
+    set_scaled_source_type(signals, SignalSourceType::Received);
+
+    for (const bool filtered : { false, true })
+    {
+        if (filtered)
+        {
+            filter.set_all_categories_accepted(false);
+            filter.set_category_accepted(SignalCategory::Engine, true);
+        }
+
+        runner.run(
+                "macro/frame_ingest_" + std::to_string(frame_counts[frames.size() - 1]) + "_v2" + (filtered ? "_filtered" : ""),
+                frame_v2.size(),
+                []()
+        {
+            DataReader reader;
+            reader.set_buffer(frame_v2.data(), frame_v2.size());
+            bench_sink += SignalDatabase::get_instance().read_frame_into_dictionary(reader);
+        });
+    }
+
+    filter.accept_all();
+
+    // Encode the V2 frame with the compact frame encoding, and read it back
+    static std::vector<uint8_t> frame_compact;
+    frame_compact.resize(frame_v2.size());
+    {
+        DataReader reader;
+        reader.set_buffer(frame_v2.data(), frame_v2.size());
+        DataWriter writer;
+        writer.set_buffer(frame_compact.data(), frame_compact.size());
+        CompactFrame::encode(reader, writer);
+        frame_compact.resize(writer.bytes_written());
+    }
+
+    runner.run("codec/compact_encode_" + std::to_string(frame_counts[frames.size() - 1]), frame_v2.size(), []()
+    {
+        static uint8_t output[65536];
+        DataReader reader;
+        reader.set_buffer(frame_v2.data(), frame_v2.size());
+        DataWriter writer;
+        writer.set_buffer(output, sizeof(output));
+        bench_sink += CompactFrame::encode(reader, writer);
+    });
+
+    runner.run("macro/frame_ingest_" + std::to_string(frame_counts[frames.size() - 1]) + "_compact", frame_compact.size(), []()
+    {
+        DataReader reader;
+        reader.set_buffer(frame_compact.data(), frame_compact.size());
+        bench_sink += SignalDatabase::get_instance().read_compact_frame_into_dictionary(reader);
+    });
+
+    SignalDatabase::get_instance().set_wire_format(WireFormat::V1);
+
+    // Pack every signal into small frames grouped by category, as done on each tick
+    runner.run("database/frame_pack_x" + std::to_string(all_signals.size()), 0, []()
+    {
+        static FramePacker packer(64, 0, WireFormat::V1);
+        packer.reset();
+        for (const SignalTypeBase* signal : all_signals)
+        {
+            packer.add(signal->get_header().get_signal_def());
+        }
+        bench_sink += packer.pack();
+    });
+}
+
+static void print_usage(const char* name)
+{
+    printf("usage: %s [--json] [--filter=SUBSTRING] [--min-time=SECONDS] [--trace=FILE]\n", name);
+}
+
+int main(int argc, char** argv)
+{
+    bool json = false;
+    std::string filter;
+    double min_seconds = 0.5;
+    std::string trace_path;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--json")
+        {
+            json = true;
+        }
+        else if (arg.compare(0, 9, "--filter=") == 0)
+        {
+            filter = arg.substr(9);
+        }
+        else if (arg.compare(0, 11, "--min-time=") == 0)
+        {
+            min_seconds = atof(arg.substr(11).c_str());
+        }
+        else if (arg.compare(0, 8, "--trace=") == 0)
+        {
+            trace_path = arg.substr(8);
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Collect the signals within the database
+    SignalDatabase& database = SignalDatabase::get_instance();
+    std::vector<SignalDef> defs;
+    std::vector<SignalTypeScaled*> scaled_signals;
+
+    for (size_t i = 0; i < database.size(); ++i)
+    {
+        SignalTypeBase* signal = nullptr;
+        if (database.get_signal_for_index(i, &signal))
+        {
+            defs.push_back(signal->get_header().get_signal_def());
+
+            SignalTypeScaled* scaled = dynamic_cast<SignalTypeScaled*>(signal);
+            if (scaled != nullptr)
+            {
+                scaled_signals.push_back(scaled);
+            }
+        }
+    }
+
+    // Run the benchmarks
+    BenchRunner runner(min_seconds, filter);
+    add_codec_benchmarks(runner);
+    add_header_benchmarks(runner);
+    add_lookup_benchmarks(runner, defs);
+    add_crc_benchmarks(runner);
+    add_redundancy_benchmarks(runner);
+    add_database_benchmarks(runner, scaled_signals);
+
+    runner.print(json);
+
+    // Write the trace events recorded during the run, if built with TF_SIGNALS_ENABLE_TRACE
+    if (!trace_path.empty())
+    {
+        std::ofstream trace_file(trace_path);
+        if (!trace_file)
+        {
+            fprintf(stderr, "unable to open trace file %s\n", trace_path.c_str());
+            return 1;
+        }
+
+        write_chrome_trace(trace_file);
+    }
+
+    return 0;
+}
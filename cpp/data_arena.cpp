@@ -0,0 +1,63 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "data_arena.h"
+
+using namespace efis_signals;
+
+DataArena::DataArena(const size_t block_size) :
+    block_size(block_size),
+    block_used(0),
+    current_block(nullptr),
+    total_allocated(0)
+{
+    // Empty Constructor
+}
+
+uint8_t* DataArena::allocate(const size_t size)
+{
+    // Round the size up to maintain alignment for the next allocation
+    const size_t aligned_size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    total_allocated += aligned_size;
+
+    if (aligned_size > block_size)
+    {
+        // Provide a dedicated block for large allocations
+        blocks.emplace_back(new uint8_t[aligned_size]);
+        return blocks.back().get();
+    }
+    else
+    {
+        // Start a new shared block if the current block is full
+        if (current_block == nullptr || block_used + aligned_size > block_size)
+        {
+            blocks.emplace_back(new uint8_t[block_size]);
+            current_block = blocks.back().get();
+            block_used = 0;
+        }
+
+        uint8_t* ptr = current_block + block_used;
+        block_used += aligned_size;
+        return ptr;
+    }
+}
+
+size_t DataArena::bytes_allocated() const
+{
+    return total_allocated;
+}
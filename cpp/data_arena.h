@@ -0,0 +1,109 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_DATA_ARENA_H
+#define TF_SIGNAL_DATA_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace efis_signals
+{
+
+/**
+ * @brief The DataArena class provides a monotonic allocator for long-lived
+ * signal data buffers. Memory is taken from large blocks and is only released
+ * when the arena is destroyed, so that signals allocated at initialization
+ * never touch the heap allocator while running
+ */
+class DataArena
+{
+public:
+    /**
+     * @brief DataArena constructs an empty arena
+     * @param block_size is the size of each block to request from the heap
+     */
+    DataArena(const size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief allocate provides a buffer of the requested size from the arena,
+     * aligned to ALIGNMENT bytes. Requests larger than the block size are
+     * provided with a dedicated block
+     * @param size is the number of bytes to allocate
+     * @return a pointer to the allocated buffer
+     */
+    uint8_t* allocate(const size_t size);
+
+    /**
+     * @brief bytes_allocated provides the total number of bytes provided by the arena
+     * @return the number of bytes allocated
+     */
+    size_t bytes_allocated() const;
+
+    /**
+     * @brief DataArena objects may not be copied, as buffers refer to the arena memory
+     */
+    DataArena(const DataArena&) = delete;
+
+    /**
+     * @brief DataArena objects may not be copied, as buffers refer to the arena memory
+     */
+    DataArena& operator=(const DataArena&) = delete;
+
+    /**
+     * @brief DEFAULT_BLOCK_SIZE provides the default arena block size
+     */
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * @brief ALIGNMENT provides the alignment of each allocation
+     */
+    static const size_t ALIGNMENT = 16;
+
+protected:
+    /**
+     * @brief blocks provides the memory blocks owned by the arena
+     */
+    std::vector<std::unique_ptr<uint8_t[]>> blocks;
+
+    /**
+     * @brief block_size provides the size of each shared block
+     */
+    size_t block_size;
+
+    /**
+     * @brief block_used provides the number of bytes used in the current shared block
+     */
+    size_t block_used;
+
+    /**
+     * @brief current_block provides the current shared block to allocate from
+     */
+    uint8_t* current_block;
+
+    /**
+     * @brief total_allocated provides the total number of bytes allocated
+     */
+    size_t total_allocated;
+};
+
+}
+
+#endif // TF_SIGNAL_DATA_ARENA_H
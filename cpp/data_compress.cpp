@@ -0,0 +1,313 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "data_compress.h"
+
+#include "signal_trace.h"
+
+#include <cstring>
+
+namespace efis_signals
+{
+
+// Define the hash table parameters
+static const size_t LZ_HASH_BITS = 12;
+static const size_t LZ_HASH_SIZE = static_cast<size_t>(1) << LZ_HASH_BITS;
+static const uint32_t LZ_HASH_EMPTY = 0xFFFFFFFF;
+
+static uint32_t lz_read32(const uint8_t* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static size_t lz_hash(const uint32_t value)
+{
+    return static_cast<size_t>((value * 2654435761u) >> (32 - LZ_HASH_BITS));
+}
+
+static bool lz_write_length(
+        size_t length,
+        uint8_t* output,
+        const size_t output_capacity,
+        size_t& output_pos)
+{
+    // Write the extension bytes for a length that did not fit in the token nibble
+    while (length >= 255)
+    {
+        if (output_pos >= output_capacity)
+        {
+            return false;
+        }
+
+        output[output_pos++] = 255;
+        length -= 255;
+    }
+
+    if (output_pos >= output_capacity)
+    {
+        return false;
+    }
+
+    output[output_pos++] = static_cast<uint8_t>(length);
+    return true;
+}
+
+static bool lz_write_sequence(
+        const uint8_t* literals,
+        const size_t literal_length,
+        const size_t offset,
+        const size_t match_length,
+        uint8_t* output,
+        const size_t output_capacity,
+        size_t& output_pos)
+{
+    // Write the token, with a zero match nibble for the final literal-only sequence
+    const size_t match_code = match_length > 0 ? match_length - LZ_MIN_MATCH : 0;
+    const uint8_t literal_nibble = static_cast<uint8_t>(literal_length < 15 ? literal_length : 15);
+    const uint8_t match_nibble = static_cast<uint8_t>(match_code < 15 ? match_code : 15);
+
+    if (output_pos >= output_capacity)
+    {
+        return false;
+    }
+
+    output[output_pos++] = static_cast<uint8_t>((literal_nibble << 4) | match_nibble);
+
+    if (literal_nibble == 15 && !lz_write_length(literal_length - 15, output, output_capacity, output_pos))
+    {
+        return false;
+    }
+
+    // Write the literals
+    if (output_capacity - output_pos < literal_length)
+    {
+        return false;
+    }
+
+    memcpy(output + output_pos, literals, literal_length);
+    output_pos += literal_length;
+
+    // Write the match, if any
+    if (match_length > 0)
+    {
+        if (output_capacity - output_pos < 2)
+        {
+            return false;
+        }
+
+        output[output_pos++] = static_cast<uint8_t>(offset >> 8);
+        output[output_pos++] = static_cast<uint8_t>(offset);
+
+        if (match_nibble == 15 && !lz_write_length(match_code - 15, output, output_capacity, output_pos))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool lz_read_length(
+        const uint8_t* input,
+        const size_t input_size,
+        size_t& input_pos,
+        const size_t limit,
+        size_t& length)
+{
+    // Read extension bytes, stopping as soon as the length exceeds the limit
+    uint8_t value = 255;
+    while (value == 255)
+    {
+        if (input_pos >= input_size)
+        {
+            return false;
+        }
+
+        value = input[input_pos++];
+        length += value;
+
+        if (length > limit)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t lz_compress(
+        const uint8_t* input,
+        const size_t input_size,
+        uint8_t* output,
+        const size_t output_capacity)
+{
+    TF_TRACE_SCOPE(TraceStage::Compress, TRACE_NO_SIGNAL);
+
+    uint32_t hash_table[LZ_HASH_SIZE];
+    for (size_t i = 0; i < LZ_HASH_SIZE; ++i)
+    {
+        hash_table[i] = LZ_HASH_EMPTY;
+    }
+
+    size_t output_pos = 0;
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + LZ_MIN_MATCH <= input_size)
+    {
+        // Look up the last position with the same leading bytes
+        const uint32_t current = lz_read32(input + pos);
+        const size_t hash = lz_hash(current);
+        const uint32_t candidate = hash_table[hash];
+        hash_table[hash] = static_cast<uint32_t>(pos);
+
+        if (candidate != LZ_HASH_EMPTY &&
+                pos - candidate <= LZ_MAX_OFFSET &&
+                lz_read32(input + candidate) == current)
+        {
+            // Extend the match as far as possible
+            size_t match_length = LZ_MIN_MATCH;
+            while (pos + match_length < input_size &&
+                   input[candidate + match_length] == input[pos + match_length])
+            {
+                match_length += 1;
+            }
+
+            if (!lz_write_sequence(
+                        input + anchor,
+                        pos - anchor,
+                        pos - candidate,
+                        match_length,
+                        output,
+                        output_capacity,
+                        output_pos))
+            {
+                return 0;
+            }
+
+            pos += match_length;
+            anchor = pos;
+        }
+        else
+        {
+            // Step faster through data that isn't matching to limit the time spent
+            // on incompressible input
+            pos += 1 + ((pos - anchor) >> 6);
+        }
+    }
+
+    // Write the remaining literals
+    if (!lz_write_sequence(
+                input + anchor,
+                input_size - anchor,
+                0,
+                0,
+                output,
+                output_capacity,
+                output_pos))
+    {
+        return 0;
+    }
+
+    return output_pos;
+}
+
+bool lz_decompress(
+        const uint8_t* input,
+        const size_t input_size,
+        uint8_t* output,
+        const size_t output_size)
+{
+    TF_TRACE_SCOPE(TraceStage::Decompress, TRACE_NO_SIGNAL);
+
+    size_t input_pos = 0;
+    size_t output_pos = 0;
+
+    while (input_pos < input_size)
+    {
+        const uint8_t token = input[input_pos++];
+
+        // Read and copy the literals
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 &&
+                !lz_read_length(input, input_size, input_pos, output_size, literal_length))
+        {
+            return false;
+        }
+
+        if (literal_length > input_size - input_pos || literal_length > output_size - output_pos)
+        {
+            return false;
+        }
+
+        memcpy(output + output_pos, input + input_pos, literal_length);
+        input_pos += literal_length;
+        output_pos += literal_length;
+
+        // The final sequence ends with the input
+        if (input_pos == input_size)
+        {
+            break;
+        }
+
+        // Read the match offset and length
+        if (input_size - input_pos < 2)
+        {
+            return false;
+        }
+
+        const size_t offset = (static_cast<size_t>(input[input_pos]) << 8) | input[input_pos + 1];
+        input_pos += 2;
+
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 &&
+                !lz_read_length(input, input_size, input_pos, output_size, match_length))
+        {
+            return false;
+        }
+
+        match_length += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > output_pos || match_length > output_size - output_pos)
+        {
+            return false;
+        }
+
+        // Copy the match, a byte at a time if the match overlaps the output being written
+        const uint8_t* match = output + output_pos - offset;
+        if (offset >= match_length)
+        {
+            memcpy(output + output_pos, match, match_length);
+        }
+        else
+        {
+            for (size_t i = 0; i < match_length; ++i)
+            {
+                output[output_pos + i] = match[i];
+            }
+        }
+
+        output_pos += match_length;
+    }
+
+    return output_pos == output_size;
+}
+
+}
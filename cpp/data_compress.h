@@ -0,0 +1,85 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_DATA_COMPRESS_H
+#define TF_SIGNAL_DATA_COMPRESS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace efis_signals
+{
+
+/**
+ * @brief The DataCompression enum provides the compression modes available
+ * for data signal payloads
+ */
+enum class DataCompression
+{
+    None = 0,
+    Lz = 1
+};
+
+/**
+ * @brief lz_compress compresses the input using a byte-oriented LZ77 format.
+ * Each sequence consists of a token byte holding the literal length in the
+ * upper nibble and the match length less LZ_MIN_MATCH in the lower nibble,
+ * extended by additional bytes of 255 when the nibble is 15. The literals
+ * follow, and then a 16-bit big-endian match offset and any match length
+ * extension bytes. The last sequence contains only literals
+ * @param input is the data to compress
+ * @param input_size is the number of bytes to compress
+ * @param output is the buffer to write the compressed data into
+ * @param output_capacity is the size of the output buffer
+ * @return the compressed size, or 0 if the compressed data does not fit within the output
+ */
+size_t lz_compress(
+        const uint8_t* input,
+        const size_t input_size,
+        uint8_t* output,
+        const size_t output_capacity);
+
+/**
+ * @brief lz_decompress decompresses data written by lz_compress. The input is
+ * untrusted; every length and offset is checked so that no data is read
+ * beyond the input and no data is written beyond the output
+ * @param input is the compressed data
+ * @param input_size is the number of compressed bytes
+ * @param output is the buffer to write the decompressed data into
+ * @param output_size is the exact expected decompressed size
+ * @return true if the input was valid and decompressed to exactly output_size bytes
+ */
+bool lz_decompress(
+        const uint8_t* input,
+        const size_t input_size,
+        uint8_t* output,
+        const size_t output_size);
+
+/**
+ * @brief LZ_MIN_MATCH provides the shortest match encoded by the compressor
+ */
+const size_t LZ_MIN_MATCH = 4;
+
+/**
+ * @brief LZ_MAX_OFFSET provides the furthest match distance encoded by the compressor
+ */
+const size_t LZ_MAX_OFFSET = 65535;
+
+}
+
+#endif // TF_SIGNAL_DATA_COMPRESS_H
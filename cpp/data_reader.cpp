@@ -17,6 +17,10 @@
 
 #include "data_reader.h"
 
+#include "scaled_convert.h"
+
+#include <cstring>
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <winsock2.h>
 #else
@@ -99,6 +103,102 @@ bool DataReader::read_scaled(DataTypeScaled& val)
     }
 }
 
+bool DataReader::read_scaled_array(
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    if (bytes_available() / 4 >= count)
+    {
+        convert_raw_to_values(buffer + current, values, count, resolution);
+        current += 4 * count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool DataReader::read_bytes(
+        uint8_t* data,
+        const size_t count)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    else if (data != nullptr && bytes_available() >= count)
+    {
+        memcpy(data, buffer + current, count);
+        current += count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool DataReader::read_span(
+        const uint8_t*& data,
+        const size_t count)
+{
+    if (bytes_available() >= count)
+    {
+        data = buffer + current;
+        current += count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool DataReader::read_varint(uint32_t& val)
+{
+    uint32_t result = 0;
+    for (size_t i = 0; i < MAX_VARINT_SIZE; ++i)
+    {
+        if (current >= size)
+        {
+            return false;
+        }
+
+        const uint8_t byte = buffer[current];
+        current += 1;
+
+        // The final byte of a 32-bit value may only hold the top four bits
+        if (i + 1 == MAX_VARINT_SIZE && (byte & 0xF0) != 0)
+        {
+            return false;
+        }
+
+        result |= static_cast<uint32_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0)
+        {
+            val = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DataReader::skip(const size_t count)
+{
+    if (bytes_available() >= count)
+    {
+        current += count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 size_t DataReader::bytes_available() const
 {
     return size - current;
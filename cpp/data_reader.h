@@ -67,6 +67,56 @@ public:
      */
     bool read_scaled(DataTypeScaled& val);
 
+    /**
+     * @brief read_scaled_array reads an array of scaled values from the current
+     * buffer, converting directly into engineering values
+     * @param values stores the engineering values if read successfully
+     * @param count is the number of values to read
+     * @param resolution is the resolution of the scaled values
+     * @return true if all of the values are successfully read
+     */
+    bool read_scaled_array(
+            double* values,
+            const size_t count,
+            const double resolution);
+
+    /**
+     * @brief read_bytes reads a block of raw bytes from the current buffer in a single copy
+     * @param data stores the bytes if read successfully
+     * @param count is the number of bytes to read
+     * @return true if all of the bytes are successfully read
+     */
+    bool read_bytes(
+            uint8_t* data,
+            const size_t count);
+
+    /**
+     * @brief read_span provides direct access to a block of bytes within the
+     * current buffer without copying, advancing past the block
+     * @param data stores a pointer to the bytes if available
+     * @param count is the number of bytes to provide
+     * @return true if the bytes are available
+     */
+    bool read_span(
+            const uint8_t*& data,
+            const size_t count);
+
+    /**
+     * @brief read_varint reads an unsigned variable-length integer, stored as
+     * 7 bits per byte with the least significant group first, where the top bit
+     * of each byte is set if another byte follows
+     * @param val stores the integer value if read successfully
+     * @return true if a complete integer of no more than 32 bits is read
+     */
+    bool read_varint(uint32_t& val);
+
+    /**
+     * @brief skip advances the current buffer index without reading the data
+     * @param count is the number of bytes to skip
+     * @return true if the bytes were available to be skipped
+     */
+    bool skip(const size_t count);
+
     /**
      * @brief bytes_available determines the number of bytes available to read
      * @return the number of bytes available to read in the buffer
@@ -87,6 +137,11 @@ public:
      */
     void reset();
 
+    /**
+     * @brief MAX_VARINT_SIZE provides the largest encoded size of a 32-bit varint
+     */
+    static const size_t MAX_VARINT_SIZE = 5;
+
 private:
     /**
      * @brief buffer defines the buffer to read
@@ -18,61 +18,106 @@
 #ifndef TF_SIGNALS_DATA_SCALED_H
 #define TF_SIGNALS_DATA_SCALED_H
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 
 namespace efis_signals
 {
 
+/**
+ * @brief The ScaledResolution struct provides the resolution of a scaled
+ * value along with its reciprocal. A single instance is shared by every
+ * value of the same signal definition, so that the resolution is not
+ * stored within each value
+ */
+struct ScaledResolution
+{
+    /**
+     * @brief ScaledResolution constructs the resolution data
+     * @param resolution is the resolution to multiply raw values by
+     */
+    explicit constexpr ScaledResolution(const double resolution) :
+        resolution(resolution),
+        inverse_resolution(1.0 / resolution)
+    {
+        // Empty Constructor
+    }
+
+    /**
+     * @brief max_value provides the maximum possible value for the resolution
+     * @return the maximum value possible with the resolution
+     */
+    double max_value() const
+    {
+        return std::numeric_limits<int32_t>::max() * resolution;
+    }
+
+    /**
+     * @brief min_value provides the minimum possible value for the resolution
+     * @return the minimum value possible with the resolution
+     */
+    double min_value() const
+    {
+        return std::numeric_limits<int32_t>::min() * resolution;
+    }
+
+    /**
+     * @brief resolution stores the resolution of the scaled type
+     */
+    double resolution;
+
+    /**
+     * @brief inverse_resolution stores the reciprocal of the resolution, used to
+     * convert floating point values into raw values without a division
+     */
+    double inverse_resolution;
+};
+
 /**
  * @brief The DataTypeScaled class provides a scaled data type for
  * transmitting a floating point number of the network consistently
  * between devices with potentially different floating point
- * implementations within a four-byte datatype
+ * implementations within a four-byte datatype. The raw integer is
+ * the only stored value, so that reading and writing network data
+ * requires no floating point conversion. Conversions to and from
+ * engineering values take the shared resolution of the signal
  */
 class DataTypeScaled
 {
 public:
     /**
-     * @brief DataTypeScaled constructs the scaled type with the provided resolution
-     * @param resolution
+     * @brief DataTypeScaled constructs the scaled type with a zero value
      */
-    DataTypeScaled(const double resolution) :
-        resolution(resolution),
-        value(0.0)
+    DataTypeScaled() :
+        raw_value(0)
     {
         // Empty Constructor
     }
 
     /**
-     * @brief set_value sets the stored flaoting point value. If the value is
+     * @brief set_value sets the stored value from the provided floating point
+     * value, rounded to the nearest resolution step. If the value is
      * above or below the maximum allowed value, it will be saturated at
      * the respective limit
      * @param input the value to set
+     * @param scale is the resolution of the value
      */
-    void set_value(const double input)
+    void set_value(
+            const double input,
+            const ScaledResolution& scale)
     {
-        if (input > max_value())
-        {
-            value = max_value();
-        }
-        else if (input < min_value())
-        {
-            value = min_value();
-        }
-        else
-        {
-            value = input;
-        }
+        raw_value = saturate_raw(input * scale.inverse_resolution);
     }
 
     /**
      * @brief get_value provides the current value associated with the type
+     * @param scale is the resolution of the value
      * @return the floating point scaled value
      */
-    double get_value() const
+    double get_value(const ScaledResolution& scale) const
     {
-        return value;
+        return static_cast<double>(raw_value) * scale.resolution;
     }
 
     /**
@@ -81,7 +126,7 @@ public:
      */
     void set_raw_value(const uint32_t raw)
     {
-        value = static_cast<double>(static_cast<int32_t>(raw)) * resolution;
+        raw_value = static_cast<int32_t>(raw);
     }
 
     /**
@@ -90,43 +135,41 @@ public:
      */
     uint32_t get_raw_value() const
     {
-        return static_cast<uint32_t>(static_cast<int32_t>(value / resolution));
+        return static_cast<uint32_t>(raw_value);
     }
 
     /**
-     * @brief max_value provides the maximum possible value for the type
-     * @return the maximum value possible with the provided resolution
+     * @brief saturate_raw converts a value already divided by the resolution into
+     * the nearest raw value, saturating at the limits of the raw type. Values
+     * that are not a number are converted to zero
+     * @param scaled is the value in units of the resolution
+     * @return the associated raw value
      */
-    double max_value() const
+    static int32_t saturate_raw(const double scaled)
     {
-        return std::numeric_limits<int32_t>::max() * resolution;
-    }
-
-    /**
-     * @brief min_value provides the minimum possible value for the type
-     * @return the minimum value possible with the provided resolution
-     */
-    double min_value() const
-    {
-        return std::numeric_limits<int32_t>::min() * resolution;
+        if (scaled >= static_cast<double>(std::numeric_limits<int32_t>::max()))
+        {
+            return std::numeric_limits<int32_t>::max();
+        }
+        else if (scaled <= static_cast<double>(std::numeric_limits<int32_t>::min()))
+        {
+            return std::numeric_limits<int32_t>::min();
+        }
+        else if (scaled != scaled)
+        {
+            return 0;
+        }
+        else
+        {
+            return static_cast<int32_t>(std::nearbyint(scaled));
+        }
     }
 
-    /**
-     * @brief get_resolution provides the data resolution
-     * @return the resolution setting for the scaled type
-     */
-    double get_resolution() const;
-
 protected:
     /**
-     * @brief resolution stores the resolution of the scaled type
-     */
-    double resolution;
-
-    /**
-     * @brief value is the underlying data type value for the signal
+     * @brief raw_value is the underlying network value for the signal
      */
-    double value;
+    int32_t raw_value;
 };
 
 }
@@ -17,6 +17,11 @@
 
 #include "data_writer.h"
 
+#include "data_reader.h"
+#include "scaled_convert.h"
+
+#include <cstring>
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <winsock2.h>
 #else
@@ -73,11 +78,114 @@ bool DataWriter::add_scaled(const DataTypeScaled& val)
     return add_uint(val.get_raw_value());
 }
 
+bool DataWriter::add_scaled_array(
+        const double* values,
+        const size_t count,
+        const double resolution)
+{
+    if (buffer != nullptr && bytes_available() / 4 >= count)
+    {
+        convert_values_to_raw(values, buffer + current, count, resolution);
+        current += 4 * count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool DataWriter::add_bytes(
+        const uint8_t* data,
+        const size_t count)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+    else if (buffer != nullptr && data != nullptr && bytes_available() >= count)
+    {
+        memcpy(buffer + current, data, count);
+        current += count;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool DataWriter::add_varint(const uint32_t val)
+{
+    uint32_t remaining = val;
+    while (remaining >= 0x80)
+    {
+        if (!add_ubyte(static_cast<uint8_t>(remaining | 0x80)))
+        {
+            return false;
+        }
+        remaining >>= 7;
+    }
+    return add_ubyte(static_cast<uint8_t>(remaining));
+}
+
+bool DataWriter::set_varint(
+        const size_t position,
+        const uint32_t val,
+        const size_t width)
+{
+    if (buffer == nullptr ||
+            width > DataReader::MAX_VARINT_SIZE ||
+            width < varint_size(val) ||
+            position > current ||
+            current - position < width)
+    {
+        return false;
+    }
+
+    // Set the continuation bit on every byte but the last, so that the value
+    // fills the whole width
+    uint32_t remaining = val;
+    for (size_t i = 0; i + 1 < width; ++i)
+    {
+        buffer[position + i] = static_cast<uint8_t>((remaining & 0x7F) | 0x80);
+        remaining >>= 7;
+    }
+    buffer[position + width - 1] = static_cast<uint8_t>(remaining);
+
+    return true;
+}
+
+size_t DataWriter::varint_size(const uint32_t val)
+{
+    size_t count = 1;
+    uint32_t remaining = val;
+    while (remaining >= 0x80)
+    {
+        remaining >>= 7;
+        count += 1;
+    }
+    return count;
+}
+
 void DataWriter::reset()
 {
     current = 0;
 }
 
+bool DataWriter::truncate(const size_t position)
+{
+    if (position <= current)
+    {
+        current = position;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 size_t DataWriter::bytes_available() const
 {
     if (current < size)
@@ -92,13 +200,14 @@ size_t DataWriter::bytes_available() const
 
 size_t DataWriter::bytes_written() const
 {
-    if (current < size)
+    // A completely filled buffer has every byte written
+    if (current <= size)
     {
         return current;
     }
     else
     {
-        return 0;
+        return size;
     }
 }
 
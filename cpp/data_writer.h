@@ -66,11 +66,72 @@ public:
      */
     bool add_scaled(const DataTypeScaled& val);
 
+    /**
+     * @brief add_scaled_array adds an array of engineering values to the buffer
+     * as scaled data with the provided resolution
+     * @param values is the engineering value array to add
+     * @param count is the number of values to add
+     * @param resolution is the resolution of the scaled values
+     * @return true if all of the values were able to be successfully added
+     */
+    bool add_scaled_array(
+            const double* values,
+            const size_t count,
+            const double resolution);
+
+    /**
+     * @brief add_bytes adds a block of raw bytes to the buffer in a single copy
+     * @param data is the byte array to add
+     * @param count is the number of bytes to add
+     * @return true if all of the bytes were able to be successfully added
+     */
+    bool add_bytes(
+            const uint8_t* data,
+            const size_t count);
+
+    /**
+     * @brief add_varint adds an unsigned variable-length integer to the buffer,
+     * using one byte for values below 128 (see DataReader::read_varint)
+     * @param val is the integer to add
+     * @return true if the integer was able to be successfully added
+     */
+    bool add_varint(const uint32_t val);
+
+    /**
+     * @brief set_varint overwrites bytes already written with an unsigned
+     * variable-length integer padded to the provided width, such as to fill in a
+     * length reserved ahead of data of an unknown size. Padded values are read by
+     * DataReader::read_varint the same as the shortest encoding
+     * @param position is the index of the bytes to overwrite
+     * @param val is the integer to write
+     * @param width is the number of bytes to write, from varint_size(val) up to DataReader::MAX_VARINT_SIZE
+     * @return true if the integer was able to be written within the written data
+     */
+    bool set_varint(
+            const size_t position,
+            const uint32_t val,
+            const size_t width);
+
+    /**
+     * @brief varint_size determines the number of bytes used by add_varint
+     * @param val is the integer to check
+     * @return the encoded size in bytes
+     */
+    static size_t varint_size(const uint32_t val);
+
     /**
      * @brief reset resets the current buffer pointer index to the start of the buffer
      */
     void reset();
 
+    /**
+     * @brief truncate discards the bytes written after the provided position, such
+     * as to remove a partially written record
+     * @param position is the number of bytes to keep, no more than bytes_written()
+     * @return true if the position was within the written data
+     */
+    bool truncate(const size_t position);
+
     /**
      * @brief bytes_available determines the number of bytes available
      * @return the number of free bytes available that can be written to in the buffer
@@ -20,63 +20,95 @@
 #include "signal_database.h"
 #include "signal_type_base.h"
 #include "signal_type_scaled.h"
+#include "signal_type_data.h"
 #include "gen_signal_def.h"
+#include "gen_signal_types.h"
 
 using namespace efis_signals;
 
 void SignalDatabase::init_signals()
 {
+    static DataArena data_arena;
+
     static SignalTypeBase signal_null(SIGNAL_DEF_NULL);
     signal_array[SIGNAL_DEF_NULL.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_null);
 
-    static SignalTypeScaled signal_gps_latitude(SIGNAL_DEF_GPS_LATITUDE, 8.381903171539306640625000e-08);
+    static SignalTypeBase signal_sync_request(SIGNAL_DEF_SYNC_REQUEST);
+    rate_limiter.set_signal_limit(SIGNAL_DEF_SYNC_REQUEST.signal_index(), 5, 10);
+    signal_array[SIGNAL_DEF_SYNC_REQUEST.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_sync_request);
+
+    static SignalTypeBase signal_data_fragment(SIGNAL_DEF_DATA_FRAGMENT);
+    signal_array[SIGNAL_DEF_DATA_FRAGMENT.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_data_fragment);
+
+    static SignalTypeBase signal_data_delta(SIGNAL_DEF_DATA_DELTA);
+    signal_array[SIGNAL_DEF_DATA_DELTA.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_data_delta);
+
+    static SignalTypeBase signal_frame_info(SIGNAL_DEF_FRAME_INFO);
+    signal_array[SIGNAL_DEF_FRAME_INFO.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_frame_info);
+
+    static SignalTypeBase signal_subscription(SIGNAL_DEF_SUBSCRIPTION);
+    signal_array[SIGNAL_DEF_SUBSCRIPTION.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_subscription);
+
+    static SignalTypeGpsLatitude signal_gps_latitude(SIGNAL_DEF_GPS_LATITUDE);
     signal_array[SIGNAL_DEF_GPS_LATITUDE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_gps_latitude);
 
-    static SignalTypeScaled signal_gps_longitude(SIGNAL_DEF_GPS_LONGITUDE, 8.381903171539306640625000e-08);
+    static SignalTypeGpsLongitude signal_gps_longitude(SIGNAL_DEF_GPS_LONGITUDE);
     signal_array[SIGNAL_DEF_GPS_LONGITUDE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_gps_longitude);
 
-    static SignalTypeScaled signal_altitude_msl(SIGNAL_DEF_ALTITUDE_MSL, 1.000000000000000020816682e-02);
+    static SignalTypeAltitudeMsl signal_altitude_msl(SIGNAL_DEF_ALTITUDE_MSL);
     signal_array[SIGNAL_DEF_ALTITUDE_MSL.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_altitude_msl);
 
-    static SignalTypeScaled signal_altitude_agl(SIGNAL_DEF_ALTITUDE_AGL, 1.000000000000000020816682e-02);
+    static SignalTypeAltitudeAgl signal_altitude_agl(SIGNAL_DEF_ALTITUDE_AGL);
     signal_array[SIGNAL_DEF_ALTITUDE_AGL.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_altitude_agl);
 
-    static SignalTypeScaled signal_altitude_rate(SIGNAL_DEF_ALTITUDE_RATE, 1.000000000000000020816682e-02);
+    static SignalTypeAltitudeRate signal_altitude_rate(SIGNAL_DEF_ALTITUDE_RATE);
     signal_array[SIGNAL_DEF_ALTITUDE_RATE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_altitude_rate);
 
-    static SignalTypeScaled signal_vertical_speed(SIGNAL_DEF_VERTICAL_SPEED, 1.000000000000000020816682e-02);
+    static SignalTypeVerticalSpeed signal_vertical_speed(SIGNAL_DEF_VERTICAL_SPEED);
     signal_array[SIGNAL_DEF_VERTICAL_SPEED.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_vertical_speed);
 
-    static SignalTypeScaled signal_heading_true(SIGNAL_DEF_HEADING_TRUE, 8.381903171539306640625000e-08);
+    static SignalTypeHeadingTrue signal_heading_true(SIGNAL_DEF_HEADING_TRUE);
     signal_array[SIGNAL_DEF_HEADING_TRUE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_heading_true);
 
-    static SignalTypeScaled signal_heading_mag(SIGNAL_DEF_HEADING_MAG, 8.381903171539306640625000e-08);
+    static SignalTypeHeadingMag signal_heading_mag(SIGNAL_DEF_HEADING_MAG);
     signal_array[SIGNAL_DEF_HEADING_MAG.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_heading_mag);
 
-    static SignalTypeScaled signal_ground_track(SIGNAL_DEF_GROUND_TRACK, 8.381903171539306640625000e-08);
+    static SignalTypeGroundTrack signal_ground_track(SIGNAL_DEF_GROUND_TRACK);
     signal_array[SIGNAL_DEF_GROUND_TRACK.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_ground_track);
 
-    static SignalTypeScaled signal_magnetic_variation(SIGNAL_DEF_MAGNETIC_VARIATION, 8.381903171539306640625000e-08);
+    static SignalTypeMagneticVariation signal_magnetic_variation(SIGNAL_DEF_MAGNETIC_VARIATION);
+    signal_magnetic_variation.set_deadband(DeadbandMode::Absolute, 1.000000000000000055511151e-01);
     signal_array[SIGNAL_DEF_MAGNETIC_VARIATION.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_magnetic_variation);
 
-    static SignalTypeScaled signal_att_pitch(SIGNAL_DEF_ATT_PITCH, 8.381903171539306640625000e-08);
+    static SignalTypeAttPitch signal_att_pitch(SIGNAL_DEF_ATT_PITCH);
     signal_array[SIGNAL_DEF_ATT_PITCH.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_att_pitch);
 
-    static SignalTypeScaled signal_att_roll(SIGNAL_DEF_ATT_ROLL, 8.381903171539306640625000e-08);
+    static SignalTypeAttRoll signal_att_roll(SIGNAL_DEF_ATT_ROLL);
     signal_array[SIGNAL_DEF_ATT_ROLL.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_att_roll);
 
-    static SignalTypeScaled signal_speed_ias(SIGNAL_DEF_SPEED_IAS, 1.000000000000000020816682e-02);
+    static SignalTypeSpeedIas signal_speed_ias(SIGNAL_DEF_SPEED_IAS);
     signal_array[SIGNAL_DEF_SPEED_IAS.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_speed_ias);
 
-    static SignalTypeScaled signal_speed_gs(SIGNAL_DEF_SPEED_GS, 1.000000000000000020816682e-02);
+    static SignalTypeSpeedGs signal_speed_gs(SIGNAL_DEF_SPEED_GS);
     signal_array[SIGNAL_DEF_SPEED_GS.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_speed_gs);
 
-    static SignalTypeScaled signal_engine_rpm(SIGNAL_DEF_ENGINE_RPM, 1.000000000000000020816682e-02);
+    static SignalTypeEngineRpm signal_engine_rpm(SIGNAL_DEF_ENGINE_RPM);
+    signal_engine_rpm.set_deadband(DeadbandMode::Relative, 2.000000000000000041633363e-03);
     signal_array[SIGNAL_DEF_ENGINE_RPM.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_engine_rpm);
 
-    static SignalTypeScaled signal_oil_pressure(SIGNAL_DEF_OIL_PRESSURE, 1.000000000000000020816682e-02);
+    static SignalTypeOilPressure signal_oil_pressure(SIGNAL_DEF_OIL_PRESSURE);
+    signal_oil_pressure.set_deadband(DeadbandMode::Absolute, 5.000000000000000000000000e-01);
+    signal_oil_pressure.set_min_interval(100);
     signal_array[SIGNAL_DEF_OIL_PRESSURE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_oil_pressure);
 
-    static SignalTypeScaled signal_oil_temperature(SIGNAL_DEF_OIL_TEMPERATURE, 1.000000000000000020816682e-02);
+    static SignalTypeOilTemperature signal_oil_temperature(SIGNAL_DEF_OIL_TEMPERATURE);
+    signal_oil_temperature.set_deadband(DeadbandMode::Absolute, 5.000000000000000000000000e-01);
+    signal_oil_temperature.set_min_interval(250);
     signal_array[SIGNAL_DEF_OIL_TEMPERATURE.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_oil_temperature);
+
+    static SignalTypeData signal_flight_plan(SIGNAL_DEF_FLIGHT_PLAN, 4096, &data_arena);
+    signal_flight_plan.set_compression(DataCompression::Lz);
+    signal_array[SIGNAL_DEF_FLIGHT_PLAN.signal_index()] = dynamic_cast<SignalTypeBase*>(&signal_flight_plan);
+
+    rate_limiter.set_device_limit(40, 2000, 500);
 }
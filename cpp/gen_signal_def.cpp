@@ -21,9 +21,20 @@
 
 using namespace efis_signals;
 
-const uint32_t efis_signals::SIGNAL_LIST_VERSION_NUM = 1;
+const uint32_t efis_signals::SIGNAL_LIST_VERSION_NUM = 8;
+
+const uint32_t efis_signals::SIGNAL_LIST_FINGERPRINT = 0x90429965;
+
+const size_t efis_signals::SIGNAL_REVISION_COUNT = 0;
+
+const SignalRevisionDef* const efis_signals::SIGNAL_REVISION_LIST = nullptr;
 
 const SignalDef efis_signals::SIGNAL_DEF_NULL(0, 0, 0);
+const SignalDef efis_signals::SIGNAL_DEF_SYNC_REQUEST(0, 1, 0);
+const SignalDef efis_signals::SIGNAL_DEF_DATA_FRAGMENT(0, 2, 0);
+const SignalDef efis_signals::SIGNAL_DEF_DATA_DELTA(0, 3, 0);
+const SignalDef efis_signals::SIGNAL_DEF_FRAME_INFO(0, 4, 0);
+const SignalDef efis_signals::SIGNAL_DEF_SUBSCRIPTION(0, 5, 3000);
 const SignalDef efis_signals::SIGNAL_DEF_GPS_LATITUDE(10, 10, 1000);
 const SignalDef efis_signals::SIGNAL_DEF_GPS_LONGITUDE(10, 11, 1000);
 const SignalDef efis_signals::SIGNAL_DEF_ALTITUDE_MSL(10, 20, 1000);
@@ -41,6 +52,18 @@ const SignalDef efis_signals::SIGNAL_DEF_SPEED_GS(10, 51, 1000);
 const SignalDef efis_signals::SIGNAL_DEF_ENGINE_RPM(20, 10, 1000);
 const SignalDef efis_signals::SIGNAL_DEF_OIL_PRESSURE(20, 20, 1000);
 const SignalDef efis_signals::SIGNAL_DEF_OIL_TEMPERATURE(20, 21, 1000);
+const SignalDef efis_signals::SIGNAL_DEF_FLIGHT_PLAN(30, 10, 60000);
+
+const size_t efis_signals::SIGNAL_DEVICE_COUNT = 6;
+
+const SignalDeviceDef efis_signals::SIGNAL_DEVICE_LIST[] = {
+    { "any", 0 },
+    { "pfd_0", 10 },
+    { "mfd_0", 20 },
+    { "mfd_1", 21 },
+    { "pc_0", 30 },
+    { "daq_0", 40 },
+};
 
 bool efis_signals::get_signal_def_for_name(const std::string& name, SignalDef& signal_def)
 {
@@ -49,6 +72,31 @@ bool efis_signals::get_signal_def_for_name(const std::string& name, SignalDef& s
         signal_def = SIGNAL_DEF_NULL;
         return true;
     }
+    else if (name == "sync_request")
+    {
+        signal_def = SIGNAL_DEF_SYNC_REQUEST;
+        return true;
+    }
+    else if (name == "data_fragment")
+    {
+        signal_def = SIGNAL_DEF_DATA_FRAGMENT;
+        return true;
+    }
+    else if (name == "data_delta")
+    {
+        signal_def = SIGNAL_DEF_DATA_DELTA;
+        return true;
+    }
+    else if (name == "frame_info")
+    {
+        signal_def = SIGNAL_DEF_FRAME_INFO;
+        return true;
+    }
+    else if (name == "subscription")
+    {
+        signal_def = SIGNAL_DEF_SUBSCRIPTION;
+        return true;
+    }
     else if (name == "gps_latitude")
     {
         signal_def = SIGNAL_DEF_GPS_LATITUDE;
@@ -134,6 +182,11 @@ bool efis_signals::get_signal_def_for_name(const std::string& name, SignalDef& s
         signal_def = SIGNAL_DEF_OIL_TEMPERATURE;
         return true;
     }
+    else if (name == "flight_plan")
+    {
+        signal_def = SIGNAL_DEF_FLIGHT_PLAN;
+        return true;
+    }
     else
     {
         return false;
@@ -147,6 +200,31 @@ bool efis_signals::get_signal_name_for_def(const SignalDef& signal_def, std::str
         name = "null";
         return true;
     }
+    else if (signal_def == SIGNAL_DEF_SYNC_REQUEST)
+    {
+        name = "sync_request";
+        return true;
+    }
+    else if (signal_def == SIGNAL_DEF_DATA_FRAGMENT)
+    {
+        name = "data_fragment";
+        return true;
+    }
+    else if (signal_def == SIGNAL_DEF_DATA_DELTA)
+    {
+        name = "data_delta";
+        return true;
+    }
+    else if (signal_def == SIGNAL_DEF_FRAME_INFO)
+    {
+        name = "frame_info";
+        return true;
+    }
+    else if (signal_def == SIGNAL_DEF_SUBSCRIPTION)
+    {
+        name = "subscription";
+        return true;
+    }
     else if (signal_def == SIGNAL_DEF_GPS_LATITUDE)
     {
         name = "gps_latitude";
@@ -232,6 +310,11 @@ bool efis_signals::get_signal_name_for_def(const SignalDef& signal_def, std::str
         name = "oil_temperature";
         return true;
     }
+    else if (signal_def == SIGNAL_DEF_FLIGHT_PLAN)
+    {
+        name = "flight_plan";
+        return true;
+    }
     else
     {
         return false;
@@ -245,6 +328,31 @@ bool efis_signals::get_signal_for_cat_sub_id(const uint8_t cat_id, const uint8_t
         signal_def = SIGNAL_DEF_NULL;
         return true;
     }
+    else if (cat_id == 0 && sub_id == 1)
+    {
+        signal_def = SIGNAL_DEF_SYNC_REQUEST;
+        return true;
+    }
+    else if (cat_id == 0 && sub_id == 2)
+    {
+        signal_def = SIGNAL_DEF_DATA_FRAGMENT;
+        return true;
+    }
+    else if (cat_id == 0 && sub_id == 3)
+    {
+        signal_def = SIGNAL_DEF_DATA_DELTA;
+        return true;
+    }
+    else if (cat_id == 0 && sub_id == 4)
+    {
+        signal_def = SIGNAL_DEF_FRAME_INFO;
+        return true;
+    }
+    else if (cat_id == 0 && sub_id == 5)
+    {
+        signal_def = SIGNAL_DEF_SUBSCRIPTION;
+        return true;
+    }
     else if (cat_id == 10 && sub_id == 10)
     {
         signal_def = SIGNAL_DEF_GPS_LATITUDE;
@@ -330,6 +438,11 @@ bool efis_signals::get_signal_for_cat_sub_id(const uint8_t cat_id, const uint8_t
         signal_def = SIGNAL_DEF_OIL_TEMPERATURE;
         return true;
     }
+    else if (cat_id == 30 && sub_id == 10)
+    {
+        signal_def = SIGNAL_DEF_FLIGHT_PLAN;
+        return true;
+    }
     else
     {
         return false;
@@ -28,11 +28,53 @@ namespace efis_signals
 
 extern const uint32_t SIGNAL_LIST_VERSION_NUM;
 
+/**
+ * @brief SIGNAL_LIST_FINGERPRINT provides the hash of the parameters that define how each signal
+ * is sent, which is sent in the frame information so that receivers can check it
+ */
+extern const uint32_t SIGNAL_LIST_FINGERPRINT;
+
+/**
+ * @brief SIGNAL_REVISION_COUNT provides the number of older signal list revisions
+ */
+extern const size_t SIGNAL_REVISION_COUNT;
+
+/**
+ * @brief SIGNAL_REVISION_LIST provides the older signal list revisions that can be translated to
+ * the current signal list, in ascending version order, or nullptr if there are none
+ */
+extern const SignalRevisionDef* const SIGNAL_REVISION_LIST;
+
 /**
  * @brief SIGNAL_DEF_NULL is the signal for the empty signal for temporary use
  */
 extern const SignalDef SIGNAL_DEF_NULL;
 
+/**
+ * @brief SIGNAL_DEF_SYNC_REQUEST is the signal for the request for producers to send the current state of all transmitted signals
+ */
+extern const SignalDef SIGNAL_DEF_SYNC_REQUEST;
+
+/**
+ * @brief SIGNAL_DEF_DATA_FRAGMENT is the signal for the fragment of a data signal too large to send in a single frame
+ */
+extern const SignalDef SIGNAL_DEF_DATA_FRAGMENT;
+
+/**
+ * @brief SIGNAL_DEF_DATA_DELTA is the signal for the changed byte ranges of a data signal since the last keyframe
+ */
+extern const SignalDef SIGNAL_DEF_DATA_DELTA;
+
+/**
+ * @brief SIGNAL_DEF_FRAME_INFO is the signal for the per-device sequence number and signal list fingerprint written at the start of each frame
+ */
+extern const SignalDef SIGNAL_DEF_FRAME_INFO;
+
+/**
+ * @brief SIGNAL_DEF_SUBSCRIPTION is the signal for the set of signals that the sending device wants to receive
+ */
+extern const SignalDef SIGNAL_DEF_SUBSCRIPTION;
+
 /**
  * @brief SIGNAL_DEF_GPS_LATITUDE is the signal for the GPS latitude of the aircraft
  */
@@ -118,6 +160,45 @@ extern const SignalDef SIGNAL_DEF_OIL_PRESSURE;
  */
 extern const SignalDef SIGNAL_DEF_OIL_TEMPERATURE;
 
+/**
+ * @brief SIGNAL_DEF_FLIGHT_PLAN is the signal for the encoded active flight plan, sent as data fragments
+ */
+extern const SignalDef SIGNAL_DEF_FLIGHT_PLAN;
+
+/**
+ * @brief SIGNAL_DEVICE_COUNT provides the number of devices within the signal list
+ */
+extern const size_t SIGNAL_DEVICE_COUNT;
+
+/**
+ * @brief SIGNAL_DEVICE_LIST provides the devices within the signal list, in ascending device ID order
+ */
+extern const SignalDeviceDef SIGNAL_DEVICE_LIST[];
+
+/**
+ * @brief The SignalCategory enum provides the category IDs within the signal list
+ */
+enum class SignalCategory : uint8_t
+{
+    Status = 0,
+    Aircraft = 10,
+    Engine = 20,
+    Navigation = 30
+};
+
+/**
+ * @brief The SignalDevice enum provides the device IDs within the signal list
+ */
+enum class SignalDevice : uint8_t
+{
+    Any = 0,
+    Pfd0 = 10,
+    Mfd0 = 20,
+    Mfd1 = 21,
+    Pc0 = 30,
+    Daq0 = 40
+};
+
 /**
  * @brief get_signal_def_for_name provides the signal definition for the provided name
  * @param name is the name of the signal to find
@@ -0,0 +1,255 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// This file is auto-generated
+
+#include "signal_type_scaled_unit.h"
+
+#ifndef TF_GEN_SIGNAL_TYPES_H
+#define TF_GEN_SIGNAL_TYPES_H
+
+namespace efis_signals
+{
+
+/**
+ * @brief ResolutionSemi2deg provides the compile-time resolution 8.3819e-08
+ */
+struct ResolutionSemi2deg
+{
+    static constexpr double value() { return 8.381903171539306640625000e-08; }
+};
+
+/**
+ * @brief Resolution0p01 provides the compile-time resolution 0.01
+ */
+struct Resolution0p01
+{
+    static constexpr double value() { return 1.000000000000000020816682e-02; }
+};
+
+/**
+ * @brief UnitsDeg provides the units tag for deg
+ */
+struct UnitsDeg
+{
+    static constexpr const char* name() { return "deg"; }
+};
+
+/**
+ * @brief UnitsFt provides the units tag for ft
+ */
+struct UnitsFt
+{
+    static constexpr const char* name() { return "ft"; }
+};
+
+/**
+ * @brief UnitsFtPerS provides the units tag for ft/s
+ */
+struct UnitsFtPerS
+{
+    static constexpr const char* name() { return "ft/s"; }
+};
+
+/**
+ * @brief UnitsKts provides the units tag for kts
+ */
+struct UnitsKts
+{
+    static constexpr const char* name() { return "kts"; }
+};
+
+/**
+ * @brief UnitsRpm provides the units tag for rpm
+ */
+struct UnitsRpm
+{
+    static constexpr const char* name() { return "rpm"; }
+};
+
+/**
+ * @brief UnitsPsi provides the units tag for psi
+ */
+struct UnitsPsi
+{
+    static constexpr const char* name() { return "psi"; }
+};
+
+/**
+ * @brief UnitsDegC provides the units tag for degC
+ */
+struct UnitsDegC
+{
+    static constexpr const char* name() { return "degC"; }
+};
+
+/**
+ * @brief SignalTypeGpsLatitude is the concrete signal type for the GPS latitude of the aircraft
+ */
+class SignalTypeGpsLatitude : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeGpsLongitude is the concrete signal type for the GPS longitude of the aircraft
+ */
+class SignalTypeGpsLongitude : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeAltitudeMsl is the concrete signal type for the MSL altitude of the aircraft
+ */
+class SignalTypeAltitudeMsl : public SignalTypeScaledUnit<Resolution0p01, UnitsFt>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeAltitudeAgl is the concrete signal type for the AGL altitude of the aircraft
+ */
+class SignalTypeAltitudeAgl : public SignalTypeScaledUnit<Resolution0p01, UnitsFt>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeAltitudeRate is the concrete signal type for the altitude rate of the aircraft
+ */
+class SignalTypeAltitudeRate : public SignalTypeScaledUnit<Resolution0p01, UnitsFtPerS>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeVerticalSpeed is the concrete signal type for the vertical speed of the aircraft
+ */
+class SignalTypeVerticalSpeed : public SignalTypeScaledUnit<Resolution0p01, UnitsFtPerS>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeHeadingTrue is the concrete signal type for the true heading of the aircraft
+ */
+class SignalTypeHeadingTrue : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeHeadingMag is the concrete signal type for the magnetic heading of the aircraft
+ */
+class SignalTypeHeadingMag : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeGroundTrack is the concrete signal type for the ground track of the aircraft
+ */
+class SignalTypeGroundTrack : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeMagneticVariation is the concrete signal type for the current magnetic variation
+ */
+class SignalTypeMagneticVariation : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeAttPitch is the concrete signal type for the pitch attitude angle of the aircraft
+ */
+class SignalTypeAttPitch : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeAttRoll is the concrete signal type for the roll attitude angle of the aircraft
+ */
+class SignalTypeAttRoll : public SignalTypeScaledUnit<ResolutionSemi2deg, UnitsDeg>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeSpeedIas is the concrete signal type for the indicated airspeed of the aircraft
+ */
+class SignalTypeSpeedIas : public SignalTypeScaledUnit<Resolution0p01, UnitsKts>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeSpeedGs is the concrete signal type for the ground speed of the aircraft
+ */
+class SignalTypeSpeedGs : public SignalTypeScaledUnit<Resolution0p01, UnitsKts>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeEngineRpm is the concrete signal type for the RPM of the engine
+ */
+class SignalTypeEngineRpm : public SignalTypeScaledUnit<Resolution0p01, UnitsRpm>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeOilPressure is the concrete signal type for the oil pressure for the engine
+ */
+class SignalTypeOilPressure : public SignalTypeScaledUnit<Resolution0p01, UnitsPsi>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+/**
+ * @brief SignalTypeOilTemperature is the concrete signal type for the oil temperature for the engine
+ */
+class SignalTypeOilTemperature : public SignalTypeScaledUnit<Resolution0p01, UnitsDegC>
+{
+public:
+    using SignalTypeScaledUnit::SignalTypeScaledUnit;
+};
+
+}
+
+#endif // TF_GEN_SIGNAL_TYPES_H
@@ -0,0 +1,400 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "scaled_convert.h"
+
+#include "data_type_scaled.h"
+
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TF_SCALED_CONVERT_X86
+#include <immintrin.h>
+#endif
+
+namespace efis_signals
+{
+
+namespace
+{
+
+/**
+ * @brief ConvertFunctions provides the function pointers for a conversion kernel
+ */
+struct ConvertFunctions
+{
+    void (*raw_to_values)(const uint8_t*, double*, size_t, double);
+    void (*values_to_raw)(const double*, uint8_t*, size_t, double);
+};
+
+const double RAW_MIN = static_cast<double>(std::numeric_limits<int32_t>::min());
+const double RAW_MAX = static_cast<double>(std::numeric_limits<int32_t>::max());
+
+void scalar_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* bytes = raw + 4 * i;
+        const uint32_t host =
+                (static_cast<uint32_t>(bytes[0]) << 24) |
+                (static_cast<uint32_t>(bytes[1]) << 16) |
+                (static_cast<uint32_t>(bytes[2]) << 8) |
+                static_cast<uint32_t>(bytes[3]);
+        values[i] = static_cast<double>(static_cast<int32_t>(host)) * resolution;
+    }
+}
+
+void scalar_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution)
+{
+    const double inverse_resolution = 1.0 / resolution;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t host = static_cast<uint32_t>(DataTypeScaled::saturate_raw(values[i] * inverse_resolution));
+        uint8_t* bytes = raw + 4 * i;
+        bytes[0] = static_cast<uint8_t>(host >> 24);
+        bytes[1] = static_cast<uint8_t>(host >> 16);
+        bytes[2] = static_cast<uint8_t>(host >> 8);
+        bytes[3] = static_cast<uint8_t>(host);
+    }
+}
+
+#ifdef TF_SCALED_CONVERT_X86
+
+__attribute__((target("sse4.1")))
+void sse41_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128d scale = _mm_set1_pd(resolution);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i data = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + 4 * i)),
+                    swap);
+        _mm_storeu_pd(values + i, _mm_mul_pd(_mm_cvtepi32_pd(data), scale));
+        _mm_storeu_pd(values + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(data, 8)), scale));
+    }
+
+    scalar_raw_to_values(raw + 4 * i, values + i, count - i, resolution);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i sse41_to_raw_pair(
+        const __m128d input,
+        const __m128d inverse)
+{
+    // Zero any NaN values, and then saturate at the raw limits
+    __m128d scaled = _mm_mul_pd(input, inverse);
+    scaled = _mm_and_pd(scaled, _mm_cmpord_pd(scaled, scaled));
+    scaled = _mm_min_pd(_mm_max_pd(scaled, _mm_set1_pd(RAW_MIN)), _mm_set1_pd(RAW_MAX));
+    return _mm_cvtpd_epi32(scaled);
+}
+
+__attribute__((target("sse4.1")))
+void sse41_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution)
+{
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128d inverse = _mm_set1_pd(1.0 / resolution);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i low = sse41_to_raw_pair(_mm_loadu_pd(values + i), inverse);
+        const __m128i high = sse41_to_raw_pair(_mm_loadu_pd(values + i + 2), inverse);
+        _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(raw + 4 * i),
+                    _mm_shuffle_epi8(_mm_unpacklo_epi64(low, high), swap));
+    }
+
+    scalar_values_to_raw(values + i, raw + 4 * i, count - i, resolution);
+}
+
+__attribute__((target("avx2")))
+void avx2_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    const __m256i swap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256d scale = _mm256_set1_pd(resolution);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i data = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + 4 * i)),
+                    swap);
+        _mm256_storeu_pd(values + i, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(data)), scale));
+        _mm256_storeu_pd(values + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(data, 1)), scale));
+    }
+
+    scalar_raw_to_values(raw + 4 * i, values + i, count - i, resolution);
+}
+
+__attribute__((target("avx2")))
+inline __m128i avx2_to_raw_quad(
+        const __m256d input,
+        const __m256d inverse)
+{
+    // Zero any NaN values, and then saturate at the raw limits
+    __m256d scaled = _mm256_mul_pd(input, inverse);
+    scaled = _mm256_and_pd(scaled, _mm256_cmp_pd(scaled, scaled, _CMP_ORD_Q));
+    scaled = _mm256_min_pd(_mm256_max_pd(scaled, _mm256_set1_pd(RAW_MIN)), _mm256_set1_pd(RAW_MAX));
+    return _mm256_cvtpd_epi32(scaled);
+}
+
+__attribute__((target("avx2")))
+void avx2_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution)
+{
+    const __m256i swap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256d inverse = _mm256_set1_pd(1.0 / resolution);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i low = avx2_to_raw_quad(_mm256_loadu_pd(values + i), inverse);
+        const __m128i high = avx2_to_raw_quad(_mm256_loadu_pd(values + i + 4), inverse);
+        const __m256i data = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(raw + 4 * i),
+                    _mm256_shuffle_epi8(data, swap));
+    }
+
+    scalar_values_to_raw(values + i, raw + 4 * i, count - i, resolution);
+}
+
+// Older GCC AVX-512 intrinsic headers produce false maybe-uninitialized warnings
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f,avx2")))
+void avx512_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    const __m256i swap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m512d scale = _mm512_set1_pd(resolution);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i low = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + 4 * i)),
+                    swap);
+        const __m256i high = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + 4 * i + 32)),
+                    swap);
+        _mm512_storeu_pd(values + i, _mm512_mul_pd(_mm512_cvtepi32_pd(low), scale));
+        _mm512_storeu_pd(values + i + 8, _mm512_mul_pd(_mm512_cvtepi32_pd(high), scale));
+    }
+
+    avx2_raw_to_values(raw + 4 * i, values + i, count - i, resolution);
+}
+
+__attribute__((target("avx512f,avx2")))
+inline __m256i avx512_to_raw_octet(
+        const __m512d input,
+        const __m512d inverse)
+{
+    // Zero any NaN values, and then saturate at the raw limits
+    __m512d scaled = _mm512_mul_pd(input, inverse);
+    scaled = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(scaled, scaled, _CMP_ORD_Q), scaled);
+    scaled = _mm512_min_pd(_mm512_max_pd(scaled, _mm512_set1_pd(RAW_MIN)), _mm512_set1_pd(RAW_MAX));
+    return _mm512_cvtpd_epi32(scaled);
+}
+
+__attribute__((target("avx512f,avx2")))
+void avx512_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution)
+{
+    const __m256i swap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m512d inverse = _mm512_set1_pd(1.0 / resolution);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i low = avx512_to_raw_octet(_mm512_loadu_pd(values + i), inverse);
+        const __m256i high = avx512_to_raw_octet(_mm512_loadu_pd(values + i + 8), inverse);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(raw + 4 * i), _mm256_shuffle_epi8(low, swap));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(raw + 4 * i + 32), _mm256_shuffle_epi8(high, swap));
+    }
+
+    avx2_values_to_raw(values + i, raw + 4 * i, count - i, resolution);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // TF_SCALED_CONVERT_X86
+
+bool kernel_supported(const ScaledConvertKernel kernel)
+{
+    switch (kernel)
+    {
+    case ScaledConvertKernel::Scalar:
+        return true;
+#ifdef TF_SCALED_CONVERT_X86
+    case ScaledConvertKernel::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case ScaledConvertKernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case ScaledConvertKernel::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+ConvertFunctions functions_for_kernel(const ScaledConvertKernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef TF_SCALED_CONVERT_X86
+    case ScaledConvertKernel::SSE41:
+        return ConvertFunctions { sse41_raw_to_values, sse41_values_to_raw };
+    case ScaledConvertKernel::AVX2:
+        return ConvertFunctions { avx2_raw_to_values, avx2_values_to_raw };
+    case ScaledConvertKernel::AVX512:
+        return ConvertFunctions { avx512_raw_to_values, avx512_values_to_raw };
+#endif
+    default:
+        return ConvertFunctions { scalar_raw_to_values, scalar_values_to_raw };
+    }
+}
+
+ScaledConvertKernel best_kernel()
+{
+    const ScaledConvertKernel kernels[] = {
+        ScaledConvertKernel::AVX512,
+        ScaledConvertKernel::AVX2,
+        ScaledConvertKernel::SSE41
+    };
+
+    for (const ScaledConvertKernel kernel : kernels)
+    {
+        if (kernel_supported(kernel))
+        {
+            return kernel;
+        }
+    }
+
+    return ScaledConvertKernel::Scalar;
+}
+
+/**
+ * @brief The ConvertDispatch struct stores the active kernel selection
+ */
+struct ConvertDispatch
+{
+    ConvertDispatch() :
+        kernel(best_kernel()),
+        functions(functions_for_kernel(kernel))
+    {
+        // Empty Constructor
+    }
+
+    ScaledConvertKernel kernel;
+    ConvertFunctions functions;
+};
+
+ConvertDispatch& get_dispatch()
+{
+    static ConvertDispatch dispatch;
+    return dispatch;
+}
+
+}
+
+ScaledConvertKernel get_scaled_convert_kernel()
+{
+    return get_dispatch().kernel;
+}
+
+bool set_scaled_convert_kernel(const ScaledConvertKernel kernel)
+{
+    if (kernel_supported(kernel))
+    {
+        ConvertDispatch& dispatch = get_dispatch();
+        dispatch.kernel = kernel;
+        dispatch.functions = functions_for_kernel(kernel);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+void convert_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution)
+{
+    get_dispatch().functions.raw_to_values(raw, values, count, resolution);
+}
+
+void convert_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution)
+{
+    get_dispatch().functions.values_to_raw(values, raw, count, resolution);
+}
+
+}
@@ -0,0 +1,86 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_SCALED_CONVERT_H
+#define TF_SIGNAL_SCALED_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace efis_signals
+{
+
+/**
+ * @brief The ScaledConvertKernel enum provides the available implementations
+ * for batch conversion between network scaled values and engineering values
+ */
+enum class ScaledConvertKernel
+{
+    Scalar = 0,
+    SSE41 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+/**
+ * @brief get_scaled_convert_kernel provides the kernel currently used for batch
+ * conversions. By default, this is the fastest kernel supported by the processor
+ * @return the active conversion kernel
+ */
+ScaledConvertKernel get_scaled_convert_kernel();
+
+/**
+ * @brief set_scaled_convert_kernel selects the kernel to use for batch conversions
+ * @param kernel is the kernel to use
+ * @return true if the kernel is supported by the processor and was selected
+ */
+bool set_scaled_convert_kernel(const ScaledConvertKernel kernel);
+
+/**
+ * @brief convert_raw_to_values converts an array of big-endian, two's complement
+ * raw values, as written on the network, into engineering values
+ * @param raw is the network data to convert, containing 4 * count bytes
+ * @param values is the output engineering value array
+ * @param count is the number of values to convert
+ * @param resolution is the resolution of the scaled values
+ */
+void convert_raw_to_values(
+        const uint8_t* raw,
+        double* values,
+        const size_t count,
+        const double resolution);
+
+/**
+ * @brief convert_values_to_raw converts an array of engineering values into
+ * big-endian, two's complement raw values for the network. Values are rounded
+ * to the nearest resolution step and saturated at the limits of the raw type,
+ * matching DataTypeScaled::set_value
+ * @param values is the input engineering value array
+ * @param raw is the output network data, with space for 4 * count bytes
+ * @param count is the number of values to convert
+ * @param resolution is the resolution of the scaled values
+ */
+void convert_values_to_raw(
+        const double* values,
+        uint8_t* raw,
+        const size_t count,
+        const double resolution);
+
+}
+
+#endif // TF_SIGNAL_SCALED_CONVERT_H
@@ -0,0 +1,193 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_BITMAP_H
+#define TF_SIGNAL_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "signal_def.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The Bitmap class provides a fixed-size set of bits, stored in 64-bit words
+ * @tparam BIT_COUNT provides the number of bits within the bitmap
+ */
+template <size_t BIT_COUNT>
+class Bitmap
+{
+public:
+    /**
+     * @brief WORD_COUNT provides the number of 64-bit words used to store the bits
+     */
+    static const size_t WORD_COUNT = (BIT_COUNT + 63) / 64;
+
+    /**
+     * @brief Bitmap constructs a bitmap with all bits cleared
+     */
+    Bitmap()
+    {
+        clear_all();
+    }
+
+    /**
+     * @brief test determines if a bit is set
+     * @param index is the bit index, less than BIT_COUNT
+     * @return true if the bit is set
+     */
+    bool test(const size_t index) const
+    {
+        return (words[index / 64] >> (index % 64)) & 1u;
+    }
+
+    /**
+     * @brief set sets or clears a bit
+     * @param index is the bit index, less than BIT_COUNT
+     * @param value is true to set the bit, false to clear it
+     */
+    void set(
+            const size_t index,
+            const bool value)
+    {
+        const uint64_t mask = static_cast<uint64_t>(1) << (index % 64);
+        if (value)
+        {
+            words[index / 64] |= mask;
+        }
+        else
+        {
+            words[index / 64] &= ~mask;
+        }
+    }
+
+    /**
+     * @brief set_all sets every bit
+     */
+    void set_all()
+    {
+        for (size_t i = 0; i < WORD_COUNT; ++i)
+        {
+            words[i] = ~static_cast<uint64_t>(0);
+        }
+    }
+
+    /**
+     * @brief clear_all clears every bit
+     */
+    void clear_all()
+    {
+        for (size_t i = 0; i < WORD_COUNT; ++i)
+        {
+            words[i] = 0;
+        }
+    }
+
+    /**
+     * @brief merge sets every bit that is set within the other bitmap
+     * @param other is the bitmap to merge
+     */
+    void merge(const Bitmap& other)
+    {
+        for (size_t i = 0; i < WORD_COUNT; ++i)
+        {
+            words[i] |= other.words[i];
+        }
+    }
+
+    /**
+     * @brief count determines the number of bits set
+     * @return the number of set bits
+     */
+    size_t count() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < WORD_COUNT; ++i)
+        {
+            uint64_t word = words[i];
+            while (word != 0)
+            {
+                word &= word - 1;
+                total += 1;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief get_word provides a 64-bit word of the bitmap, where bit zero of
+     * word zero is the first bit of the bitmap
+     * @param index is the word index, less than WORD_COUNT
+     * @return the word value
+     */
+    uint64_t get_word(const size_t index) const
+    {
+        return words[index];
+    }
+
+    /**
+     * @brief set_word sets a 64-bit word of the bitmap
+     * @param index is the word index, less than WORD_COUNT
+     * @param value is the new word value
+     */
+    void set_word(
+            const size_t index,
+            const uint64_t value)
+    {
+        words[index] = value;
+    }
+
+    /**
+     * @brief operator == determines if two bitmaps have the same bits set
+     * @param other is the bitmap to compare against
+     * @return true if the bitmaps are equal
+     */
+    bool operator==(const Bitmap& other) const
+    {
+        for (size_t i = 0; i < WORD_COUNT; ++i)
+        {
+            if (words[i] != other.words[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+protected:
+    /**
+     * @brief words provides the bit storage
+     */
+    uint64_t words[WORD_COUNT];
+};
+
+/**
+ * @brief IdBitmap provides a bitmap over 8-bit category or device IDs
+ */
+using IdBitmap = Bitmap<256>;
+
+/**
+ * @brief SignalBitmap provides a bitmap over signal indexes
+ */
+using SignalBitmap = Bitmap<SignalDef::MAX_SIGNAL_COUNT>;
+
+}
+
+#endif // TF_SIGNAL_BITMAP_H
@@ -0,0 +1,176 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_candidate.h"
+
+#include <cstring>
+
+using namespace efis_signals;
+
+SignalCandidateSet::SignalCandidateSet()
+{
+    reset();
+}
+
+bool SignalCandidateSet::update(
+        const SignalHeader& header,
+        const uint8_t* payload,
+        const size_t size,
+        const timestamp_t now,
+        const uint32_t timeout_millis)
+{
+    if (size > SignalCandidate::PAYLOAD_SIZE)
+    {
+        return false;
+    }
+
+    SignalCandidate* slot = find_slot(header, now, timeout_millis);
+    if (slot == nullptr)
+    {
+        return false;
+    }
+
+    slot->receive_time = now;
+    slot->timestamp = header.timestamp;
+    slot->from_device = header.from_device;
+    slot->priority = header.priority;
+    slot->payload_size = static_cast<uint8_t>(size);
+    slot->in_use = true;
+    std::memcpy(slot->payload, payload, size);
+
+    return true;
+}
+
+const SignalCandidate* SignalCandidateSet::find_best(
+        const timestamp_t now,
+        const uint32_t timeout_millis) const
+{
+    const SignalCandidate* best = nullptr;
+
+    for (size_t i = 0; i < CANDIDATE_COUNT; ++i)
+    {
+        const SignalCandidate& candidate = candidates[i];
+        if (!is_live(candidate, now, timeout_millis) || (candidate.priority & 0x80) == 0)
+        {
+            continue;
+        }
+        else if (best == nullptr ||
+                 candidate.priority > best->priority ||
+                 (candidate.priority == best->priority &&
+                  static_cast<int32_t>(candidate.receive_time - best->receive_time) > 0))
+        {
+            best = &candidate;
+        }
+    }
+
+    return best;
+}
+
+size_t SignalCandidateSet::get_live_count(
+        const timestamp_t now,
+        const uint32_t timeout_millis) const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < CANDIDATE_COUNT; ++i)
+    {
+        if (is_live(candidates[i], now, timeout_millis))
+        {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+const SignalCandidate& SignalCandidateSet::get_candidate(const size_t index) const
+{
+    return candidates[index];
+}
+
+void SignalCandidateSet::reset()
+{
+    std::memset(candidates, 0, sizeof(candidates));
+}
+
+bool SignalCandidateSet::is_live(
+        const SignalCandidate& candidate,
+        const timestamp_t now,
+        const uint32_t timeout_millis)
+{
+    return candidate.in_use && now - candidate.receive_time <= timeout_millis;
+}
+
+SignalCandidate* SignalCandidateSet::find_slot(
+        const SignalHeader& header,
+        const timestamp_t now,
+        const uint32_t timeout_millis)
+{
+    SignalCandidate* empty = nullptr;
+    SignalCandidate* expired = nullptr;
+    SignalCandidate* lowest = nullptr;
+
+    for (size_t i = 0; i < CANDIDATE_COUNT; ++i)
+    {
+        SignalCandidate& candidate = candidates[i];
+
+        if (!candidate.in_use)
+        {
+            if (empty == nullptr)
+            {
+                empty = &candidate;
+            }
+        }
+        else if (candidate.from_device == header.from_device)
+        {
+            // Keep the existing value if the new value is older, such as a
+            // late arrival from a redundant network
+            const bool is_newer = static_cast<int32_t>(header.timestamp - candidate.timestamp) >= 0;
+            return is_newer ? &candidate : nullptr;
+        }
+        else if (!is_live(candidate, now, timeout_millis))
+        {
+            if (expired == nullptr || static_cast<int32_t>(candidate.receive_time - expired->receive_time) < 0)
+            {
+                expired = &candidate;
+            }
+        }
+        else if (lowest == nullptr ||
+                 candidate.priority < lowest->priority ||
+                 (candidate.priority == lowest->priority &&
+                  static_cast<int32_t>(candidate.receive_time - lowest->receive_time) < 0))
+        {
+            lowest = &candidate;
+        }
+    }
+
+    if (empty != nullptr)
+    {
+        return empty;
+    }
+    else if (expired != nullptr)
+    {
+        return expired;
+    }
+    else if (lowest != nullptr && header.priority >= lowest->priority)
+    {
+        return lowest;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
@@ -0,0 +1,182 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_CANDIDATE_H
+#define TF_SIGNAL_CANDIDATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "signal_header.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SignalCandidate struct provides the latest value received for
+ * a signal from a single source device
+ */
+struct SignalCandidate
+{
+    /**
+     * @brief PAYLOAD_SIZE provides the largest signal payload that may be held
+     */
+    static const size_t PAYLOAD_SIZE = 8;
+
+    /**
+     * @brief receive_time provides the local time that the value was received
+     */
+    timestamp_t receive_time;
+
+    /**
+     * @brief timestamp provides the sending timestamp of the value
+     */
+    uint32_t timestamp;
+
+    /**
+     * @brief from_device provides the device that sent the value
+     */
+    uint8_t from_device;
+
+    /**
+     * @brief priority provides the priority that the value was sent with
+     */
+    uint8_t priority;
+
+    /**
+     * @brief payload_size provides the number of payload bytes held
+     */
+    uint8_t payload_size;
+
+    /**
+     * @brief in_use is true if the candidate holds a received value
+     */
+    bool in_use;
+
+    /**
+     * @brief payload provides the serialized signal value, as received
+     */
+    uint8_t payload[PAYLOAD_SIZE];
+};
+
+/**
+ * @brief The SignalCandidateSet class keeps the latest value from each of a
+ * bounded number of source devices for a signal, so that a lower priority
+ * source that has been sending all along can take over as soon as the
+ * current source expires. The set uses fixed storage and never allocates
+ */
+class SignalCandidateSet
+{
+public:
+    /**
+     * @brief CANDIDATE_COUNT provides the number of source devices that may be held
+     */
+    static const size_t CANDIDATE_COUNT = 4;
+
+    /**
+     * @brief SignalCandidateSet constructs an empty candidate set
+     */
+    SignalCandidateSet();
+
+    /**
+     * @brief update stores a received value for the sending device. A value
+     * older than the one already held for the device is ignored. If the set is
+     * full, an expired candidate is replaced first, followed by the lowest
+     * priority candidate if the new value has at least the same priority
+     * @param header is the received signal header
+     * @param payload is the serialized signal value
+     * @param size is the number of payload bytes, no more than PAYLOAD_SIZE
+     * @param now is the local receive time
+     * @param timeout_millis is the signal timeout, used to find expired candidates
+     * @return true if the value was stored
+     */
+    bool update(
+            const SignalHeader& header,
+            const uint8_t* payload,
+            const size_t size,
+            const timestamp_t now,
+            const uint32_t timeout_millis);
+
+    /**
+     * @brief find_best finds the highest priority candidate that has not timed out
+     * and has a valid priority, preferring the most recently received on a tie
+     * @param now is the current time
+     * @param timeout_millis is the signal timeout
+     * @return the best live candidate, or nullptr if there are none
+     */
+    const SignalCandidate* find_best(
+            const timestamp_t now,
+            const uint32_t timeout_millis) const;
+
+    /**
+     * @brief get_live_count determines the number of candidates that have not timed out
+     * @param now is the current time
+     * @param timeout_millis is the signal timeout
+     * @return the number of live candidates
+     */
+    size_t get_live_count(
+            const timestamp_t now,
+            const uint32_t timeout_millis) const;
+
+    /**
+     * @brief get_candidate provides the candidate in the given slot
+     * @param index is the slot index, less than CANDIDATE_COUNT
+     * @return the candidate, which may not be in use
+     */
+    const SignalCandidate& get_candidate(const size_t index) const;
+
+    /**
+     * @brief reset removes all candidates
+     */
+    void reset();
+
+    /**
+     * @brief is_live determines if a candidate holds a value that has not timed out
+     * @param candidate is the candidate to check
+     * @param now is the current time
+     * @param timeout_millis is the signal timeout
+     * @return true if the candidate is live
+     */
+    static bool is_live(
+            const SignalCandidate& candidate,
+            const timestamp_t now,
+            const uint32_t timeout_millis);
+
+protected:
+    /**
+     * @brief find_slot finds the slot to store a value from the given device in
+     * @param header is the received signal header
+     * @param now is the local receive time
+     * @param timeout_millis is the signal timeout
+     * @return the slot to use, or nullptr if the value should not be stored
+     */
+    SignalCandidate* find_slot(
+            const SignalHeader& header,
+            const timestamp_t now,
+            const uint32_t timeout_millis);
+
+    /**
+     * @brief candidates provides the candidate storage
+     */
+    SignalCandidate candidates[CANDIDATE_COUNT];
+};
+
+}
+
+#endif // TF_SIGNAL_CANDIDATE_H
@@ -0,0 +1,205 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_compact.h"
+
+using namespace efis_signals;
+
+static uint32_t zigzag_encode(const uint32_t delta)
+{
+    const int32_t value = static_cast<int32_t>(delta);
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static uint32_t zigzag_decode(const uint32_t value)
+{
+    return (value >> 1) ^ (0u - (value & 1u));
+}
+
+CompactFrame::CompactFrame() :
+    payload_size(0),
+    started(false)
+{
+    // Empty Constructor
+}
+
+bool CompactFrame::start(DataReader& reader)
+{
+    current = SignalHeader();
+    payload_size = 0;
+    started =
+            reader.read_ubyte(current.from_device) &&
+            reader.read_ubyte(current.priority) &&
+            reader.read_uint(current.timestamp);
+    return started;
+}
+
+bool CompactFrame::read_record(
+        DataReader& reader,
+        SignalHeader& header,
+        DataReader& payload)
+{
+    uint8_t flags = 0;
+    if (!started || !reader.read_ubyte(flags) || (flags & ~FLAG_MASK) != 0)
+    {
+        return false;
+    }
+
+    uint32_t timestamp_delta = 0;
+    const bool success =
+            ((flags & FLAG_CATEGORY) == 0 || reader.read_ubyte(current.cat_id)) &&
+            ((flags & FLAG_DEVICE) == 0 || reader.read_ubyte(current.from_device)) &&
+            ((flags & FLAG_PRIORITY) == 0 || reader.read_ubyte(current.priority)) &&
+            ((flags & FLAG_TIMESTAMP) == 0 || reader.read_varint(timestamp_delta)) &&
+            ((flags & FLAG_LENGTH) == 0 || reader.read_varint(payload_size)) &&
+            reader.read_ubyte(current.sub_id);
+
+    const uint8_t* payload_data = nullptr;
+    if (!success || !reader.read_span(payload_data, payload_size))
+    {
+        return false;
+    }
+
+    current.timestamp += zigzag_decode(timestamp_delta);
+    header = current;
+    payload.set_buffer(payload_data, payload_size);
+    return true;
+}
+
+size_t CompactFrame::encode(
+        DataReader& frame,
+        DataWriter& writer)
+{
+    SignalHeader previous;
+    uint32_t previous_size = 0;
+    size_t record_count = 0;
+
+    while (frame.bytes_available() > 0)
+    {
+        DataReader record = frame;
+        SignalHeader header;
+        DataReader payload;
+        if (!header.read_header(record) || !SignalHeader::read_record_payload(record, payload))
+        {
+            break;
+        }
+
+        // The first record takes the frame header fields, and always sets the category
+        const bool first = record_count == 0;
+        if (first)
+        {
+            previous = header;
+        }
+
+        const uint32_t size = static_cast<uint32_t>(payload.bytes_available());
+        const uint32_t delta = zigzag_encode(header.timestamp - previous.timestamp);
+
+        uint8_t flags = 0;
+        size_t record_size = 2 + size + (first ? FRAME_HEADER_SIZE : 0);
+        if (first || header.cat_id != previous.cat_id)
+        {
+            flags |= FLAG_CATEGORY;
+            record_size += 1;
+        }
+        if (header.from_device != previous.from_device)
+        {
+            flags |= FLAG_DEVICE;
+            record_size += 1;
+        }
+        if (header.priority != previous.priority)
+        {
+            flags |= FLAG_PRIORITY;
+            record_size += 1;
+        }
+        if (delta != 0)
+        {
+            flags |= FLAG_TIMESTAMP;
+            record_size += DataWriter::varint_size(delta);
+        }
+        if (size != previous_size)
+        {
+            flags |= FLAG_LENGTH;
+            record_size += DataWriter::varint_size(size);
+        }
+
+        if (writer.bytes_available() < record_size)
+        {
+            break;
+        }
+
+        const uint8_t* payload_data = nullptr;
+        const bool success =
+                (!first || (
+                    writer.add_ubyte(header.from_device) &&
+                    writer.add_ubyte(header.priority) &&
+                    writer.add_uint(header.timestamp))) &&
+                writer.add_ubyte(flags) &&
+                ((flags & FLAG_CATEGORY) == 0 || writer.add_ubyte(header.cat_id)) &&
+                ((flags & FLAG_DEVICE) == 0 || writer.add_ubyte(header.from_device)) &&
+                ((flags & FLAG_PRIORITY) == 0 || writer.add_ubyte(header.priority)) &&
+                ((flags & FLAG_TIMESTAMP) == 0 || writer.add_varint(delta)) &&
+                ((flags & FLAG_LENGTH) == 0 || writer.add_varint(size)) &&
+                writer.add_ubyte(header.sub_id) &&
+                payload.read_span(payload_data, size) &&
+                writer.add_bytes(payload_data, size);
+
+        if (!success)
+        {
+            break;
+        }
+
+        previous = header;
+        previous_size = size;
+        frame = record;
+        record_count += 1;
+    }
+
+    return record_count;
+}
+
+bool CompactFrame::decode(
+        DataReader& reader,
+        DataWriter& frame)
+{
+    CompactFrame compact;
+    if (!compact.start(reader))
+    {
+        return false;
+    }
+
+    while (reader.bytes_available() > 0)
+    {
+        SignalHeader header;
+        DataReader payload;
+        const uint8_t* payload_data = nullptr;
+
+        const bool success =
+                compact.read_record(reader, header, payload) &&
+                payload.read_span(payload_data, compact.payload_size) &&
+                header.write_header(frame) &&
+                frame.add_varint(compact.payload_size) &&
+                frame.add_bytes(payload_data, compact.payload_size);
+
+        if (!success)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
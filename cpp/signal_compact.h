@@ -0,0 +1,146 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_COMPACT_H
+#define TF_SIGNAL_COMPACT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "signal_header.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The CompactFrame class provides the compact frame encoding, which removes
+ * the repeated header fields from a frame of V2 records. The frame starts with a
+ * single device, priority and base timestamp, and each record then carries a flag
+ * byte and the sub ID ahead of the payload. The flags mark the fields that change
+ * from the previous record, which follow the flag byte in flag bit order:
+ * category, device, priority, timestamp delta from the previous record as a zigzag
+ * varint, and payload length as a varint. Records from the same device and tick
+ * with the same payload size as the previous record only need the two bytes
+ */
+class CompactFrame
+{
+public:
+    /**
+     * @brief CompactFrame constructs a compact frame reader
+     */
+    CompactFrame();
+
+    /**
+     * @brief start reads the frame header at the start of a compact frame
+     * @param reader is the reader, positioned at the start of the frame
+     * @return true if the frame header was read
+     */
+    bool start(DataReader& reader);
+
+    /**
+     * @brief read_record reads the next record within the frame, once started
+     * @param reader is the reader, positioned at the start of the record
+     * @param header provides the full signal header of the record
+     * @param payload provides a reader limited to the record payload
+     * @return true if the record was read
+     */
+    bool read_record(
+            DataReader& reader,
+            SignalHeader& header,
+            DataReader& payload);
+
+    /**
+     * @brief encode writes a compact frame holding as many of the V2 records from a
+     * frame as fit within the writer. The frame reader is left at the first record
+     * not encoded, so that the remaining records can be sent in another frame
+     * @param frame is the reader containing V2 records
+     * @param writer is the writer to write the compact frame into
+     * @return the number of records encoded
+     */
+    static size_t encode(
+            DataReader& frame,
+            DataWriter& writer);
+
+    /**
+     * @brief decode expands a complete compact frame back into V2 records
+     * @param reader is the reader containing the compact frame
+     * @param frame is the writer to write the V2 records into
+     * @return true if every record was decoded
+     */
+    static bool decode(
+            DataReader& reader,
+            DataWriter& frame);
+
+    /**
+     * @brief FRAME_HEADER_SIZE provides the size of the frame header, consisting of
+     * the device, priority and base timestamp
+     */
+    static const size_t FRAME_HEADER_SIZE = 6;
+
+    /**
+     * @brief FLAG_CATEGORY marks a record that provides a new category ID
+     */
+    static const uint8_t FLAG_CATEGORY = 0x01;
+
+    /**
+     * @brief FLAG_DEVICE marks a record that provides a new device
+     */
+    static const uint8_t FLAG_DEVICE = 0x02;
+
+    /**
+     * @brief FLAG_PRIORITY marks a record that provides a new priority
+     */
+    static const uint8_t FLAG_PRIORITY = 0x04;
+
+    /**
+     * @brief FLAG_TIMESTAMP marks a record that provides a timestamp delta
+     */
+    static const uint8_t FLAG_TIMESTAMP = 0x08;
+
+    /**
+     * @brief FLAG_LENGTH marks a record that provides a new payload length
+     */
+    static const uint8_t FLAG_LENGTH = 0x10;
+
+    /**
+     * @brief FLAG_MASK provides the flags that are understood
+     */
+    static const uint8_t FLAG_MASK = 0x1F;
+
+protected:
+    /**
+     * @brief current provides the header fields of the previous record
+     */
+    SignalHeader current;
+
+    /**
+     * @brief payload_size provides the payload size of the previous record
+     */
+    uint32_t payload_size;
+
+    /**
+     * @brief started is true once the frame header has been read
+     */
+    bool started;
+};
+
+}
+
+#endif // TF_SIGNAL_COMPACT_H
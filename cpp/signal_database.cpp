@@ -18,17 +18,45 @@
 #include "signal_database.h"
 
 #include "gen_signal_def.h"
+#include "signal_trace.h"
+
+#include <limits>
 
 using namespace efis_signals;
 
-SignalDatabase::SignalDatabase()
+SignalDatabase::SignalDatabase() :
+    signal_index_count(0),
+    sync_request_count(0),
+    wire_format(WireFormat::V1),
+    schemas(SIGNAL_LIST_FINGERPRINT, SIGNAL_REVISION_LIST, SIGNAL_REVISION_COUNT)
 {
     for (size_t i = 0; i < size(); ++i)
     {
         signal_array[i] = nullptr;
     }
 
+    for (size_t i = 0; i < 256; ++i)
+    {
+        transmit_sequences[i] = 0;
+        source_formats[i] = 0;
+    }
+
+    subscriptions.set_timeout(SIGNAL_DEF_SUBSCRIPTION.timeout_millis);
+
     init_signals();
+
+    // Build the list of available signals
+    for (size_t i = 0; i < size(); ++i)
+    {
+        if (signal_array[i] != nullptr)
+        {
+            signal_index_list[signal_index_count] = static_cast<uint16_t>(i);
+            signal_index_count += 1;
+        }
+    }
+
+    statistics.init(signal_index_list, signal_index_count);
+    latency.init(signal_index_list, signal_index_count);
 }
 
 SignalDatabase& SignalDatabase::get_instance()
@@ -42,68 +70,849 @@ size_t SignalDatabase::size() const
     return SignalDef::MAX_SIGNAL_COUNT;
 }
 
+size_t SignalDatabase::get_signal_count() const
+{
+    return signal_index_count;
+}
+
+size_t SignalDatabase::get_signal_index(const size_t position) const
+{
+    if (position < signal_index_count)
+    {
+        return signal_index_list[position];
+    }
+    else
+    {
+        return SignalDef::MAX_SIGNAL_COUNT;
+    }
+}
+
 bool SignalDatabase::read_data_into_dictionary(DataReader& reader)
 {
+    const bool success = read_next_record(reader);
+
+    // Publish the statistics batched over the frame once the frame has been read
+    if (!success || reader.bytes_available() == 0)
+    {
+        statistics.flush();
+    }
+
+    return success;
+}
+
+bool SignalDatabase::read_next_record(DataReader& reader)
+{
+    TF_TRACE_SCOPE(TraceStage::Receive, TRACE_NO_SIGNAL);
+
     SignalHeader base_header;
-    if (base_header.read_header(reader))
+    WireFormat format = WireFormat::V1;
+    if (!TF_TRACE_CALL(TraceStage::HeaderDecode, TRACE_NO_SIGNAL, base_header.read_header(reader)) ||
+            !read_record_format(base_header, format))
+    {
+        statistics.record_header_error();
+        reader.skip(reader.bytes_available());
+        return false;
+    }
+    else if (format == WireFormat::V2)
     {
-        SignalTypeBase* signal_to_update = nullptr;
-        SignalDef signal_def = SIGNAL_DEF_NULL;
+        // The record length bounds the payload, so the reader is always left at the
+        // next record, whether or not this record can be processed
+        DataReader payload_reader;
+        if (!SignalHeader::read_record_payload(reader, payload_reader))
+        {
+            statistics.record_rejected(
+                    (static_cast<size_t>(base_header.cat_id) << 8) | base_header.sub_id,
+                    base_header.from_device,
+                    RejectReason::ShortBuffer);
+            reader.skip(reader.bytes_available());
+            return false;
+        }
+
+        return read_record_into_dictionary(base_header, payload_reader, true);
+    }
+    else if (read_record_into_dictionary(base_header, reader, false))
+    {
+        return true;
+    }
+    else
+    {
+        // V1 records do not carry their length, so the records following a record
+        // that could not be read cannot be found
+        reader.skip(reader.bytes_available());
+        return false;
+    }
+}
 
-        if (!base_header.get_signal_def_check(signal_def))
+bool SignalDatabase::read_record_format(
+        const SignalHeader& header,
+        WireFormat& format)
+{
+    if (header.cat_id == SIGNAL_DEF_FRAME_INFO.category_id &&
+            header.sub_id == SIGNAL_DEF_FRAME_INFO.sub_id)
+    {
+        if (!get_frame_info_format(header.priority, format))
         {
             return false;
         }
-        else if (!get_signal(signal_def, &signal_to_update))
+
+        source_formats[header.from_device] = static_cast<uint8_t>(format);
+        return true;
+    }
+    else if (source_formats[header.from_device] != 0)
+    {
+        format = static_cast<WireFormat>(source_formats[header.from_device]);
+        return true;
+    }
+    else
+    {
+        format = wire_format;
+        return true;
+    }
+}
+
+bool SignalDatabase::read_record_into_dictionary(
+        const SignalHeader& base_header,
+        DataReader& reader,
+        const bool length_prefixed)
+{
+    if (base_header.cat_id == static_cast<uint8_t>(SignalCategory::Status) ||
+            schemas.is_current(base_header.from_device))
+    {
+        return read_signal_into_dictionary(base_header, reader, 0.0, length_prefixed);
+    }
+    else
+    {
+        return read_translated_record(base_header, reader, length_prefixed);
+    }
+}
+
+bool SignalDatabase::read_translated_record(
+        const SignalHeader& base_header,
+        DataReader& reader,
+        const bool length_prefixed)
+{
+    const size_t header_index = (static_cast<size_t>(base_header.cat_id) << 8) | base_header.sub_id;
+
+    // Records that cannot be translated have a payload size that is only known
+    // from the record length, so can only be skipped with the V2 wire format
+    const SchemaTranslator* translator = schemas.get_translator(base_header.from_device);
+    const SignalTranslationDef* translation = translator != nullptr ? translator->find(header_index) : nullptr;
+
+    if (translator == nullptr || (translation != nullptr && translation->removed))
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::SchemaMismatch);
+        return length_prefixed;
+    }
+    else if (translation == nullptr)
+    {
+        return read_signal_into_dictionary(base_header, reader, 0.0, length_prefixed);
+    }
+
+    SignalHeader translated_header = base_header;
+    translated_header.cat_id = static_cast<uint8_t>(translation->to_index >> 8);
+    translated_header.sub_id = static_cast<uint8_t>(translation->to_index & 0xFF);
+    return read_signal_into_dictionary(translated_header, reader, translation->source_resolution, length_prefixed);
+}
+
+bool SignalDatabase::read_signal_into_dictionary(
+        const SignalHeader& base_header,
+        DataReader& reader,
+        const double source_resolution,
+        const bool length_prefixed)
+{
+    SignalTypeBase* signal_to_update = nullptr;
+    SignalDef signal_def = SIGNAL_DEF_NULL;
+
+    const size_t header_index = (static_cast<size_t>(base_header.cat_id) << 8) | base_header.sub_id;
+
+    if (!filter.is_accepted(base_header))
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::Filtered);
+        return skip_record_payload(header_index, reader, length_prefixed);
+    }
+    else if (!rate_limiter.is_allowed(base_header))
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::RateLimited);
+        return skip_record_payload(header_index, reader, length_prefixed);
+    }
+    else if (!TF_TRACE_CALL(TraceStage::Lookup, header_index, base_header.get_signal_def_check(signal_def)))
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::UnknownId);
+        return false;
+    }
+    else if (signal_def == SIGNAL_DEF_SYNC_REQUEST)
+    {
+        sync_request_count += 1;
+        statistics.record_accepted(header_index, base_header.from_device);
+        return true;
+    }
+    else if (signal_def == SIGNAL_DEF_FRAME_INFO)
+    {
+        if (read_frame_info_into_dictionary(base_header, reader))
         {
+            statistics.record_accepted(header_index, base_header.from_device);
+            return true;
+        }
+        else
+        {
+            statistics.record_rejected(header_index, base_header.from_device, RejectReason::ShortBuffer);
             return false;
         }
-        else if (reader.bytes_available() < signal_to_update->packet_size())
+    }
+    else if (signal_def == SIGNAL_DEF_SUBSCRIPTION)
+    {
+        if (subscriptions.read_subscription(base_header.from_device, reader, get_millis()))
+        {
+            statistics.record_accepted(header_index, base_header.from_device);
+            return true;
+        }
+        else
         {
+            statistics.record_rejected(header_index, base_header.from_device, RejectReason::DeserializeFailed);
             return false;
         }
-        else if (!signal_to_update->update_header(base_header))
+    }
+    else if (signal_def == SIGNAL_DEF_DATA_FRAGMENT)
+    {
+        if (read_fragment_into_dictionary(base_header, reader))
         {
+            statistics.record_accepted(header_index, base_header.from_device);
+            return true;
+        }
+        else
+        {
+            statistics.record_rejected(header_index, base_header.from_device, RejectReason::FragmentRejected);
             return false;
         }
-        else if (signal_to_update->deserialize(reader))
+    }
+    else if (signal_def == SIGNAL_DEF_DATA_DELTA)
+    {
+        if (read_delta_into_dictionary(base_header, reader))
         {
-            signal_to_update->set_updated_time_to_now();
+            statistics.record_accepted(header_index, base_header.from_device);
             return true;
         }
         else
         {
+            statistics.record_rejected(header_index, base_header.from_device, RejectReason::DeltaRejected);
             return false;
         }
     }
+    else if (!TF_TRACE_CALL(TraceStage::Lookup, header_index, get_signal(signal_def, &signal_to_update)))
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::UnknownId);
+        return false;
+    }
+    else if (reader.bytes_available() < signal_to_update->min_packet_size())
+    {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::ShortBuffer);
+        return false;
+    }
+    else if (!TF_TRACE_CALL(TraceStage::Arbitration, header_index, signal_to_update->update_header(base_header)))
+    {
+        // Keep the value from sources that lose arbitration as candidates, so that
+        // a standby source can take over immediately. A fixed size payload can be
+        // skipped to keep the reader positioned at the next record
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::PriorityLoss);
+        if (source_resolution == 0.0)
+        {
+            signal_to_update->update_candidate(base_header, reader, get_millis());
+        }
+        return skip_record_payload(header_index, reader, length_prefixed);
+    }
+
+    // Candidates hold the raw payload, so rescaled values are not kept as candidates
+    const DataReader payload_reader = reader;
+    const bool deserialized = source_resolution == 0.0 ?
+                TF_TRACE_CALL(TraceStage::Deserialize, header_index, signal_to_update->deserialize(reader)) :
+                TF_TRACE_CALL(TraceStage::Deserialize, header_index, signal_to_update->deserialize_rescaled(reader, source_resolution));
+
+    if (deserialized)
+    {
+        signal_to_update->set_updated_time_to_now();
+        const timestamp_t updated_time = signal_to_update->get_updated_time();
+        if (source_resolution == 0.0)
+        {
+            signal_to_update->update_candidate(base_header, payload_reader, updated_time);
+        }
+        statistics.record_accepted(header_index, base_header.from_device, updated_time);
+        latency.record_transit(header_index, base_header.from_device, base_header.timestamp, updated_time);
+        return true;
+    }
     else
     {
+        statistics.record_rejected(header_index, base_header.from_device, RejectReason::DeserializeFailed);
         return false;
     }
 }
 
+size_t SignalDatabase::read_frame_into_dictionary(DataReader& reader)
+{
+    // With the V2 wire format a rejected record is skipped over by its length, so
+    // the remaining records in the frame can still be read. With the V1 wire format
+    // the rest of the frame is skipped once a record cannot be read
+    size_t record_count = 0;
+    while (reader.bytes_available() > 0)
+    {
+        if (read_data_into_dictionary(reader))
+        {
+            record_count += 1;
+        }
+    }
+    return record_count;
+}
+
+size_t SignalDatabase::read_compact_frame_into_dictionary(DataReader& reader)
+{
+    TF_TRACE_SCOPE(TraceStage::Receive, TRACE_NO_SIGNAL);
+
+    CompactFrame compact;
+    if (!compact.start(reader))
+    {
+        statistics.record_header_error();
+        return 0;
+    }
+
+    size_t record_count = 0;
+    while (reader.bytes_available() > 0)
+    {
+        SignalHeader base_header;
+        DataReader payload_reader;
+        if (!TF_TRACE_CALL(TraceStage::HeaderDecode, TRACE_NO_SIGNAL, compact.read_record(reader, base_header, payload_reader)))
+        {
+            statistics.record_header_error();
+            reader.skip(reader.bytes_available());
+        }
+        else if (read_record_into_dictionary(base_header, payload_reader, true))
+        {
+            record_count += 1;
+        }
+    }
+
+    statistics.flush();
+    return record_count;
+}
+
+size_t SignalDatabase::promote_candidates()
+{
+    const timestamp_t now = get_millis();
+    size_t promoted_count = 0;
+
+    for (size_t i = 0; i < signal_index_count; ++i)
+    {
+        if (signal_array[signal_index_list[i]]->promote_candidate(now))
+        {
+            promoted_count += 1;
+        }
+    }
+
+    return promoted_count;
+}
+
+void SignalDatabase::set_wire_format(const WireFormat format)
+{
+    wire_format = format;
+}
+
+WireFormat SignalDatabase::get_wire_format() const
+{
+    return wire_format;
+}
+
 bool SignalDatabase::write_data_from_dictionary(
         const SignalDef& signal,
         DataWriter& writer) const
 {
+    TF_TRACE_SCOPE(TraceStage::Transmit, signal.signal_index());
+
     SignalTypeBase* base_signal = nullptr;
+    size_t payload_start = 0;
     if (!get_signal(signal, &base_signal))
     {
         return false;
     }
+
+    const size_t payload_size = base_signal->packet_size();
+    if (base_signal->get_header().write_record_start(writer, wire_format, payload_size, payload_start) &&
+            TF_TRACE_CALL(TraceStage::Serialize, signal.signal_index(), base_signal->serialize(writer)) &&
+            SignalHeader::write_record_end(writer, wire_format, payload_size, payload_start))
+    {
+        base_signal->set_transmitted(get_millis());
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+size_t SignalDatabase::write_due_from_dictionary(DataWriter& writer) const
+{
+    TF_TRACE_SCOPE(TraceStage::Transmit, TRACE_NO_SIGNAL);
+
+    const timestamp_t now = get_millis();
+    size_t written_count = 0;
+
+    const bool check_subscriptions = subscriptions.is_enabled();
+    if (check_subscriptions)
+    {
+        subscriptions.expire(now);
+    }
+
+    for (size_t i = 0; i < signal_index_count; ++i)
+    {
+        SignalTypeBase* signal = signal_array[signal_index_list[i]];
+        const size_t payload_size = signal->packet_size();
+        size_t payload_start = 0;
+
+        if (check_subscriptions && !subscriptions.is_subscribed(signal_index_list[i]))
+        {
+            continue;
+        }
+        else if (!signal->is_transmit_due(now))
+        {
+            continue;
+        }
+        else if (writer.bytes_available() < SignalHeader::record_overhead(wire_format, payload_size) + payload_size)
+        {
+            // Leave signals that don't fit, such as large data signals sent
+            // through fragments, without blocking the signals that follow
+            continue;
+        }
+        else if (signal->get_header().write_record_start(writer, wire_format, payload_size, payload_start) &&
+                 TF_TRACE_CALL(TraceStage::Serialize, signal_index_list[i], signal->serialize(writer)) &&
+                 SignalHeader::write_record_end(writer, wire_format, payload_size, payload_start))
+        {
+            signal->set_transmitted(now);
+            written_count += 1;
+        }
+    }
+
+    return written_count;
+}
+
+bool SignalDatabase::write_sync_request(
+        const uint8_t from_device,
+        DataWriter& writer) const
+{
+    SignalHeader request_header;
+    request_header.cat_id = SIGNAL_DEF_SYNC_REQUEST.category_id;
+    request_header.sub_id = SIGNAL_DEF_SYNC_REQUEST.sub_id;
+    request_header.priority = 0x80;
+    request_header.from_device = from_device;
+    request_header.timestamp = get_millis();
+
+    size_t payload_start = 0;
+    return
+            request_header.write_record_start(writer, wire_format, 0, payload_start) &&
+            SignalHeader::write_record_end(writer, wire_format, 0, payload_start);
+}
+
+bool SignalDatabase::write_subscription(
+        const uint8_t from_device,
+        const SignalBitmap& signals,
+        DataWriter& writer) const
+{
+    const size_t payload_size = SubscriptionTable::payload_size(signals);
+    if (writer.bytes_available() < SignalHeader::record_overhead(wire_format, payload_size) + payload_size)
+    {
+        return false;
+    }
+
+    SignalHeader subscription_header;
+    subscription_header.cat_id = SIGNAL_DEF_SUBSCRIPTION.category_id;
+    subscription_header.sub_id = SIGNAL_DEF_SUBSCRIPTION.sub_id;
+    subscription_header.priority = 0x80;
+    subscription_header.from_device = from_device;
+    subscription_header.timestamp = get_millis();
+
+    size_t payload_start = 0;
+    return
+            subscription_header.write_record_start(writer, wire_format, payload_size, payload_start) &&
+            SubscriptionTable::write_payload(signals, writer) &&
+            SignalHeader::write_record_end(writer, wire_format, payload_size, payload_start);
+}
+
+SubscriptionTable& SignalDatabase::get_subscriptions()
+{
+    return subscriptions;
+}
+
+const SubscriptionTable& SignalDatabase::get_subscriptions() const
+{
+    return subscriptions;
+}
+
+bool SignalDatabase::write_frame_info(
+        const uint8_t from_device,
+        DataWriter& writer)
+{
+    if (writer.bytes_available() < SignalHeader::record_overhead(wire_format, FRAME_INFO_SIZE) + FRAME_INFO_SIZE)
+    {
+        return false;
+    }
+
+    SignalHeader info_header;
+    info_header.cat_id = SIGNAL_DEF_FRAME_INFO.category_id;
+    info_header.sub_id = SIGNAL_DEF_FRAME_INFO.sub_id;
+    info_header.priority = get_frame_info_priority(wire_format);
+    info_header.from_device = from_device;
+    info_header.timestamp = get_millis();
+
+    const uint32_t sequence = transmit_sequences[from_device];
+    transmit_sequences[from_device] = sequence + 1;
+
+    size_t payload_start = 0;
+    return
+            info_header.write_record_start(writer, wire_format, FRAME_INFO_SIZE, payload_start) &&
+            writer.add_uint(sequence) &&
+            writer.add_uint(SIGNAL_LIST_FINGERPRINT) &&
+            SignalHeader::write_record_end(writer, wire_format, FRAME_INFO_SIZE, payload_start);
+}
+
+const SequenceTable& SignalDatabase::get_sequences() const
+{
+    return sequences;
+}
+
+uint32_t SignalDatabase::get_sync_request_count() const
+{
+    return sync_request_count;
+}
+
+const SignalReassembler& SignalDatabase::get_reassembler() const
+{
+    return reassembler;
+}
+
+SignalFilter& SignalDatabase::get_filter()
+{
+    return filter;
+}
+
+const SignalFilter& SignalDatabase::get_filter() const
+{
+    return filter;
+}
+
+RateLimiter& SignalDatabase::get_rate_limiter()
+{
+    return rate_limiter;
+}
+
+const RateLimiter& SignalDatabase::get_rate_limiter() const
+{
+    return rate_limiter;
+}
+
+SchemaTable& SignalDatabase::get_schemas()
+{
+    return schemas;
+}
+
+const SchemaTable& SignalDatabase::get_schemas() const
+{
+    return schemas;
+}
+
+SignalStatistics& SignalDatabase::get_statistics()
+{
+    return statistics;
+}
+
+const SignalStatistics& SignalDatabase::get_statistics() const
+{
+    return statistics;
+}
+
+SignalLatency& SignalDatabase::get_latency()
+{
+    return latency;
+}
+
+const SignalLatency& SignalDatabase::get_latency() const
+{
+    return latency;
+}
+
+void SignalDatabase::mark_consumed(const SignalDef& signal_def)
+{
+    SignalTypeBase* signal = nullptr;
+    if (latency.is_enabled() && get_signal(signal_def, &signal) && signal->is_valid())
+    {
+        latency.record_consumed(
+                    signal_def.signal_index(),
+                    signal->get_updated_time(),
+                    get_millis());
+    }
+}
+
+bool SignalDatabase::read_fragment_into_dictionary(
+        const SignalHeader& header,
+        DataReader& reader)
+{
+    FragmentHeader fragment;
+    if (!fragment.read_header(reader))
+    {
+        return false;
+    }
+
+    // Determine the target data signal, using the fragment header values for the signal ID
+    SignalHeader target_header = header;
+    target_header.cat_id = fragment.cat_id;
+    target_header.sub_id = fragment.sub_id;
+
+    SignalDef target_def = SIGNAL_DEF_NULL;
+    SignalTypeData* target_signal = nullptr;
+    size_t slot_index = 0;
+
+    const bool compressed = (fragment.flags & FragmentHeader::FLAG_COMPRESSED) != 0;
+
+    if (!target_header.get_signal_def_check(target_def) ||
+            !get_signal_type(target_def, &target_signal) ||
+            (compressed && fragment.total_size >= target_signal->data_size()) ||
+            (!compressed && fragment.total_size != target_signal->data_size()))
+    {
+        reader.skip(fragment.length);
+        return false;
+    }
+    else if (!reassembler.add_fragment(header, fragment, reader, get_millis(), slot_index))
+    {
+        reader.skip(fragment.length);
+        return false;
+    }
+    else if (!reassembler.is_complete(slot_index))
+    {
+        return true;
+    }
+    else if (target_signal->update_header(target_header) &&
+             reassembler.deliver(slot_index, *target_signal))
+    {
+        // Each completed transfer provides a keyframe for later deltas
+        target_signal->set_keyframe_version(fragment.message_id);
+        target_signal->set_updated_time_to_now();
+        latency.record_transit(
+                    target_def.signal_index(),
+                    header.from_device,
+                    header.timestamp,
+                    target_signal->get_updated_time());
+        return true;
+    }
+    else
+    {
+        reassembler.discard(slot_index);
+        return false;
+    }
+}
+
+bool SignalDatabase::skip_record_payload(
+        const size_t header_index,
+        DataReader& reader,
+        const bool length_prefixed) const
+{
+    // V2 records are already bounded by their length. V1 records do not carry their
+    // own length, so only records with a fixed size payload can be skipped without
+    // a lookup or decode
+    if (length_prefixed)
+    {
+        return true;
+    }
+
+    const SignalTypeBase* signal = signal_array[header_index];
+    return
+            signal != nullptr &&
+            signal->packet_size() == signal->min_packet_size() &&
+            reader.skip(signal->packet_size());
+}
+
+bool SignalDatabase::read_frame_info_into_dictionary(
+        const SignalHeader& header,
+        DataReader& reader)
+{
+    uint32_t sequence = 0;
+    if (!reader.read_uint(sequence))
+    {
+        return false;
+    }
+
+    // Devices built before the fingerprint was added to the frame information send
+    // only the sequence number, without marking the wire format. The V1 payload is
+    // followed directly by the next record, so the fingerprint can only be read if
+    // the format is marked, while the V2 record length shows whether it was sent
+    WireFormat format = WireFormat::V1;
+    if (!get_frame_info_format(header.priority, format))
+    {
+        return false;
+    }
+
+    const bool has_fingerprint = format == WireFormat::V2 ?
+                reader.bytes_available() > 0 :
+                header.priority != FRAME_INFO_LEGACY_PRIORITY;
+
+    uint32_t fingerprint = SIGNAL_LIST_FINGERPRINT;
+    if (has_fingerprint && !reader.read_uint(fingerprint))
+    {
+        return false;
+    }
+
+    sequences.update(header.from_device, sequence);
+    schemas.update(header.from_device, fingerprint);
+    return true;
+}
+
+bool SignalDatabase::read_delta_into_dictionary(
+        const SignalHeader& header,
+        DataReader& reader)
+{
+    DeltaHeader delta;
+    if (!delta.read_header(reader))
+    {
+        return false;
+    }
+
+    // Determine the target data signal, using the delta header values for the signal ID
+    SignalHeader target_header = header;
+    target_header.cat_id = delta.cat_id;
+    target_header.sub_id = delta.sub_id;
+
+    SignalDef target_def = SIGNAL_DEF_NULL;
+    SignalTypeData* target_signal = nullptr;
+
+    if (!target_header.get_signal_def_check(target_def) ||
+            !get_signal_type(target_def, &target_signal) ||
+            !target_signal->can_apply_delta(delta.version, delta.base_version) ||
+            !target_signal->update_header(target_header))
+    {
+        delta.skip_ranges(reader);
+        return false;
+    }
+    else if (target_signal->apply_delta(reader, delta.version, delta.base_version, delta.range_count))
+    {
+        target_signal->set_updated_time_to_now();
+        latency.record_transit(
+                    target_def.signal_index(),
+                    header.from_device,
+                    header.timestamp,
+                    target_signal->get_updated_time());
+        return true;
+    }
     else
     {
-        return
-                base_signal->get_header().write_header(writer) &&
-                base_signal->serialize(writer);
+        return false;
+    }
+}
+
+size_t SignalDatabase::checkpoint_size() const
+{
+    size_t total_size = CHECKPOINT_HEADER_SIZE;
+
+    for (size_t i = 0; i < signal_index_count; ++i)
+    {
+        total_size += CHECKPOINT_RECORD_SIZE + signal_array[signal_index_list[i]]->state_size();
+    }
+
+    return total_size;
+}
+
+bool SignalDatabase::write_checkpoint(DataWriter& writer) const
+{
+    // Write the checkpoint header
+    const uint64_t wall_time = get_epoch_millis();
+    bool success =
+            writer.add_uint(CHECKPOINT_MAGIC) &&
+            writer.add_ushort(CHECKPOINT_VERSION) &&
+            writer.add_uint(SIGNAL_LIST_VERSION_NUM) &&
+            writer.add_uint(static_cast<uint32_t>(wall_time >> 32)) &&
+            writer.add_uint(static_cast<uint32_t>(wall_time)) &&
+            writer.add_uint(static_cast<uint32_t>(signal_index_count));
+
+    // Write each signal state, prefixed by the signal index and the state size
+    const timestamp_t now = get_millis();
+    for (size_t i = 0; success && i < signal_index_count; ++i)
+    {
+        const uint16_t signal_index = signal_index_list[i];
+        const SignalTypeBase* signal = signal_array[signal_index];
+        success =
+                writer.add_ushort(signal_index) &&
+                writer.add_uint(static_cast<uint32_t>(signal->state_size())) &&
+                signal->save_state(writer, now);
+    }
+
+    return success;
+}
+
+bool SignalDatabase::read_checkpoint(DataReader& reader)
+{
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint32_t list_version = 0;
+    uint32_t wall_time_high = 0;
+    uint32_t wall_time_low = 0;
+    uint32_t record_count = 0;
+
+    const bool header_valid =
+            reader.read_uint(magic) &&
+            reader.read_ushort(version) &&
+            reader.read_uint(list_version) &&
+            reader.read_uint(wall_time_high) &&
+            reader.read_uint(wall_time_low) &&
+            reader.read_uint(record_count) &&
+            magic == CHECKPOINT_MAGIC &&
+            version == CHECKPOINT_VERSION &&
+            list_version == SIGNAL_LIST_VERSION_NUM;
+
+    if (!header_valid)
+    {
+        return false;
     }
+
+    // Determine the time that has passed since the checkpoint was written
+    const uint64_t saved_time = (static_cast<uint64_t>(wall_time_high) << 32) | wall_time_low;
+    const uint64_t current_time = get_epoch_millis();
+    const uint64_t elapsed_time = current_time > saved_time ? current_time - saved_time : 0;
+    const uint32_t elapsed = elapsed_time > std::numeric_limits<uint32_t>::max() ?
+                std::numeric_limits<uint32_t>::max() :
+                static_cast<uint32_t>(elapsed_time);
+
+    // Restore each record, skipping any records that cannot be applied
+    const timestamp_t now = get_millis();
+    for (uint32_t i = 0; i < record_count; ++i)
+    {
+        uint16_t signal_index = 0;
+        uint32_t state_size = 0;
+        if (!reader.read_ushort(signal_index) ||
+                !reader.read_uint(state_size) ||
+                reader.bytes_available() < state_size)
+        {
+            return false;
+        }
+
+        SignalTypeBase* signal = signal_array[signal_index];
+        if (signal != nullptr && signal->state_size() == state_size)
+        {
+            DataReader state_reader = reader;
+            signal->restore_state(state_reader, now, elapsed);
+        }
+
+        reader.skip(state_size);
+    }
+
+    return true;
 }
 
 bool SignalDatabase::get_signal(
         const SignalDef& signal_def,
         SignalTypeBase** signal) const
 {
-    const size_t signal_index = signal_def.signal_index();
+    return get_signal_for_index(
+                signal_def.signal_index(),
+                signal);
+}
+
+bool SignalDatabase::get_signal_for_index(
+        const size_t signal_index,
+        SignalTypeBase** signal) const
+{
     if (signal_index < size() && signal_array[signal_index] != nullptr)
     {
         *signal = signal_array[signal_index];
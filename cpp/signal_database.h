@@ -22,7 +22,18 @@
 
 #include "signal_type_base.h"
 #include "signal_type_scaled.h"
+#include "signal_type_data.h"
 #include "signal_def.h"
+#include "signal_fragment.h"
+#include "signal_delta.h"
+#include "signal_compact.h"
+#include "signal_filter.h"
+#include "signal_statistics.h"
+#include "signal_latency.h"
+#include "signal_rate_limit.h"
+#include "signal_schema.h"
+#include "signal_sequence.h"
+#include "signal_subscription.h"
 
 #include "crc16.h"
 
@@ -59,6 +70,17 @@ public:
             const SignalDef& signal_def,
             SignalTypeBase** signal) const;
 
+    /**
+     * @brief get_signal_for_index provides the signal stored at the provided
+     * signal index, if available
+     * @param signal_index is the signal index to search for
+     * @param signal stores the output location of the signal in memory if found
+     * @return true if the signal is found
+     */
+    bool get_signal_for_index(
+            const size_t signal_index,
+            SignalTypeBase** signal) const;
+
     /**
      * @brief get_scaled_signal provides the scaled signal definition, if available
      * @param signal_def is the signal definition to search for
@@ -106,15 +128,79 @@ public:
      */
     size_t size() const;
 
+    /**
+     * @brief get_signal_count provides the number of signals defined within the database
+     * @return the number of defined signals
+     */
+    size_t get_signal_count() const;
+
+    /**
+     * @brief get_signal_index provides the signal index at a position within the
+     * list of defined signals, allowing every defined signal to be visited without
+     * searching the full signal index range
+     * @param position is the position within the list, less than get_signal_count()
+     * @return the signal index, or SignalDef::MAX_SIGNAL_COUNT if the position is invalid
+     */
+    size_t get_signal_index(const size_t position) const;
+
     /**
      * @brief update_packet attempts to read the data contained in the reader
      * into the dictionary and update any stored values within
      * @param reader is the reader object containing the data to be read
      * into the dictionary
-     * @return true if a signal was successfully read into the dictionary
+     * @return true if a signal was successfully read into the dictionary, or if
+     * a record that lost arbitration, was filtered out or was rate limited was
+     * skipped. With the V1 wire format only fixed size records can be skipped, and
+     * the rest of the reader is skipped on failure as the next record cannot be
+     * found. With the V2 wire format the reader is left at the next record even on
+     * failure. The wire format of each record is taken from the frame information
+     * last received from the sending device (see get_frame_info_format). Batched
+     * statistics are published once the reader has been fully read
      */
     bool read_data_into_dictionary(DataReader& reader);
 
+    /**
+     * @brief read_frame_into_dictionary reads every record within a frame into the
+     * dictionary. With the V1 wire format this stops at the first record that
+     * cannot be read, while with the V2 wire format records that cannot be read
+     * are skipped. Frames from devices using either wire format may be read
+     * @param reader is the reader object containing the frame
+     * @return the number of records successfully read into the dictionary
+     */
+    size_t read_frame_into_dictionary(DataReader& reader);
+
+    /**
+     * @brief read_compact_frame_into_dictionary reads every record within a compact
+     * frame (see CompactFrame) into the dictionary. Each record is bounded by its
+     * length, so records that cannot be read are skipped
+     * @param reader is the reader object containing the compact frame
+     * @return the number of records successfully read into the dictionary
+     */
+    size_t read_compact_frame_into_dictionary(DataReader& reader);
+
+    /**
+     * @brief promote_candidates replaces the value of every receiving signal whose
+     * source has expired with the best live candidate from another source. This
+     * should be called once per processing tick, before signal values are used
+     * @return the number of signals that changed source
+     */
+    size_t promote_candidates();
+
+    /**
+     * @brief set_wire_format sets the record framing used to write records. The format
+     * is marked in the frame information record at the start of each frame, so that
+     * receivers can read frames from devices using either format. Records from devices
+     * that have not yet sent frame information are read with this format as well
+     * @param format is the wire format to use
+     */
+    void set_wire_format(const WireFormat format);
+
+    /**
+     * @brief get_wire_format provides the record framing used to write records
+     * @return the current wire format, V1 by default
+     */
+    WireFormat get_wire_format() const;
+
     /**
      * @brief write_data_from_dictionary attempts to write the requested signal
      * from the dictionary into the data writer, using the current FROM device
@@ -127,13 +213,341 @@ public:
             const SignalDef& signal,
             DataWriter& writer) const;
 
+    /**
+     * @brief write_due_from_dictionary writes every transmitted signal that is
+     * due for transmission (see SignalTypeBase::is_transmit_due) into the writer.
+     * Signals that do not fit in the remaining space are skipped, and the signals
+     * after them are still written if they fit. Signals that are not written
+     * remain due for the next call. If subscriptions are enabled, signals that no
+     * device has subscribed to are skipped
+     * @param writer is the object to write the data into
+     * @return the number of signals written into the data writer
+     */
+    size_t write_due_from_dictionary(DataWriter& writer) const;
+
+    /**
+     * @brief write_sync_request writes a state synchronization request into the
+     * writer. Producers receiving the request respond with the current state
+     * of every signal they transmit
+     * @param from_device is the device requesting the synchronization
+     * @param writer is the object to write the request into
+     * @return true if the request is successfully written into the data writer
+     */
+    bool write_sync_request(
+            const uint8_t from_device,
+            DataWriter& writer) const;
+
+    /**
+     * @brief write_frame_info writes the frame information record, holding the next
+     * sequence number for the sending device and marking the current wire format.
+     * The record should be written at the start of every frame, so that receivers
+     * can detect lost, reordered and duplicated frames and read the frame with the
+     * wire format of the sending device
+     * @param from_device is the device sending the frame
+     * @param writer is the object to write the record into
+     * @return true if the record is successfully written into the data writer
+     */
+    bool write_frame_info(
+            const uint8_t from_device,
+            DataWriter& writer);
+
+    /**
+     * @brief write_subscription writes a subscription record announcing the signals
+     * that the device wants to receive. Receivers should repeat the record within
+     * the subscription signal timeout to keep the subscription active
+     * @param from_device is the subscribing device
+     * @param signals is the set of signal indexes to subscribe to
+     * @param writer is the object to write the record into
+     * @return true if the record is successfully written into the data writer
+     */
+    bool write_subscription(
+            const uint8_t from_device,
+            const SignalBitmap& signals,
+            DataWriter& writer) const;
+
+    /**
+     * @brief get_subscriptions provides the subscriptions received from other devices.
+     * Transmission is only limited to subscribed signals once enabled through
+     * SubscriptionTable::set_enabled
+     * @return the subscription table
+     */
+    SubscriptionTable& get_subscriptions();
+
+    /**
+     * @brief get_subscriptions provides the subscriptions received from other devices
+     * @return the subscription table
+     */
+    const SubscriptionTable& get_subscriptions() const;
+
+    /**
+     * @brief get_sequences provides the sequence tracking for frames received from each device
+     * @return the received frame sequence table
+     */
+    const SequenceTable& get_sequences() const;
+
+    /**
+     * @brief get_sync_request_count provides the number of state synchronization
+     * requests received by the database
+     * @return the number of sync requests received
+     */
+    uint32_t get_sync_request_count() const;
+
+    /**
+     * @brief get_reassembler provides the reassembly table used for received data fragments
+     * @return the data fragment reassembler
+     */
+    const SignalReassembler& get_reassembler() const;
+
+    /**
+     * @brief get_filter provides the receive accept-list, applied to each record
+     * directly after the header is read. Every record is accepted by default
+     * @return the receive filter
+     */
+    SignalFilter& get_filter();
+
+    /**
+     * @brief get_filter provides the receive accept-list
+     * @return the receive filter
+     */
+    const SignalFilter& get_filter() const;
+
+    /**
+     * @brief get_rate_limiter provides the receive rate limits, applied to each record
+     * after the receive filter. The limits are configured from the signal list
+     * @return the receive rate limiter
+     */
+    RateLimiter& get_rate_limiter();
+
+    /**
+     * @brief get_rate_limiter provides the receive rate limits
+     * @return the receive rate limiter
+     */
+    const RateLimiter& get_rate_limiter() const;
+
+    /**
+     * @brief get_schemas provides the signal list revision used by each device, from
+     * the fingerprint sent in the frame information. Records from devices using a
+     * known older revision are translated, and records from devices using an
+     * unknown revision are rejected
+     * @return the schema table
+     */
+    SchemaTable& get_schemas();
+
+    /**
+     * @brief get_schemas provides the signal list revision used by each device
+     * @return the schema table
+     */
+    const SchemaTable& get_schemas() const;
+
+    /**
+     * @brief get_statistics provides the ingest statistics for received records.
+     * Statistics are disabled until enabled through SignalStatistics::set_enabled
+     * @return the ingest statistics
+     */
+    SignalStatistics& get_statistics();
+
+    /**
+     * @brief get_statistics provides the ingest statistics for received records
+     * @return the ingest statistics
+     */
+    const SignalStatistics& get_statistics() const;
+
+    /**
+     * @brief get_latency provides the latency histograms for received signals.
+     * Latency tracking is disabled until enabled through SignalLatency::set_enabled
+     * @return the signal latency histograms
+     */
+    SignalLatency& get_latency();
+
+    /**
+     * @brief get_latency provides the latency histograms for received signals
+     * @return the signal latency histograms
+     */
+    const SignalLatency& get_latency() const;
+
+    /**
+     * @brief mark_consumed records that a reader has consumed the current value of
+     * the signal, adding the time the value spent in the database to the dwell
+     * histogram. Each stored value is recorded at most once
+     * @param signal_def is the signal definition of the consumed signal
+     */
+    void mark_consumed(const SignalDef& signal_def);
+
+    /**
+     * @brief checkpoint_size provides the number of bytes required to store
+     * a checkpoint of the current database state
+     * @return the checkpoint size in bytes
+     */
+    size_t checkpoint_size() const;
+
+    /**
+     * @brief write_checkpoint writes the complete state of every signal in the
+     * database, including headers, values and signal ages, into the writer. The
+     * checkpoint is a flat binary image and may be written directly into a
+     * memory-mapped file of checkpoint_size() bytes
+     * @param writer is the data writer to write the checkpoint into
+     * @return true if the entire checkpoint was written
+     */
+    bool write_checkpoint(DataWriter& writer) const;
+
+    /**
+     * @brief read_checkpoint restores signal state from a checkpoint created by
+     * write_checkpoint. Signal ages are advanced by the wall-clock time elapsed
+     * since the checkpoint was written, so that stale values still time out.
+     * Individual signals that do not match the current database are skipped
+     * @param reader is the data reader containing the checkpoint
+     * @return true if the checkpoint was valid and read to completion
+     */
+    bool read_checkpoint(DataReader& reader);
+
+protected:
+    /**
+     * @brief CHECKPOINT_MAGIC provides the identifier written at the start of a checkpoint
+     */
+    static const uint32_t CHECKPOINT_MAGIC = 0x54464350;
+
+    /**
+     * @brief CHECKPOINT_VERSION provides the checkpoint layout version
+     */
+    static const uint16_t CHECKPOINT_VERSION = 1;
+
+    /**
+     * @brief CHECKPOINT_HEADER_SIZE provides the size of the checkpoint header, consisting
+     * of the magic, layout version, signal list version, wall-clock time and record count
+     */
+    static const size_t CHECKPOINT_HEADER_SIZE = 4 + 2 + 4 + 8 + 4;
+
+    /**
+     * @brief CHECKPOINT_RECORD_SIZE provides the size of the per-signal record prefix,
+     * consisting of the signal index and the state length
+     */
+    static const size_t CHECKPOINT_RECORD_SIZE = 2 + 4;
+
+    /**
+     * @brief FRAME_INFO_SIZE provides the size of the frame information payload,
+     * consisting of the sequence number and the signal list fingerprint
+     */
+    static const size_t FRAME_INFO_SIZE = 8;
+
 protected:
+    /**
+     * @brief read_next_record reads the next record from the reader into the
+     * dictionary (see read_data_into_dictionary)
+     * @param reader is the reader, positioned at the start of the record
+     * @return true if the record was read or skipped
+     */
+    bool read_next_record(DataReader& reader);
+
+    /**
+     * @brief read_record_format determines the wire format of a record from its
+     * header. Frame information records mark the wire format of the frame, which
+     * is kept for later records from the same device. Records from devices that
+     * have not sent frame information use the local wire format
+     * @param header is the record header
+     * @param format provides the wire format of the record
+     * @return true if the wire format is known
+     */
+    bool read_record_format(
+            const SignalHeader& header,
+            WireFormat& format);
+
+    /**
+     * @brief skip_record_payload skips the payload of a record that will not be
+     * processed, which is only possible for the V1 wire format if the payload has
+     * a fixed size
+     * @param header_index is the signal index from the record header
+     * @param reader is the reader, positioned at the start of the payload
+     * @param length_prefixed is true if the reader is limited to the record payload
+     * @return true if the payload was skipped
+     */
+    bool skip_record_payload(
+            const size_t header_index,
+            DataReader& reader,
+            const bool length_prefixed) const;
+
+    /**
+     * @brief read_record_into_dictionary processes a record once the header has
+     * been read, translating records from devices using an older signal list
+     * revision. Status records are never translated
+     * @param base_header is the record header
+     * @param reader is the reader, positioned at the start of the payload
+     * @param length_prefixed is true if the reader is limited to the record payload
+     * @return true if the record was read into the dictionary or skipped
+     */
+    bool read_record_into_dictionary(
+            const SignalHeader& base_header,
+            DataReader& reader,
+            const bool length_prefixed);
+
+    /**
+     * @brief read_translated_record processes a record from a device that does
+     * not use the current signal list, remapping and rescaling the signal using
+     * the translation table for the revision of the device
+     * @param base_header is the record header, as sent
+     * @param reader is the reader, positioned at the start of the payload
+     * @param length_prefixed is true if the reader is limited to the record payload
+     * @return true if the record was read into the dictionary or skipped
+     */
+    bool read_translated_record(
+            const SignalHeader& base_header,
+            DataReader& reader,
+            const bool length_prefixed);
+
+    /**
+     * @brief read_signal_into_dictionary updates the matching signal from the
+     * payload of a record
+     * @param base_header is the record header, using the current signal list
+     * @param reader is the reader, positioned at the start of the payload
+     * @param source_resolution is the resolution the payload was sent with if it
+     * differs from the current signal list, or zero otherwise
+     * @param length_prefixed is true if the reader is limited to the record payload
+     * @return true if the record was read into the dictionary or skipped
+     */
+    bool read_signal_into_dictionary(
+            const SignalHeader& base_header,
+            DataReader& reader,
+            const double source_resolution,
+            const bool length_prefixed);
+
     /**
      * @brief init_signals provides a function to initialize the signals within
      * the database
      */
     void init_signals();
 
+    /**
+     * @brief read_fragment_into_dictionary reads a data fragment record, delivering
+     * the data into the target data signal once all fragments have been received
+     * @param header is the signal header the fragment was received with
+     * @param reader is the reader positioned at the fragment header
+     * @return true if the fragment was accepted
+     */
+    bool read_fragment_into_dictionary(
+            const SignalHeader& header,
+            DataReader& reader);
+
+    /**
+     * @brief read_frame_info_into_dictionary reads a frame information record,
+     * updating the sequence tracking and signal list revision for the sending device
+     * @param header is the signal header the record was received with
+     * @param reader is the reader positioned at the record payload
+     * @return true if the record was read
+     */
+    bool read_frame_info_into_dictionary(
+            const SignalHeader& header,
+            DataReader& reader);
+
+    /**
+     * @brief read_delta_into_dictionary reads a data delta record, patching the
+     * target data signal in place if the delta applies to the current values
+     * @param header is the signal header the delta was received with
+     * @param reader is the reader positioned at the delta header
+     * @return true if the delta was applied
+     */
+    bool read_delta_into_dictionary(
+            const SignalHeader& header,
+            DataReader& reader);
+
 protected:
     /**
      * @brief signal_array provides the storage for locations to the signals
@@ -144,11 +558,84 @@ protected:
      */
     SignalTypeBase* signal_array[SignalDef::MAX_SIGNAL_COUNT];
 
+    /**
+     * @brief signal_index_list provides the indices of the signals available
+     * within signal_array, in ascending order, for iterating over the database
+     */
+    uint16_t signal_index_list[SignalDef::MAX_SIGNAL_COUNT];
+
+    /**
+     * @brief signal_index_count provides the number of indices in signal_index_list
+     */
+    size_t signal_index_count;
+
     /**
      * @brief crc provides an instance used to calculate the CRC of incoming and
      * outgoing signals
      */
     CRC16 crc;
+
+    /**
+     * @brief sync_request_count provides the number of sync requests received
+     */
+    uint32_t sync_request_count;
+
+    /**
+     * @brief wire_format provides the record framing used to write records
+     */
+    WireFormat wire_format;
+
+    /**
+     * @brief sequences provides the sequence tracking for frames received from each device
+     */
+    SequenceTable sequences;
+
+    /**
+     * @brief transmit_sequences provides the next frame sequence number for each sending device
+     */
+    uint32_t transmit_sequences[256];
+
+    /**
+     * @brief source_formats provides the wire format marked in the last frame
+     * information received from each device, or zero if none has been received
+     */
+    uint8_t source_formats[256];
+
+    /**
+     * @brief subscriptions provides the subscriptions received from other devices. The
+     * table is mutable so that expired subscriptions can be removed while transmitting
+     */
+    mutable SubscriptionTable subscriptions;
+
+    /**
+     * @brief reassembler provides the reassembly table for received data fragments
+     */
+    SignalReassembler reassembler;
+
+    /**
+     * @brief filter provides the receive accept-list
+     */
+    SignalFilter filter;
+
+    /**
+     * @brief rate_limiter provides the receive rate limits
+     */
+    RateLimiter rate_limiter;
+
+    /**
+     * @brief schemas provides the signal list revision used by each device
+     */
+    SchemaTable schemas;
+
+    /**
+     * @brief statistics provides the ingest statistics for received records
+     */
+    SignalStatistics statistics;
+
+    /**
+     * @brief latency provides the latency histograms for received signals
+     */
+    SignalLatency latency;
 };
 
 }
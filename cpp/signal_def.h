@@ -82,6 +82,80 @@ struct SignalDef
 
 };
 
+/**
+ * @brief The SignalDeviceDef struct provides the name and ID of a device
+ * within the signal list
+ */
+struct SignalDeviceDef
+{
+    /**
+     * @brief name provides the device name
+     */
+    const char* name;
+
+    /**
+     * @brief device_id provides the device ID used in the signal header
+     */
+    uint8_t device_id;
+};
+
+/**
+ * @brief The SignalTranslationDef struct provides the translation of a single
+ * signal from an older revision of the signal list to the current signal list
+ */
+struct SignalTranslationDef
+{
+    /**
+     * @brief from_index provides the signal index within the older revision
+     */
+    uint16_t from_index;
+
+    /**
+     * @brief to_index provides the signal index within the current signal list
+     */
+    uint16_t to_index;
+
+    /**
+     * @brief removed is true if the signal cannot be translated to the current
+     * signal list, in which case to_index is unused
+     */
+    bool removed;
+
+    /**
+     * @brief source_resolution provides the resolution of a scaled signal within
+     * the older revision, or zero if the resolution is unchanged
+     */
+    double source_resolution;
+};
+
+/**
+ * @brief The SignalRevisionDef struct provides an older revision of the signal
+ * list, along with the translations of the signals that differ from the current
+ * signal list
+ */
+struct SignalRevisionDef
+{
+    /**
+     * @brief version provides the signal list version of the revision
+     */
+    uint32_t version;
+
+    /**
+     * @brief fingerprint provides the signal list fingerprint of the revision
+     */
+    uint32_t fingerprint;
+
+    /**
+     * @brief translations provides the signal translations, in ascending from_index order
+     */
+    const SignalTranslationDef* translations;
+
+    /**
+     * @brief translation_count provides the number of signal translations
+     */
+    size_t translation_count;
+};
+
 }
 
 #endif // TF_SIGNAL_DEF_H
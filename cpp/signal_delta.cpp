@@ -0,0 +1,304 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_delta.h"
+
+#include "gen_signal_def.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace efis_signals;
+
+DeltaHeader::DeltaHeader() :
+    cat_id(0),
+    sub_id(0),
+    version(0),
+    base_version(0),
+    range_count(0)
+{
+    // Empty Constructor
+}
+
+bool DeltaHeader::write_header(DataWriter& writer) const
+{
+    return
+            writer.add_ubyte(cat_id) &&
+            writer.add_ubyte(sub_id) &&
+            writer.add_ushort(version) &&
+            writer.add_ushort(base_version) &&
+            writer.add_ushort(range_count);
+}
+
+bool DeltaHeader::read_header(DataReader& reader)
+{
+    return
+            reader.read_ubyte(cat_id) &&
+            reader.read_ubyte(sub_id) &&
+            reader.read_ushort(version) &&
+            reader.read_ushort(base_version) &&
+            reader.read_ushort(range_count);
+}
+
+bool DeltaHeader::skip_ranges(DataReader& reader) const
+{
+    for (uint16_t i = 0; i < range_count; ++i)
+    {
+        uint32_t offset = 0;
+        uint16_t length = 0;
+        if (!reader.read_uint(offset) ||
+                !reader.read_ushort(length) ||
+                !reader.skip(length))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SignalDeltaSender::SignalDeltaSender(
+        const SignalTypeData& signal,
+        const size_t mtu,
+        const uint32_t keyframe_millis,
+        const WireFormat format) :
+    signal(signal),
+    fragmenter(mtu, format),
+    mtu(mtu),
+    format(format),
+    keyframe_millis(keyframe_millis),
+    keyframe_data(new uint8_t[signal.data_size()]),
+    changed_map(new uint64_t[(signal.data_size() + 63) / 64]()),
+    keyframe_time(0),
+    keyframe_version(0),
+    sent_version(0),
+    has_keyframe(false),
+    keyframe_requested(false)
+{
+    // Empty Constructor
+}
+
+bool SignalDeltaSender::write_update(DataWriter& writer)
+{
+    const timestamp_t now = get_millis();
+
+    if (!fragmenter.is_active())
+    {
+        const bool keyframe_due =
+                !has_keyframe ||
+                keyframe_requested ||
+                now - keyframe_time >= keyframe_millis;
+
+        if (!keyframe_due)
+        {
+            // Send a delta if the values have changed and the changes fit within a frame
+            if (signal.get_data_version() == sent_version)
+            {
+                return false;
+            }
+
+            mark_changed();
+            if (write_delta(writer))
+            {
+                return true;
+            }
+            else if (writer.bytes_available() < mtu)
+            {
+                return false;
+            }
+        }
+
+        // Otherwise, start a new keyframe
+        if (!fragmenter.start(signal))
+        {
+            return false;
+        }
+
+        keyframe_requested = false;
+    }
+
+    if (!fragmenter.write_fragment(writer))
+    {
+        return false;
+    }
+
+    // Once complete, the keyframe holds the current values, as the fragmenter
+    // restarts the keyframe whenever the values change
+    if (!fragmenter.is_active())
+    {
+        memcpy(keyframe_data.get(), signal.get_data(), signal.data_size());
+        memset(changed_map.get(), 0, sizeof(uint64_t) * ((signal.data_size() + 63) / 64));
+        keyframe_version = fragmenter.get_message_id();
+        sent_version = keyframe_version;
+        keyframe_time = now;
+        has_keyframe = true;
+    }
+
+    return true;
+}
+
+bool SignalDeltaSender::is_keyframe_active() const
+{
+    return fragmenter.is_active();
+}
+
+void SignalDeltaSender::start_keyframe()
+{
+    keyframe_requested = true;
+}
+
+void SignalDeltaSender::mark_changed()
+{
+    const size_t size = signal.data_size();
+    const uint8_t* current = signal.get_data();
+    const uint8_t* keyframe = keyframe_data.get();
+
+    // Compare a word at a time, only checking individual bytes for words that differ
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t current_word;
+        uint64_t keyframe_word;
+        memcpy(&current_word, current + i, sizeof(uint64_t));
+        memcpy(&keyframe_word, keyframe + i, sizeof(uint64_t));
+
+        if (current_word != keyframe_word)
+        {
+            for (size_t j = i; j < i + sizeof(uint64_t); ++j)
+            {
+                if (current[j] != keyframe[j])
+                {
+                    changed_map[j / 64] |= static_cast<uint64_t>(1) << (j % 64);
+                }
+            }
+        }
+    }
+
+    for (; i < size; ++i)
+    {
+        if (current[i] != keyframe[i])
+        {
+            changed_map[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+        }
+    }
+}
+
+bool SignalDeltaSender::next_range(
+        size_t& start,
+        size_t& length) const
+{
+    const size_t size = signal.data_size();
+    const size_t max_length = std::numeric_limits<uint16_t>::max();
+
+    // Find the first changed byte, skipping unchanged words of the change map
+    size_t offset = start;
+    while (offset < size && !is_changed(offset))
+    {
+        offset = (offset % 64 == 0 && changed_map[offset / 64] == 0) ? offset + 64 : offset + 1;
+    }
+
+    if (offset >= size)
+    {
+        return false;
+    }
+
+    // Extend the range, merging changes separated by small gaps
+    size_t end = offset + 1;
+    for (size_t probe = end; probe < size && probe - end <= MERGE_GAP && probe - offset < max_length; ++probe)
+    {
+        if (is_changed(probe))
+        {
+            end = probe + 1;
+        }
+    }
+
+    start = offset;
+    length = end - offset;
+    return true;
+}
+
+bool SignalDeltaSender::is_changed(const size_t offset) const
+{
+    return (changed_map[offset / 64] & (static_cast<uint64_t>(1) << (offset % 64))) != 0;
+}
+
+bool SignalDeltaSender::write_delta(DataWriter& writer)
+{
+    // Determine the size of the delta record
+    size_t payload_size = DeltaHeader::HEADER_SIZE;
+    size_t range_count = 0;
+
+    size_t start = 0;
+    size_t length = 0;
+    while (next_range(start, length))
+    {
+        payload_size += SignalTypeData::DELTA_RANGE_SIZE + length;
+        range_count += 1;
+        start += length;
+    }
+
+    const size_t record_size = SignalHeader::record_overhead(format, payload_size) + payload_size;
+
+    if (record_size > mtu ||
+            record_size > writer.bytes_available() ||
+            range_count > std::numeric_limits<uint16_t>::max())
+    {
+        return false;
+    }
+
+    // Write the delta record
+    const SignalHeader& data_header = signal.get_header();
+
+    SignalHeader delta_header;
+    delta_header.cat_id = SIGNAL_DEF_DATA_DELTA.category_id;
+    delta_header.sub_id = SIGNAL_DEF_DATA_DELTA.sub_id;
+    delta_header.priority = data_header.priority;
+    delta_header.from_device = data_header.from_device;
+    delta_header.timestamp = data_header.timestamp;
+
+    DeltaHeader delta;
+    delta.cat_id = data_header.cat_id;
+    delta.sub_id = data_header.sub_id;
+    delta.version = signal.get_data_version();
+    delta.base_version = keyframe_version;
+    delta.range_count = static_cast<uint16_t>(range_count);
+
+    size_t payload_start = 0;
+    bool success =
+            delta_header.write_record_start(writer, format, payload_size, payload_start) &&
+            delta.write_header(writer);
+
+    start = 0;
+    while (success && next_range(start, length))
+    {
+        success =
+                writer.add_uint(static_cast<uint32_t>(start)) &&
+                writer.add_ushort(static_cast<uint16_t>(length)) &&
+                writer.add_bytes(signal.get_data() + start, length);
+        start += length;
+    }
+
+    success = success && SignalHeader::write_record_end(writer, format, payload_size, payload_start);
+
+    if (success)
+    {
+        sent_version = delta.version;
+    }
+
+    return success;
+}
@@ -0,0 +1,244 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_DELTA_H
+#define TF_SIGNAL_DELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "signal_fragment.h"
+#include "signal_time.h"
+#include "signal_type_data.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The DeltaHeader struct provides the prefix for a delta update of a
+ * data signal, sent as the payload of the data_delta status signal. The
+ * header is followed by range_count ranges, each consisting of a 32-bit
+ * offset, a 16-bit length and the replacement bytes
+ */
+struct DeltaHeader
+{
+    /**
+     * @brief cat_id provides the category ID of the data signal being updated
+     */
+    uint8_t cat_id;
+
+    /**
+     * @brief sub_id provides the sub ID of the data signal being updated
+     */
+    uint8_t sub_id;
+
+    /**
+     * @brief version provides the data version after the delta is applied
+     */
+    uint16_t version;
+
+    /**
+     * @brief base_version provides the keyframe version the delta is based on
+     */
+    uint16_t base_version;
+
+    /**
+     * @brief range_count provides the number of ranges following the header
+     */
+    uint16_t range_count;
+
+    /**
+     * @brief HEADER_SIZE provides the size of the delta header when written
+     */
+    static const size_t HEADER_SIZE = 1 + 1 + 2 + 2 + 2;
+
+    /**
+     * @brief DeltaHeader constructs an empty delta header
+     */
+    DeltaHeader();
+
+    /**
+     * @brief write_header writes the delta header to the writer
+     * @param writer is the writer to write to
+     * @return true if the header was able to be written
+     */
+    bool write_header(DataWriter& writer) const;
+
+    /**
+     * @brief read_header reads the delta header from the reader
+     * @param reader is the reader to read from
+     * @return true if the header was able to be read
+     */
+    bool read_header(DataReader& reader);
+
+    /**
+     * @brief skip_ranges advances the reader past the ranges of the delta
+     * @param reader is the reader positioned at the first range
+     * @return true if all ranges were able to be skipped
+     */
+    bool skip_ranges(DataReader& reader) const;
+};
+
+/**
+ * @brief The SignalDeltaSender class provides the producer side of delta updates
+ * for a large data signal. Full keyframes are sent periodically as data fragments.
+ * Between keyframes, changes are sent as data_delta records containing every byte
+ * range that has changed since the keyframe, so that any single delta received
+ * after the keyframe restores the current values, even if earlier deltas are lost.
+ * A new keyframe is started once the accumulated changes no longer fit in a frame
+ */
+class SignalDeltaSender
+{
+public:
+    /**
+     * @brief SignalDeltaSender constructs a delta sender for the provided signal
+     * @param signal is the transmitted data signal to send, which must remain available
+     * @param mtu is the maximum number of bytes to write into a single frame
+     * @param keyframe_millis is the interval between full keyframes
+     * @param format is the wire format to write records with
+     */
+    SignalDeltaSender(
+            const SignalTypeData& signal,
+            const size_t mtu,
+            const uint32_t keyframe_millis,
+            const WireFormat format);
+
+    /**
+     * @brief write_update writes the next record required to update receivers,
+     * which is either the next keyframe fragment or a delta of the current changes
+     * @param writer is the writer to place the record into
+     * @return true if a record was written
+     */
+    bool write_update(DataWriter& writer);
+
+    /**
+     * @brief is_keyframe_active determines if a keyframe is being sent
+     * @return true if keyframe fragments remain to be sent
+     */
+    bool is_keyframe_active() const;
+
+    /**
+     * @brief start_keyframe starts sending a new keyframe on the next update
+     */
+    void start_keyframe();
+
+    /**
+     * @brief MERGE_GAP provides the largest number of unchanged bytes between two changed
+     * ranges that are sent as a single range, as a new range costs DELTA_RANGE_SIZE bytes
+     */
+    static const size_t MERGE_GAP = SignalTypeData::DELTA_RANGE_SIZE;
+
+protected:
+    /**
+     * @brief mark_changed compares the current values against the keyframe, marking
+     * any changed bytes in the change map
+     */
+    void mark_changed();
+
+    /**
+     * @brief next_range finds the next range of changed bytes, merging nearby ranges
+     * @param start is the offset to search from, and stores the start of the range
+     * @param length stores the length of the range
+     * @return true if a range was found
+     */
+    bool next_range(
+            size_t& start,
+            size_t& length) const;
+
+    /**
+     * @brief is_changed determines if the byte has been marked as changed
+     * @param offset is the byte offset to check
+     * @return true if the byte has changed since the keyframe
+     */
+    bool is_changed(const size_t offset) const;
+
+    /**
+     * @brief write_delta writes a delta of every range changed since the keyframe
+     * @param writer is the writer to place the delta into
+     * @return true if the delta fit within the frame and was written
+     */
+    bool write_delta(DataWriter& writer);
+
+protected:
+    /**
+     * @brief signal provides the signal being sent
+     */
+    const SignalTypeData& signal;
+
+    /**
+     * @brief fragmenter provides the fragmenter used to send keyframes
+     */
+    SignalFragmenter fragmenter;
+
+    /**
+     * @brief mtu provides the maximum size of each frame
+     */
+    size_t mtu;
+
+    /**
+     * @brief format provides the wire format to write records with
+     */
+    WireFormat format;
+
+    /**
+     * @brief keyframe_millis provides the interval between keyframes
+     */
+    uint32_t keyframe_millis;
+
+    /**
+     * @brief keyframe_data provides a copy of the values sent in the last keyframe
+     */
+    std::unique_ptr<uint8_t[]> keyframe_data;
+
+    /**
+     * @brief changed_map provides a bit for every byte changed since the keyframe
+     */
+    std::unique_ptr<uint64_t[]> changed_map;
+
+    /**
+     * @brief keyframe_time provides the time the last keyframe was completed
+     */
+    timestamp_t keyframe_time;
+
+    /**
+     * @brief keyframe_version provides the data version of the last keyframe
+     */
+    uint16_t keyframe_version;
+
+    /**
+     * @brief sent_version provides the data version of the last record sent
+     */
+    uint16_t sent_version;
+
+    /**
+     * @brief has_keyframe is true if a keyframe has been completed
+     */
+    bool has_keyframe;
+
+    /**
+     * @brief keyframe_requested is true if a new keyframe should be started
+     */
+    bool keyframe_requested;
+};
+
+}
+
+#endif // TF_SIGNAL_DELTA_H
@@ -0,0 +1,131 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_filter.h"
+
+using namespace efis_signals;
+
+SignalFilter::SignalFilter()
+{
+    accept_all();
+}
+
+void SignalFilter::accept_all()
+{
+    categories.set_all();
+    devices.set_all();
+    signals.set_all();
+    active = false;
+}
+
+void SignalFilter::set_all_categories_accepted(const bool accepted)
+{
+    if (accepted)
+    {
+        categories.set_all();
+    }
+    else
+    {
+        categories.clear_all();
+    }
+    active = true;
+}
+
+void SignalFilter::set_category_accepted(
+        const uint8_t cat_id,
+        const bool accepted)
+{
+    categories.set(cat_id, accepted);
+    active = true;
+}
+
+void SignalFilter::set_category_accepted(
+        const SignalCategory category,
+        const bool accepted)
+{
+    set_category_accepted(static_cast<uint8_t>(category), accepted);
+}
+
+void SignalFilter::set_all_devices_accepted(const bool accepted)
+{
+    if (accepted)
+    {
+        devices.set_all();
+    }
+    else
+    {
+        devices.clear_all();
+    }
+    active = true;
+}
+
+void SignalFilter::set_device_accepted(
+        const uint8_t device_id,
+        const bool accepted)
+{
+    devices.set(device_id, accepted);
+    active = true;
+}
+
+void SignalFilter::set_device_accepted(
+        const SignalDevice device,
+        const bool accepted)
+{
+    set_device_accepted(static_cast<uint8_t>(device), accepted);
+}
+
+void SignalFilter::set_all_signals_accepted(const bool accepted)
+{
+    if (accepted)
+    {
+        signals.set_all();
+    }
+    else
+    {
+        signals.clear_all();
+    }
+    active = true;
+}
+
+void SignalFilter::set_signal_accepted(
+        const SignalDef& signal_def,
+        const bool accepted)
+{
+    signals.set(signal_def.signal_index(), accepted);
+    active = true;
+}
+
+bool SignalFilter::is_active() const
+{
+    return active;
+}
+
+const IdBitmap& SignalFilter::get_categories() const
+{
+    return categories;
+}
+
+const IdBitmap& SignalFilter::get_devices() const
+{
+    return devices;
+}
+
+const SignalBitmap& SignalFilter::get_signals() const
+{
+    return signals;
+}
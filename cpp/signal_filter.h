@@ -0,0 +1,183 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_FILTER_H
+#define TF_SIGNAL_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gen_signal_def.h"
+#include "signal_bitmap.h"
+#include "signal_header.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SignalFilter class provides a receive accept-list over categories,
+ * source devices and signal indexes. A record is accepted only if its category,
+ * device and signal are all accepted. The check only uses the fixed-size header,
+ * so that unwanted records can be dropped before any lookup or payload decode.
+ * Status category records carry the protocol itself and are always accepted
+ */
+class SignalFilter
+{
+public:
+    /**
+     * @brief SignalFilter constructs a filter that accepts every record
+     */
+    SignalFilter();
+
+    /**
+     * @brief accept_all resets the filter to accept every record
+     */
+    void accept_all();
+
+    /**
+     * @brief set_all_categories_accepted sets whether every category is accepted
+     * @param accepted is true to accept, false to reject
+     */
+    void set_all_categories_accepted(const bool accepted);
+
+    /**
+     * @brief set_category_accepted sets whether a category is accepted
+     * @param cat_id is the category ID
+     * @param accepted is true to accept, false to reject
+     */
+    void set_category_accepted(
+            const uint8_t cat_id,
+            const bool accepted);
+
+    /**
+     * @brief set_category_accepted sets whether a category is accepted
+     * @param category is the category
+     * @param accepted is true to accept, false to reject
+     */
+    void set_category_accepted(
+            const SignalCategory category,
+            const bool accepted);
+
+    /**
+     * @brief set_all_devices_accepted sets whether every source device is accepted
+     * @param accepted is true to accept, false to reject
+     */
+    void set_all_devices_accepted(const bool accepted);
+
+    /**
+     * @brief set_device_accepted sets whether records from a source device are accepted
+     * @param device_id is the device ID
+     * @param accepted is true to accept, false to reject
+     */
+    void set_device_accepted(
+            const uint8_t device_id,
+            const bool accepted);
+
+    /**
+     * @brief set_device_accepted sets whether records from a source device are accepted
+     * @param device is the device
+     * @param accepted is true to accept, false to reject
+     */
+    void set_device_accepted(
+            const SignalDevice device,
+            const bool accepted);
+
+    /**
+     * @brief set_all_signals_accepted sets whether every signal is accepted
+     * @param accepted is true to accept, false to reject
+     */
+    void set_all_signals_accepted(const bool accepted);
+
+    /**
+     * @brief set_signal_accepted sets whether a single signal is accepted
+     * @param signal_def is the signal definition
+     * @param accepted is true to accept, false to reject
+     */
+    void set_signal_accepted(
+            const SignalDef& signal_def,
+            const bool accepted);
+
+    /**
+     * @brief is_active determines if the filter may reject any record
+     * @return true if the filter has been changed from accepting every record
+     */
+    bool is_active() const;
+
+    /**
+     * @brief is_accepted determines if a received record should be processed
+     * @param header is the record header
+     * @return true if the record is accepted
+     */
+    bool is_accepted(const SignalHeader& header) const
+    {
+        if (!active || header.cat_id == static_cast<uint8_t>(SignalCategory::Status))
+        {
+            return true;
+        }
+
+        const size_t signal_index = (static_cast<size_t>(header.cat_id) << 8) | header.sub_id;
+        return
+                categories.test(header.cat_id) &&
+                devices.test(header.from_device) &&
+                signals.test(signal_index);
+    }
+
+    /**
+     * @brief get_categories provides the accepted category bitmap
+     * @return the category bitmap
+     */
+    const IdBitmap& get_categories() const;
+
+    /**
+     * @brief get_devices provides the accepted device bitmap
+     * @return the device bitmap
+     */
+    const IdBitmap& get_devices() const;
+
+    /**
+     * @brief get_signals provides the accepted signal index bitmap
+     * @return the signal bitmap
+     */
+    const SignalBitmap& get_signals() const;
+
+protected:
+    /**
+     * @brief categories provides the accepted category IDs
+     */
+    IdBitmap categories;
+
+    /**
+     * @brief devices provides the accepted source device IDs
+     */
+    IdBitmap devices;
+
+    /**
+     * @brief signals provides the accepted signal indexes
+     */
+    SignalBitmap signals;
+
+    /**
+     * @brief active is true once any record may be rejected, allowing the
+     * bitmaps to be skipped for an unfiltered receiver
+     */
+    bool active;
+};
+
+}
+
+#endif // TF_SIGNAL_FILTER_H
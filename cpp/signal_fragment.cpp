@@ -0,0 +1,528 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_fragment.h"
+
+#include "gen_signal_def.h"
+
+#include <cstring>
+#include <limits>
+#include <new>
+
+using namespace efis_signals;
+
+FragmentHeader::FragmentHeader() :
+    cat_id(0),
+    sub_id(0),
+    flags(0),
+    message_id(0),
+    fragment_index(0),
+    fragment_count(0),
+    total_size(0),
+    offset(0),
+    length(0)
+{
+    // Empty Constructor
+}
+
+bool FragmentHeader::write_header(DataWriter& writer) const
+{
+    return
+            writer.add_ubyte(cat_id) &&
+            writer.add_ubyte(sub_id) &&
+            writer.add_ubyte(flags) &&
+            writer.add_ushort(message_id) &&
+            writer.add_ushort(fragment_index) &&
+            writer.add_ushort(fragment_count) &&
+            writer.add_uint(total_size) &&
+            writer.add_uint(offset) &&
+            writer.add_ushort(length);
+}
+
+bool FragmentHeader::read_header(DataReader& reader)
+{
+    return
+            reader.read_ubyte(cat_id) &&
+            reader.read_ubyte(sub_id) &&
+            reader.read_ubyte(flags) &&
+            reader.read_ushort(message_id) &&
+            reader.read_ushort(fragment_index) &&
+            reader.read_ushort(fragment_count) &&
+            reader.read_uint(total_size) &&
+            reader.read_uint(offset) &&
+            reader.read_ushort(length);
+}
+
+bool FragmentHeader::is_consistent() const
+{
+    if (fragment_count == 0 ||
+            fragment_count > SignalReassembler::MAX_FRAGMENT_COUNT ||
+            fragment_index >= fragment_count ||
+            offset > total_size ||
+            length > total_size - offset)
+    {
+        return false;
+    }
+    else if (fragment_index + 1 < fragment_count)
+    {
+        // Every fragment but the last carries a full chunk at the offset of its
+        // index, leaving between one byte and one chunk for the last fragment
+        const uint64_t chunk = length;
+        return
+                length > 0 &&
+                offset == fragment_index * chunk &&
+                (fragment_count - 1) * chunk < total_size &&
+                total_size <= fragment_count * chunk;
+    }
+    else if (fragment_count > 1)
+    {
+        // The last fragment starts after the full chunks and ends the data
+        const uint32_t chunk = offset / (fragment_count - 1);
+        return
+                offset % (fragment_count - 1) == 0 &&
+                length > 0 &&
+                length <= chunk &&
+                offset + length == total_size;
+    }
+    else
+    {
+        // A single fragment carries all of the data
+        return offset == 0 && length == total_size;
+    }
+}
+
+uint32_t FragmentHeader::chunk_size() const
+{
+    if (fragment_index + 1 < fragment_count)
+    {
+        return length;
+    }
+    else if (fragment_count > 1)
+    {
+        return offset / (fragment_count - 1);
+    }
+    else
+    {
+        return total_size;
+    }
+}
+
+SignalFragmenter::SignalFragmenter(
+        const size_t mtu,
+        const WireFormat format) :
+    mtu(mtu),
+    format(format),
+    signal(nullptr),
+    payload(nullptr),
+    payload_size(0),
+    payload_flags(0),
+    message_id(0),
+    next_fragment(0),
+    fragment_count(0)
+{
+    // Empty Constructor
+}
+
+bool SignalFragmenter::start(const SignalTypeData& signal)
+{
+    if (signal.get_source_type() != SignalSourceType::Transmitted)
+    {
+        return false;
+    }
+
+    this->signal = &signal;
+    return start_transfer();
+}
+
+bool SignalFragmenter::is_active() const
+{
+    return signal != nullptr && next_fragment < fragment_count;
+}
+
+void SignalFragmenter::cancel()
+{
+    signal = nullptr;
+}
+
+bool SignalFragmenter::write_fragment(DataWriter& writer)
+{
+    if (!is_active())
+    {
+        return false;
+    }
+
+    // Restart the transfer if the values have changed since the transfer started
+    if (signal->get_data_version() != message_id && !start_transfer())
+    {
+        return false;
+    }
+
+    // Determine the fragment parameters
+    const size_t chunk = chunk_size();
+    const SignalHeader& data_header = signal->get_header();
+
+    FragmentHeader fragment;
+    fragment.cat_id = data_header.cat_id;
+    fragment.sub_id = data_header.sub_id;
+    fragment.flags = payload_flags;
+    fragment.message_id = message_id;
+    fragment.fragment_index = next_fragment;
+    fragment.fragment_count = fragment_count;
+    fragment.total_size = payload_size;
+    fragment.offset = static_cast<uint32_t>(next_fragment * chunk);
+
+    const size_t remaining = fragment.total_size - fragment.offset;
+    fragment.length = static_cast<uint16_t>(remaining < chunk ? remaining : chunk);
+
+    const size_t record_payload_size = FragmentHeader::HEADER_SIZE + fragment.length;
+    if (writer.bytes_available() < SignalHeader::record_overhead(format, record_payload_size) + record_payload_size)
+    {
+        return false;
+    }
+
+    // Write the fragment record, taking the data directly from the signal
+    SignalHeader fragment_header;
+    fragment_header.cat_id = SIGNAL_DEF_DATA_FRAGMENT.category_id;
+    fragment_header.sub_id = SIGNAL_DEF_DATA_FRAGMENT.sub_id;
+    fragment_header.priority = data_header.priority;
+    fragment_header.from_device = data_header.from_device;
+    fragment_header.timestamp = data_header.timestamp;
+
+    size_t payload_start = 0;
+    if (fragment_header.write_record_start(writer, format, record_payload_size, payload_start) &&
+            fragment.write_header(writer) &&
+            writer.add_bytes(payload + fragment.offset, fragment.length) &&
+            SignalHeader::write_record_end(writer, format, record_payload_size, payload_start))
+    {
+        next_fragment += 1;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool SignalFragmenter::start_transfer()
+{
+    const size_t chunk = chunk_size();
+
+    // Obtain the encoded values, which may be compressed
+    SignalTypeData::data_size_t encoded_size = 0;
+    bool compressed = false;
+    payload = signal->get_encoded_data(encoded_size, compressed);
+    payload_size = encoded_size;
+    payload_flags = compressed ? FragmentHeader::FLAG_COMPRESSED : 0;
+
+    // Determine the number of fragments, always sending at least one
+    const size_t count = chunk == 0 ?
+                0 :
+                (payload_size > 0 ? (payload_size + chunk - 1) / chunk : 1);
+
+    if (count == 0 || count > SignalReassembler::MAX_FRAGMENT_COUNT)
+    {
+        signal = nullptr;
+        return false;
+    }
+
+    message_id = signal->get_data_version();
+    next_fragment = 0;
+    fragment_count = static_cast<uint16_t>(count);
+
+    return true;
+}
+
+uint16_t SignalFragmenter::get_message_id() const
+{
+    return message_id;
+}
+
+size_t SignalFragmenter::chunk_size() const
+{
+    // The record length can be no larger than the MTU, which bounds its encoded size
+    const size_t overhead = SignalHeader::record_overhead(format, mtu) + FragmentHeader::HEADER_SIZE;
+    const size_t max_chunk = std::numeric_limits<uint16_t>::max();
+
+    if (mtu <= overhead)
+    {
+        return 0;
+    }
+    else
+    {
+        return mtu - overhead < max_chunk ? mtu - overhead : max_chunk;
+    }
+}
+
+SignalReassembler::SignalReassembler(
+        const size_t memory_limit,
+        const uint32_t timeout_millis) :
+    memory_limit(memory_limit),
+    memory_used(0),
+    timeout_millis(timeout_millis),
+    dropped_count(0)
+{
+    for (size_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        slots[i].in_use = false;
+        slots[i].buffer_capacity = 0;
+    }
+}
+
+bool SignalReassembler::add_fragment(
+        const SignalHeader& header,
+        const FragmentHeader& fragment,
+        DataReader& reader,
+        const timestamp_t now,
+        size_t& slot_index)
+{
+    if (!fragment.is_consistent() || reader.bytes_available() < fragment.length)
+    {
+        return false;
+    }
+
+    // Find the slot for the transfer
+    expire(now);
+    slot_index = find_slot(header, fragment, now);
+    if (slot_index >= SLOT_COUNT)
+    {
+        return false;
+    }
+
+    ReassemblySlot& slot = slots[slot_index];
+    if (slot.total_size != fragment.total_size ||
+            slot.fragment_count != fragment.fragment_count ||
+            slot.chunk_size != fragment.chunk_size() ||
+            slot.flags != fragment.flags)
+    {
+        return false;
+    }
+
+    // Skip any duplicate fragments
+    const uint64_t fragment_bit = static_cast<uint64_t>(1) << (fragment.fragment_index % 64);
+    uint64_t& map_word = slot.received_map[fragment.fragment_index / 64];
+    if ((map_word & fragment_bit) != 0)
+    {
+        return reader.skip(fragment.length);
+    }
+
+    // Read the fragment data directly into the reassembly buffer
+    if (!reader.read_bytes(slot.buffer.get() + fragment.offset, fragment.length))
+    {
+        return false;
+    }
+
+    map_word |= fragment_bit;
+    slot.received_count += 1;
+    slot.received_size += fragment.length;
+    slot.last_update = now;
+
+    return true;
+}
+
+bool SignalReassembler::is_complete(const size_t slot_index) const
+{
+    return
+            slot_index < SLOT_COUNT &&
+            slots[slot_index].in_use &&
+            slots[slot_index].received_count == slots[slot_index].fragment_count &&
+            slots[slot_index].received_size == slots[slot_index].total_size;
+}
+
+bool SignalReassembler::deliver(
+        const size_t slot_index,
+        SignalTypeData& signal)
+{
+    if (!is_complete(slot_index))
+    {
+        return false;
+    }
+
+    ReassemblySlot& slot = slots[slot_index];
+
+    // Compressed values are decompressed by the signal, leaving the buffer in the slot
+    if ((slot.flags & FragmentHeader::FLAG_COMPRESSED) != 0)
+    {
+        const bool success = signal.decode_compressed(slot.buffer.get(), slot.total_size);
+        release_slot(slot_index);
+        return success;
+    }
+
+    const uint8_t* previous_buffer = slot.buffer.get();
+    if (!signal.exchange_data(slot.buffer, slot.total_size))
+    {
+        return false;
+    }
+
+    // Update the memory accounting if the buffer has been taken by the signal
+    if (slot.buffer.get() != previous_buffer)
+    {
+        memory_used -= slot.buffer_capacity;
+        slot.buffer_capacity = slot.buffer != nullptr ? slot.total_size : 0;
+        memory_used += slot.buffer_capacity;
+    }
+
+    release_slot(slot_index);
+    return true;
+}
+
+void SignalReassembler::discard(const size_t slot_index)
+{
+    if (slot_index < SLOT_COUNT && slots[slot_index].in_use)
+    {
+        release_slot(slot_index);
+        dropped_count += 1;
+    }
+}
+
+void SignalReassembler::expire(const timestamp_t now)
+{
+    for (size_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        if (slots[i].in_use && now - slots[i].last_update > timeout_millis)
+        {
+            release_slot(i);
+            dropped_count += 1;
+        }
+    }
+}
+
+size_t SignalReassembler::get_memory_used() const
+{
+    return memory_used;
+}
+
+uint32_t SignalReassembler::get_dropped_count() const
+{
+    return dropped_count;
+}
+
+size_t SignalReassembler::find_slot(
+        const SignalHeader& header,
+        const FragmentHeader& fragment,
+        const timestamp_t now)
+{
+    size_t slot_index = SLOT_COUNT;
+
+    // Search for an existing transfer of the signal from the device
+    for (size_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        const ReassemblySlot& slot = slots[i];
+        if (slot.in_use &&
+                slot.from_device == header.from_device &&
+                slot.cat_id == fragment.cat_id &&
+                slot.sub_id == fragment.sub_id)
+        {
+            if (slot.message_id == fragment.message_id)
+            {
+                return i;
+            }
+
+            // A new message replaces the previous incomplete transfer
+            release_slot(i);
+            dropped_count += 1;
+            slot_index = i;
+            break;
+        }
+    }
+
+    // Otherwise, use a free slot, preferring one with a large enough buffer
+    if (slot_index >= SLOT_COUNT)
+    {
+        for (size_t i = 0; i < SLOT_COUNT; ++i)
+        {
+            if (!slots[i].in_use &&
+                    (slot_index >= SLOT_COUNT || slots[i].buffer_capacity >= fragment.total_size))
+            {
+                slot_index = i;
+            }
+        }
+    }
+
+    if (slot_index >= SLOT_COUNT || !reserve_buffer(slot_index, fragment.total_size))
+    {
+        dropped_count += 1;
+        return SLOT_COUNT;
+    }
+
+    // Start the new transfer
+    ReassemblySlot& slot = slots[slot_index];
+    slot.in_use = true;
+    slot.from_device = header.from_device;
+    slot.cat_id = fragment.cat_id;
+    slot.sub_id = fragment.sub_id;
+    slot.flags = fragment.flags;
+    slot.message_id = fragment.message_id;
+    slot.fragment_count = fragment.fragment_count;
+    slot.received_count = 0;
+    slot.total_size = fragment.total_size;
+    slot.chunk_size = fragment.chunk_size();
+    slot.received_size = 0;
+    slot.last_update = now;
+    memset(slot.received_map, 0, sizeof(slot.received_map));
+
+    return slot_index;
+}
+
+bool SignalReassembler::reserve_buffer(
+        const size_t slot_index,
+        const size_t size)
+{
+    ReassemblySlot& slot = slots[slot_index];
+    if (slot.buffer != nullptr && slot.buffer_capacity >= size)
+    {
+        return true;
+    }
+
+    // Release the current buffer, which is too small
+    memory_used -= slot.buffer_capacity;
+    slot.buffer.reset();
+    slot.buffer_capacity = 0;
+
+    // Release idle buffers until the new buffer fits within the memory limit
+    for (size_t i = 0; i < SLOT_COUNT && memory_used + size > memory_limit; ++i)
+    {
+        if (!slots[i].in_use && slots[i].buffer != nullptr)
+        {
+            memory_used -= slots[i].buffer_capacity;
+            slots[i].buffer.reset();
+            slots[i].buffer_capacity = 0;
+        }
+    }
+
+    if (memory_used + size > memory_limit)
+    {
+        return false;
+    }
+
+    // Allocate the new buffer, keeping at least a single byte so that empty transfers have a buffer
+    const size_t capacity = size > 0 ? size : 1;
+    slot.buffer.reset(new (std::nothrow) uint8_t[capacity]);
+    if (slot.buffer == nullptr)
+    {
+        return false;
+    }
+
+    slot.buffer_capacity = capacity;
+    memory_used += capacity;
+    return true;
+}
+
+void SignalReassembler::release_slot(const size_t slot_index)
+{
+    slots[slot_index].in_use = false;
+}
@@ -0,0 +1,427 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_FRAGMENT_H
+#define TF_SIGNAL_FRAGMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "signal_header.h"
+#include "signal_time.h"
+#include "signal_type_data.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The FragmentHeader struct provides the prefix for each fragment of a
+ * data signal, sent as the payload of the data_fragment status signal. The
+ * fragment data follows the fragment header directly
+ */
+struct FragmentHeader
+{
+    /**
+     * @brief cat_id provides the category ID of the data signal being sent
+     */
+    uint8_t cat_id;
+
+    /**
+     * @brief sub_id provides the sub ID of the data signal being sent
+     */
+    uint8_t sub_id;
+
+    /**
+     * @brief flags provides the encoding flags for the transfer
+     */
+    uint8_t flags;
+
+    /**
+     * @brief message_id identifies the transfer, providing the data version of the values sent
+     */
+    uint16_t message_id;
+
+    /**
+     * @brief fragment_index provides the index of the fragment within the transfer
+     */
+    uint16_t fragment_index;
+
+    /**
+     * @brief fragment_count provides the total number of fragments in the transfer
+     */
+    uint16_t fragment_count;
+
+    /**
+     * @brief total_size provides the total size of the encoded data array being sent
+     */
+    uint32_t total_size;
+
+    /**
+     * @brief offset provides the offset of the fragment data within the data array
+     */
+    uint32_t offset;
+
+    /**
+     * @brief length provides the number of data bytes following the fragment header
+     */
+    uint16_t length;
+
+    /**
+     * @brief HEADER_SIZE provides the size of the fragment header when written
+     */
+    static const size_t HEADER_SIZE = 1 + 1 + 1 + 2 + 2 + 2 + 4 + 4 + 2;
+
+    /**
+     * @brief FLAG_COMPRESSED is set if the transfer contains compressed data values
+     */
+    static const uint8_t FLAG_COMPRESSED = 0x01;
+
+    /**
+     * @brief FragmentHeader constructs an empty fragment header
+     */
+    FragmentHeader();
+
+    /**
+     * @brief write_header writes the fragment header to the writer
+     * @param writer is the writer to write to
+     * @return true if the header was able to be written
+     */
+    bool write_header(DataWriter& writer) const;
+
+    /**
+     * @brief read_header reads the fragment header from the reader
+     * @param reader is the reader to read from
+     * @return true if the header was able to be read
+     */
+    bool read_header(DataReader& reader);
+
+    /**
+     * @brief is_consistent determines if the header describes a valid fragment.
+     * Every fragment but the last must carry a full chunk at the offset of its
+     * index, and the last fragment must end the data array, so that the fragments
+     * of a transfer cover the data array exactly once
+     * @return true if the fragment lies at the position given by its index
+     */
+    bool is_consistent() const;
+
+    /**
+     * @brief chunk_size provides the chunk size of the transfer implied by the
+     * fragment, which must match for every fragment of a transfer
+     * @return the number of data bytes in each full fragment
+     */
+    uint32_t chunk_size() const;
+};
+
+/**
+ * @brief The SignalFragmenter class provides the producer side of the data
+ * fragmentation protocol. Data signals larger than a single frame are split into
+ * data_fragment records, each of which fits within the provided MTU. Fragment
+ * data is written directly from the signal data array without an intermediate copy
+ */
+class SignalFragmenter
+{
+public:
+    /**
+     * @brief SignalFragmenter constructs an inactive fragmenter
+     * @param mtu is the maximum number of bytes to write into a single frame
+     * @param format is the wire format to write fragment records with
+     */
+    SignalFragmenter(
+            const size_t mtu,
+            const WireFormat format);
+
+    /**
+     * @brief start starts a new transfer of the provided data signal, replacing any
+     * transfer in progress. The signal must remain available until the transfer completes
+     * @param signal is the transmitted data signal to send
+     * @return true if the signal is able to be sent within the fragment limits
+     */
+    bool start(const SignalTypeData& signal);
+
+    /**
+     * @brief is_active determines if a transfer is in progress
+     * @return true if fragments remain to be sent
+     */
+    bool is_active() const;
+
+    /**
+     * @brief cancel stops the transfer in progress, if any
+     */
+    void cancel();
+
+    /**
+     * @brief write_fragment writes the next fragment record into the writer. If the
+     * signal has been updated since the transfer started, the transfer is restarted
+     * with the new data version so that the receiver never combines different values
+     * @param writer is the writer to place the fragment into
+     * @return true if a fragment was written
+     */
+    bool write_fragment(DataWriter& writer);
+
+    /**
+     * @brief get_message_id provides the message ID of the current or last transfer
+     * @return the data version being sent
+     */
+    uint16_t get_message_id() const;
+
+    /**
+     * @brief chunk_size provides the number of data bytes carried in each fragment
+     * @return the fragment data size
+     */
+    size_t chunk_size() const;
+
+protected:
+    /**
+     * @brief start_transfer starts sending the current encoded values of the signal
+     * @return true if the encoded values are able to be sent within the fragment limits
+     */
+    bool start_transfer();
+
+protected:
+    /**
+     * @brief mtu provides the maximum size of each frame
+     */
+    size_t mtu;
+
+    /**
+     * @brief format provides the wire format to write fragment records with
+     */
+    WireFormat format;
+
+    /**
+     * @brief signal provides the signal being transferred
+     */
+    const SignalTypeData* signal;
+
+    /**
+     * @brief payload provides the encoded values being transferred
+     */
+    const uint8_t* payload;
+
+    /**
+     * @brief payload_size provides the number of encoded bytes being transferred
+     */
+    uint32_t payload_size;
+
+    /**
+     * @brief payload_flags provides the fragment flags for the encoded values
+     */
+    uint8_t payload_flags;
+
+    /**
+     * @brief message_id provides the message ID of the current transfer, which is
+     * the data version of the signal when the transfer started
+     */
+    uint16_t message_id;
+
+    /**
+     * @brief next_fragment provides the index of the next fragment to send
+     */
+    uint16_t next_fragment;
+
+    /**
+     * @brief fragment_count provides the number of fragments in the current transfer
+     */
+    uint16_t fragment_count;
+};
+
+/**
+ * @brief The SignalReassembler class provides the consumer side of the data
+ * fragmentation protocol. Fragments are collected into a bounded table of
+ * reassembly slots, limited in both the number of transfers and the total buffer
+ * memory. Transfers that are not completed within the timeout are discarded.
+ * Completed buffers are exchanged directly into the target data signal
+ */
+class SignalReassembler
+{
+public:
+    /**
+     * @brief SignalReassembler constructs an empty reassembly table
+     * @param memory_limit is the maximum number of bytes to hold in reassembly buffers
+     * @param timeout_millis is the time after the last fragment at which a transfer is discarded
+     */
+    SignalReassembler(
+            const size_t memory_limit = DEFAULT_MEMORY_LIMIT,
+            const uint32_t timeout_millis = DEFAULT_TIMEOUT_MILLIS);
+
+    /**
+     * @brief add_fragment adds the fragment data from the reader into the matching
+     * reassembly slot, starting a new transfer if required
+     * @param header is the signal header the fragment was received with
+     * @param fragment is the fragment header for the data
+     * @param reader is the reader containing the fragment data
+     * @param now is the current time
+     * @param slot_index stores the index of the slot the fragment was added to
+     * @return true if the fragment was accepted
+     */
+    bool add_fragment(
+            const SignalHeader& header,
+            const FragmentHeader& fragment,
+            DataReader& reader,
+            const timestamp_t now,
+            size_t& slot_index);
+
+    /**
+     * @brief is_complete determines if all fragments have been received for a slot
+     * @param slot_index is the slot to check
+     * @return true if the slot holds a complete data array
+     */
+    bool is_complete(const size_t slot_index) const;
+
+    /**
+     * @brief deliver exchanges the completed slot buffer into the data signal, or
+     * decompresses the buffer for compressed transfers, and frees the slot. Any
+     * buffer returned by the signal is kept for later transfers
+     * @param slot_index is the completed slot to deliver
+     * @param signal is the signal to deliver the data into
+     * @return true if the data was delivered
+     */
+    bool deliver(
+            const size_t slot_index,
+            SignalTypeData& signal);
+
+    /**
+     * @brief discard frees the slot without delivering the data
+     * @param slot_index is the slot to discard
+     */
+    void discard(const size_t slot_index);
+
+    /**
+     * @brief expire discards any transfers that have timed out
+     * @param now is the current time
+     */
+    void expire(const timestamp_t now);
+
+    /**
+     * @brief get_memory_used provides the number of bytes held in reassembly buffers
+     * @return the buffer memory in use
+     */
+    size_t get_memory_used() const;
+
+    /**
+     * @brief get_dropped_count provides the number of transfers discarded due to
+     * timeouts, replacement or resource limits
+     * @return the number of dropped transfers
+     */
+    uint32_t get_dropped_count() const;
+
+    /**
+     * @brief SLOT_COUNT provides the maximum number of concurrent transfers
+     */
+    static const size_t SLOT_COUNT = 8;
+
+    /**
+     * @brief MAX_FRAGMENT_COUNT provides the maximum number of fragments in a transfer
+     */
+    static const size_t MAX_FRAGMENT_COUNT = 4096;
+
+    /**
+     * @brief DEFAULT_MEMORY_LIMIT provides the default reassembly buffer memory limit
+     */
+    static const size_t DEFAULT_MEMORY_LIMIT = 1024 * 1024;
+
+    /**
+     * @brief DEFAULT_TIMEOUT_MILLIS provides the default transfer timeout
+     */
+    static const uint32_t DEFAULT_TIMEOUT_MILLIS = 2000;
+
+protected:
+    /**
+     * @brief The ReassemblySlot struct provides the state of a single transfer
+     */
+    struct ReassemblySlot
+    {
+        bool in_use;
+        uint8_t from_device;
+        uint8_t cat_id;
+        uint8_t sub_id;
+        uint8_t flags;
+        uint16_t message_id;
+        uint16_t fragment_count;
+        uint16_t received_count;
+        uint32_t total_size;
+        uint32_t chunk_size;
+        uint32_t received_size;
+        timestamp_t last_update;
+        size_t buffer_capacity;
+        std::unique_ptr<uint8_t[]> buffer;
+        uint64_t received_map[MAX_FRAGMENT_COUNT / 64];
+    };
+
+    /**
+     * @brief find_slot finds the slot for the fragment, or allocates a new slot
+     * @param header is the signal header the fragment was received with
+     * @param fragment is the fragment header to find the slot for
+     * @param now is the current time
+     * @return the slot index, or SLOT_COUNT if no slot is available
+     */
+    size_t find_slot(
+            const SignalHeader& header,
+            const FragmentHeader& fragment,
+            const timestamp_t now);
+
+    /**
+     * @brief reserve_buffer ensures that the slot buffer holds at least the provided
+     * size, releasing idle buffers if required to stay within the memory limit
+     * @param slot_index is the slot to reserve the buffer for
+     * @param size is the required buffer size
+     * @return true if the buffer is available
+     */
+    bool reserve_buffer(
+            const size_t slot_index,
+            const size_t size);
+
+    /**
+     * @brief release_slot frees the slot, keeping the buffer for reuse
+     * @param slot_index is the slot to release
+     */
+    void release_slot(const size_t slot_index);
+
+protected:
+    /**
+     * @brief slots provides the reassembly table
+     */
+    ReassemblySlot slots[SLOT_COUNT];
+
+    /**
+     * @brief memory_limit provides the maximum number of bytes held in buffers
+     */
+    size_t memory_limit;
+
+    /**
+     * @brief memory_used provides the number of bytes held in buffers
+     */
+    size_t memory_used;
+
+    /**
+     * @brief timeout_millis provides the transfer timeout
+     */
+    uint32_t timeout_millis;
+
+    /**
+     * @brief dropped_count provides the number of discarded transfers
+     */
+    uint32_t dropped_count;
+};
+
+}
+
+#endif // TF_SIGNAL_FRAGMENT_H
@@ -21,6 +21,31 @@
 
 using namespace efis_signals;
 
+uint8_t efis_signals::get_frame_info_priority(const WireFormat format)
+{
+    return FRAME_INFO_LEGACY_PRIORITY | static_cast<uint8_t>(format);
+}
+
+bool efis_signals::get_frame_info_format(
+        const uint8_t priority,
+        WireFormat& format)
+{
+    if (priority == FRAME_INFO_LEGACY_PRIORITY || priority == get_frame_info_priority(WireFormat::V1))
+    {
+        format = WireFormat::V1;
+        return true;
+    }
+    else if (priority == get_frame_info_priority(WireFormat::V2))
+    {
+        format = WireFormat::V2;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 SignalHeader::SignalHeader() :
     cat_id(0),
     sub_id(0),
@@ -51,6 +76,93 @@ bool SignalHeader::read_header(DataReader& reader)
             reader.read_uint(timestamp);
 }
 
+bool SignalHeader::write_record_start(
+        DataWriter& writer,
+        const WireFormat format,
+        const size_t payload_size,
+        size_t& payload_start) const
+{
+    if (!write_header(writer))
+    {
+        return false;
+    }
+    else if (format == WireFormat::V2 &&
+             (payload_size > UINT32_MAX || !writer.add_varint(static_cast<uint32_t>(payload_size))))
+    {
+        return false;
+    }
+    else
+    {
+        payload_start = writer.bytes_written();
+        return true;
+    }
+}
+
+bool SignalHeader::write_record_end(
+        DataWriter& writer,
+        const WireFormat format,
+        const size_t payload_size,
+        const size_t payload_start)
+{
+    if (format == WireFormat::V1)
+    {
+        return true;
+    }
+    else if (payload_start > writer.bytes_written())
+    {
+        return false;
+    }
+
+    const size_t written_size = writer.bytes_written() - payload_start;
+    if (written_size == payload_size)
+    {
+        return true;
+    }
+    else if (written_size > payload_size)
+    {
+        return false;
+    }
+
+    // Rewrite the length of a smaller payload in the bytes reserved for the
+    // provided size, so that the payload is not moved
+    const size_t length_size = DataWriter::varint_size(static_cast<uint32_t>(payload_size));
+    return
+            payload_start >= length_size &&
+            writer.set_varint(payload_start - length_size, static_cast<uint32_t>(written_size), length_size);
+}
+
+size_t SignalHeader::record_overhead(
+        const WireFormat format,
+        const size_t payload_size)
+{
+    if (format == WireFormat::V1)
+    {
+        return HEADER_SIZE;
+    }
+    else
+    {
+        return HEADER_SIZE + DataWriter::varint_size(static_cast<uint32_t>(payload_size));
+    }
+}
+
+bool SignalHeader::read_record_payload(
+        DataReader& reader,
+        DataReader& payload)
+{
+    uint32_t payload_size = 0;
+    const uint8_t* payload_data = nullptr;
+
+    if (reader.read_varint(payload_size) && reader.read_span(payload_data, payload_size))
+    {
+        payload.set_buffer(payload_data, payload_size);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 SignalDef SignalHeader::get_signal_def() const
 {
     SignalDef sig_def;
@@ -28,6 +28,46 @@
 namespace efis_signals
 {
 
+/**
+ * @brief The WireFormat enum provides the record framing used on the network.
+ * V1 records are a header followed directly by the payload, where the payload
+ * size is implied by the signal type. V2 records add a varint payload length
+ * after the header, so that any record can be skipped without knowing the signal
+ */
+enum class WireFormat : uint8_t
+{
+    V1 = 1,
+    V2 = 2
+};
+
+/**
+ * @brief FRAME_INFO_LEGACY_PRIORITY provides the header priority of frame information
+ * records sent by builds that do not mark the wire format. These frames use the V1
+ * wire format and the frame information holds only the sequence number
+ */
+const uint8_t FRAME_INFO_LEGACY_PRIORITY = 0x80;
+
+/**
+ * @brief get_frame_info_priority provides the header priority of a frame information
+ * record, which marks the wire format of the frame. Frame information is never
+ * arbitrated, and the header is the only part of a record that can be read before
+ * the wire format is known
+ * @param format is the wire format of the frame
+ * @return the priority to send the frame information record with
+ */
+uint8_t get_frame_info_priority(const WireFormat format);
+
+/**
+ * @brief get_frame_info_format determines the wire format marked by the header
+ * priority of a frame information record
+ * @param priority is the header priority of the frame information record
+ * @param format provides the wire format of the frame
+ * @return true if the wire format is known
+ */
+bool get_frame_info_format(
+        const uint8_t priority,
+        WireFormat& format);
+
 /**
  * @brief The SignalHeader struct defines common base-type signal
  * values across all signal types and provides the basic header
@@ -60,6 +100,11 @@ struct SignalHeader
      */
     uint32_t timestamp;
 
+    /**
+     * @brief HEADER_SIZE provides the number of bytes written for each header
+     */
+    static const size_t HEADER_SIZE = 8;
+
     /**
      * @brief SignalHeader constructs an empty/invalid signal header
      */
@@ -79,6 +124,62 @@ struct SignalHeader
      */
     bool read_header(DataReader& reader);
 
+    /**
+     * @brief write_record_start writes the header at the start of a record,
+     * followed by the payload length for the V2 wire format. The payload should
+     * then be written, followed by write_record_end
+     * @param writer is the data writer to write data into
+     * @param format is the wire format of the record
+     * @param payload_size is the size of the payload to be written. For payloads
+     * of a variable size, this is the largest size that may be written
+     * @param payload_start provides the writer position of the payload
+     * @return true if the header is written successfully
+     */
+    bool write_record_start(
+            DataWriter& writer,
+            const WireFormat format,
+            const size_t payload_size,
+            size_t& payload_start) const;
+
+    /**
+     * @brief write_record_end completes a record once the payload has been written.
+     * For the V2 wire format, a payload smaller than provided to write_record_start
+     * has its length rewritten in place, keeping the width of the original length
+     * @param writer is the data writer the record was written into
+     * @param format is the wire format of the record
+     * @param payload_size is the payload size provided to write_record_start
+     * @param payload_start is the payload position from write_record_start
+     * @return true if the payload fit within the provided size
+     */
+    static bool write_record_end(
+            DataWriter& writer,
+            const WireFormat format,
+            const size_t payload_size,
+            const size_t payload_start);
+
+    /**
+     * @brief record_overhead determines the number of bytes written for a record
+     * in addition to the payload
+     * @param format is the wire format of the record
+     * @param payload_size is the size of the payload in bytes
+     * @return the record overhead in bytes
+     */
+    static size_t record_overhead(
+            const WireFormat format,
+            const size_t payload_size);
+
+    /**
+     * @brief read_record_payload reads the payload length that follows the header
+     * for the V2 wire format, providing a reader limited to the payload and advancing
+     * the reader past the whole record. Only applies to the V2 wire format
+     * @param reader is the data reader, positioned directly after the header
+     * @param payload provides the reader for the record payload
+     * @return true if the complete payload is available
+     */
+    static bool read_record_payload(
+            DataReader& reader,
+            DataReader& payload);
+
     /**
      * @brief get_signal_def attempts to obtain the signal definition
      * @return the signal_def for the header, or the NULL signal if none is found
@@ -0,0 +1,520 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_latency.h"
+
+#include "gen_signal_def.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+using namespace efis_signals;
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::record(const uint32_t value)
+{
+    buckets[bucket_for_value(value)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+    total_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint32_t current_min = min_value.load(std::memory_order_relaxed);
+    while (value < current_min &&
+           !min_value.compare_exchange_weak(current_min, value, std::memory_order_relaxed))
+    {
+    }
+
+    uint32_t current_max = max_value.load(std::memory_order_relaxed);
+    while (value > current_max &&
+           !max_value.compare_exchange_weak(current_max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        const uint32_t count = other.buckets[i].load(std::memory_order_relaxed);
+        if (count != 0)
+        {
+            buckets[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    total_count.fetch_add(other.total_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total_sum.fetch_add(other.total_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const uint32_t other_min = other.min_value.load(std::memory_order_relaxed);
+    uint32_t current_min = min_value.load(std::memory_order_relaxed);
+    while (other_min < current_min &&
+           !min_value.compare_exchange_weak(current_min, other_min, std::memory_order_relaxed))
+    {
+    }
+
+    const uint32_t other_max = other.max_value.load(std::memory_order_relaxed);
+    uint32_t current_max = max_value.load(std::memory_order_relaxed);
+    while (other_max > current_max &&
+           !max_value.compare_exchange_weak(current_max, other_max, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::copy_from(const LatencyHistogram& other)
+{
+    reset();
+    merge(other);
+}
+
+void LatencyHistogram::reset()
+{
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+
+    total_count.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    min_value.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::get_count() const
+{
+    return total_count.load(std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::get_min() const
+{
+    return get_count() != 0 ?
+                min_value.load(std::memory_order_relaxed) :
+                0;
+}
+
+uint32_t LatencyHistogram::get_max() const
+{
+    return max_value.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::get_mean() const
+{
+    const uint64_t count = get_count();
+    return count != 0 ?
+                static_cast<double>(total_sum.load(std::memory_order_relaxed)) / count :
+                0.0;
+}
+
+uint32_t LatencyHistogram::get_value_at_percentile(const double percentile) const
+{
+    const uint64_t count = get_count();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Determine the number of values at or below the requested percentile
+    const double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    uint64_t target = static_cast<uint64_t>(std::ceil(clamped / 100.0 * count));
+    if (target == 0)
+    {
+        target = 1;
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        if (cumulative >= target)
+        {
+            const uint32_t highest = highest_value_for_bucket(i);
+            const uint32_t max = get_max();
+            return highest < max ? highest : max;
+        }
+    }
+
+    return get_max();
+}
+
+uint64_t LatencyHistogram::get_bucket_count(const size_t bucket) const
+{
+    return bucket < BUCKET_COUNT ?
+                buckets[bucket].load(std::memory_order_relaxed) :
+                0;
+}
+
+void LatencyHistogram::write_buckets(std::ostream& stream) const
+{
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        const uint32_t count = buckets[i].load(std::memory_order_relaxed);
+        if (count != 0)
+        {
+            stream << lowest_value_for_bucket(i) << ',' << highest_value_for_bucket(i) << ',' << count << '\n';
+        }
+    }
+}
+
+size_t LatencyHistogram::bucket_for_value(const uint32_t value)
+{
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return value;
+    }
+
+    // Find the most significant bit of the value
+    size_t msb = 0;
+    uint32_t remaining = value;
+    for (size_t step = 16; step > 0; step >>= 1)
+    {
+        if (remaining >= (static_cast<uint32_t>(1) << step))
+        {
+            remaining >>= step;
+            msb += step;
+        }
+    }
+
+    // Keep the bits below the most significant bit as the sub-bucket
+    const size_t shift = msb - SUB_BUCKET_BITS;
+    const size_t sub_bucket = (value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return (shift + 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+uint32_t LatencyHistogram::lowest_value_for_bucket(const size_t bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(bucket);
+    }
+
+    const size_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    const size_t sub_bucket = bucket % SUB_BUCKET_COUNT;
+    return static_cast<uint32_t>(SUB_BUCKET_COUNT + sub_bucket) << shift;
+}
+
+uint32_t LatencyHistogram::highest_value_for_bucket(const size_t bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(bucket);
+    }
+
+    const size_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    return lowest_value_for_bucket(bucket) + ((static_cast<uint32_t>(1) << shift) - 1);
+}
+
+ClockOffsetEstimator::ClockOffsetEstimator()
+{
+    reset();
+}
+
+void ClockOffsetEstimator::add_sample(
+        const timestamp_t sender_time,
+        const timestamp_t local_time)
+{
+    const int32_t offset = static_cast<int32_t>(local_time - sender_time);
+    const uint8_t state = sample_state.load(std::memory_order_relaxed);
+
+    if (state == 0)
+    {
+        current_min.store(offset, std::memory_order_relaxed);
+        window_start.store(local_time, std::memory_order_relaxed);
+        sample_state.store(1, std::memory_order_relaxed);
+    }
+    else if (local_time - window_start.load(std::memory_order_relaxed) >= WINDOW_MILLIS)
+    {
+        // Start a new window, keeping the previous minimum until the new window is complete
+        previous_min.store(current_min.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        current_min.store(offset, std::memory_order_relaxed);
+        window_start.store(local_time, std::memory_order_relaxed);
+        sample_state.store(2, std::memory_order_relaxed);
+    }
+    else if (offset < current_min.load(std::memory_order_relaxed))
+    {
+        current_min.store(offset, std::memory_order_relaxed);
+    }
+}
+
+bool ClockOffsetEstimator::has_estimate() const
+{
+    return sample_state.load(std::memory_order_relaxed) != 0;
+}
+
+int32_t ClockOffsetEstimator::get_offset() const
+{
+    const int32_t current = current_min.load(std::memory_order_relaxed);
+    if (sample_state.load(std::memory_order_relaxed) == 2)
+    {
+        const int32_t previous = previous_min.load(std::memory_order_relaxed);
+        return previous < current ? previous : current;
+    }
+    else
+    {
+        return current;
+    }
+}
+
+uint32_t ClockOffsetEstimator::get_latency(
+        const timestamp_t sender_time,
+        const timestamp_t local_time) const
+{
+    const int32_t offset = static_cast<int32_t>(local_time - sender_time);
+    const int64_t latency = static_cast<int64_t>(offset) - get_offset();
+    return latency > 0 ?
+                static_cast<uint32_t>(latency) :
+                0;
+}
+
+void ClockOffsetEstimator::reset()
+{
+    current_min.store(0, std::memory_order_relaxed);
+    previous_min.store(0, std::memory_order_relaxed);
+    window_start.store(0, std::memory_order_relaxed);
+    sample_state.store(0, std::memory_order_relaxed);
+}
+
+SignalLatency::SignalLatency() :
+    signal_slot_count(0),
+    enabled(false)
+{
+    // Empty Constructor
+}
+
+void SignalLatency::init(
+        const uint16_t* signal_indices,
+        const size_t signal_count)
+{
+    entries.reset(new Entry[signal_count]);
+    signal_slots.reset(new uint16_t[SignalDef::MAX_SIGNAL_COUNT]);
+    signal_slot_indices.reset(new uint16_t[signal_count]);
+    signal_slot_count = signal_count;
+
+    for (size_t i = 0; i < SignalDef::MAX_SIGNAL_COUNT; ++i)
+    {
+        signal_slots[i] = NO_SLOT;
+    }
+
+    for (size_t i = 0; i < signal_count; ++i)
+    {
+        entries[i].consumed_update.store(0, std::memory_order_relaxed);
+        signal_slots[signal_indices[i]] = static_cast<uint16_t>(i);
+        signal_slot_indices[i] = signal_indices[i];
+    }
+}
+
+void SignalLatency::set_enabled(const bool enabled)
+{
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SignalLatency::reset()
+{
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        entries[i].transit.reset();
+        entries[i].dwell.reset();
+        entries[i].consumed_update.store(0, std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        clock_offsets[i].reset();
+    }
+}
+
+void SignalLatency::record_transit(
+        const size_t signal_index,
+        const uint8_t from_device,
+        const timestamp_t sender_time,
+        const timestamp_t local_time)
+{
+    if (!is_enabled())
+    {
+        return;
+    }
+
+    // Update the clock estimate before measuring, so that a new fastest path provides zero latency
+    ClockOffsetEstimator& clock_offset = clock_offsets[from_device];
+    clock_offset.add_sample(sender_time, local_time);
+
+    Entry* entry = entry_for(signal_index);
+    if (entry != nullptr)
+    {
+        entry->transit.record(clock_offset.get_latency(sender_time, local_time));
+    }
+}
+
+void SignalLatency::record_consumed(
+        const size_t signal_index,
+        const timestamp_t updated_time,
+        const timestamp_t local_time)
+{
+    if (!is_enabled())
+    {
+        return;
+    }
+
+    Entry* entry = entry_for(signal_index);
+    if (entry == nullptr)
+    {
+        return;
+    }
+
+    // Only record the first read of each stored value. The exchange claims the value
+    // so that concurrent readers do not record it twice
+    const uint64_t consumed_update = CONSUMED_FLAG | updated_time;
+    if (entry->consumed_update.exchange(consumed_update, std::memory_order_relaxed) == consumed_update)
+    {
+        return;
+    }
+
+    entry->dwell.record(local_time - updated_time);
+}
+
+const LatencyHistogram* SignalLatency::get_transit_histogram(const size_t signal_index) const
+{
+    const Entry* entry = entry_for(signal_index);
+    return entry != nullptr ? &entry->transit : nullptr;
+}
+
+const LatencyHistogram* SignalLatency::get_dwell_histogram(const size_t signal_index) const
+{
+    const Entry* entry = entry_for(signal_index);
+    return entry != nullptr ? &entry->dwell : nullptr;
+}
+
+const ClockOffsetEstimator& SignalLatency::get_clock_offset(const uint8_t from_device) const
+{
+    return clock_offsets[from_device];
+}
+
+void SignalLatency::merge_transit(LatencyHistogram& histogram) const
+{
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        histogram.merge(entries[i].transit);
+    }
+}
+
+void SignalLatency::merge_dwell(LatencyHistogram& histogram) const
+{
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        histogram.merge(entries[i].dwell);
+    }
+}
+
+void SignalLatency::dump(std::ostream& stream) const
+{
+    const std::ios::fmtflags flags = stream.flags();
+
+    stream << std::left << std::setw(24) << "name"
+           << std::setw(8) << "kind" << std::right
+           << std::setw(10) << "count"
+           << std::setw(8) << "min"
+           << std::setw(8) << "p50"
+           << std::setw(8) << "p90"
+           << std::setw(8) << "p99"
+           << std::setw(8) << "max" << '\n';
+
+    auto write_row = [&stream](const std::string& name, const char* kind, const LatencyHistogram& histogram)
+    {
+        if (histogram.get_count() == 0)
+        {
+            return;
+        }
+
+        stream << std::left << std::setw(24) << name
+               << std::setw(8) << kind << std::right
+               << std::setw(10) << histogram.get_count()
+               << std::setw(8) << histogram.get_min()
+               << std::setw(8) << histogram.get_value_at_percentile(50.0)
+               << std::setw(8) << histogram.get_value_at_percentile(90.0)
+               << std::setw(8) << histogram.get_value_at_percentile(99.0)
+               << std::setw(8) << histogram.get_max() << '\n';
+    };
+
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        const std::string name = get_signal_name(signal_slot_indices[i]);
+        write_row(name, "transit", entries[i].transit);
+        write_row(name, "dwell", entries[i].dwell);
+    }
+
+    stream.flags(flags);
+}
+
+void SignalLatency::write_csv(std::ostream& stream) const
+{
+    stream << "name,kind,low,high,count\n";
+
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        const std::string name = get_signal_name(signal_slot_indices[i]);
+        const LatencyHistogram* histograms[] = { &entries[i].transit, &entries[i].dwell };
+        const char* kinds[] = { "transit", "dwell" };
+
+        for (size_t h = 0; h < 2; ++h)
+        {
+            for (size_t b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b)
+            {
+                const uint64_t count = histograms[h]->get_bucket_count(b);
+                if (count != 0)
+                {
+                    stream << name << ',' << kinds[h] << ','
+                           << LatencyHistogram::lowest_value_for_bucket(b) << ','
+                           << LatencyHistogram::highest_value_for_bucket(b) << ','
+                           << count << '\n';
+                }
+            }
+        }
+    }
+}
+
+SignalLatency::Entry* SignalLatency::entry_for(const size_t signal_index) const
+{
+    if (signal_index >= SignalDef::MAX_SIGNAL_COUNT ||
+            signal_slots == nullptr ||
+            signal_slots[signal_index] == NO_SLOT)
+    {
+        return nullptr;
+    }
+    else
+    {
+        return &entries[signal_slots[signal_index]];
+    }
+}
+
+std::string SignalLatency::get_signal_name(const uint16_t signal_index)
+{
+    SignalDef signal_def;
+    std::string name;
+    if (!get_signal_for_cat_sub_id(
+                static_cast<uint8_t>(signal_index >> 8),
+                static_cast<uint8_t>(signal_index & 0xFF),
+                signal_def) ||
+            !get_signal_name_for_def(signal_def, name))
+    {
+        name = "signal_" + std::to_string(signal_index);
+    }
+
+    return name;
+}
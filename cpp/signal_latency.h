@@ -0,0 +1,450 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_LATENCY_H
+#define TF_SIGNAL_LATENCY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "signal_def.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The LatencyHistogram class provides a log-bucketed histogram of latency
+ * values. Each power of two is split into SUB_BUCKET_COUNT linear buckets, so
+ * that every bucket has a relative width of at most 1 / SUB_BUCKET_COUNT. Values
+ * may be recorded concurrently from multiple threads without locking
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @brief LatencyHistogram constructs an empty histogram
+     */
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief record adds a value to the histogram
+     * @param value is the value to record
+     */
+    void record(const uint32_t value);
+
+    /**
+     * @brief merge adds the counts of another histogram into this histogram
+     * @param other is the histogram to merge
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief copy_from replaces the counts of this histogram with those of another
+     * @param other is the histogram to copy
+     */
+    void copy_from(const LatencyHistogram& other);
+
+    /**
+     * @brief reset clears all counts in the histogram
+     */
+    void reset();
+
+    /**
+     * @brief get_count provides the number of values recorded
+     * @return the number of recorded values
+     */
+    uint64_t get_count() const;
+
+    /**
+     * @brief get_min provides the smallest recorded value
+     * @return the smallest value, or 0 if no values are recorded
+     */
+    uint32_t get_min() const;
+
+    /**
+     * @brief get_max provides the largest recorded value
+     * @return the largest value, or 0 if no values are recorded
+     */
+    uint32_t get_max() const;
+
+    /**
+     * @brief get_mean provides the mean of the recorded values
+     * @return the mean value, or 0 if no values are recorded
+     */
+    double get_mean() const;
+
+    /**
+     * @brief get_value_at_percentile provides the highest value equivalent to the
+     * bucket containing the requested percentile
+     * @param percentile is the percentile to find, from 0 to 100
+     * @return the value at the percentile, or 0 if no values are recorded
+     */
+    uint32_t get_value_at_percentile(const double percentile) const;
+
+    /**
+     * @brief get_bucket_count provides the count within a single bucket
+     * @param bucket is the bucket index, less than BUCKET_COUNT
+     * @return the number of values recorded in the bucket
+     */
+    uint64_t get_bucket_count(const size_t bucket) const;
+
+    /**
+     * @brief write_buckets writes a CSV line for each non-empty bucket, with the
+     * lowest value, highest value and count of the bucket
+     * @param stream is the stream to write to
+     */
+    void write_buckets(std::ostream& stream) const;
+
+    /**
+     * @brief bucket_for_value provides the bucket index for a value
+     * @param value is the value to find the bucket for
+     * @return the bucket index
+     */
+    static size_t bucket_for_value(const uint32_t value);
+
+    /**
+     * @brief lowest_value_for_bucket provides the smallest value stored in a bucket
+     * @param bucket is the bucket index
+     * @return the smallest value of the bucket
+     */
+    static uint32_t lowest_value_for_bucket(const size_t bucket);
+
+    /**
+     * @brief highest_value_for_bucket provides the largest value stored in a bucket
+     * @param bucket is the bucket index
+     * @return the largest value of the bucket
+     */
+    static uint32_t highest_value_for_bucket(const size_t bucket);
+
+    /**
+     * @brief SUB_BUCKET_BITS provides the number of bits of each value kept in the bucket
+     */
+    static const size_t SUB_BUCKET_BITS = 3;
+
+    /**
+     * @brief SUB_BUCKET_COUNT provides the number of linear buckets for each power of two
+     */
+    static const size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+    /**
+     * @brief BUCKET_COUNT provides the number of buckets needed to cover every 32-bit value
+     */
+    static const size_t BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+protected:
+    /**
+     * @brief buckets provides the count of values in each bucket
+     */
+    std::atomic<uint32_t> buckets[BUCKET_COUNT];
+
+    /**
+     * @brief total_count provides the number of values recorded
+     */
+    std::atomic<uint64_t> total_count;
+
+    /**
+     * @brief total_sum provides the sum of the values recorded
+     */
+    std::atomic<uint64_t> total_sum;
+
+    /**
+     * @brief min_value provides the smallest value recorded
+     */
+    std::atomic<uint32_t> min_value;
+
+    /**
+     * @brief max_value provides the largest value recorded
+     */
+    std::atomic<uint32_t> max_value;
+};
+
+/**
+ * @brief The ClockOffsetEstimator class estimates the offset between the local
+ * clock and the clock of a remote device, as the smallest observed difference
+ * between the local receive time and the sender timestamp. The smallest
+ * difference corresponds to the fastest path through the network, and so
+ * latencies derived from the offset are relative to the fastest observed
+ * delivery. The minimum is kept over two rolling windows so that clock drift
+ * and device restarts are followed
+ */
+class ClockOffsetEstimator
+{
+public:
+    /**
+     * @brief ClockOffsetEstimator constructs an estimator with no samples
+     */
+    ClockOffsetEstimator();
+
+    /**
+     * @brief add_sample adds an observation of the remote clock
+     * @param sender_time is the timestamp provided by the remote device
+     * @param local_time is the local time the timestamp was received
+     */
+    void add_sample(
+            const timestamp_t sender_time,
+            const timestamp_t local_time);
+
+    /**
+     * @brief has_estimate determines if an offset has been estimated
+     * @return true if at least one sample has been added
+     */
+    bool has_estimate() const;
+
+    /**
+     * @brief get_offset provides the estimated local time minus the remote time
+     * @return the offset estimate in milliseconds
+     */
+    int32_t get_offset() const;
+
+    /**
+     * @brief get_latency provides the latency of a sample, relative to the offset estimate
+     * @param sender_time is the timestamp provided by the remote device
+     * @param local_time is the local time the timestamp was received
+     * @return the latency in milliseconds, or 0 if earlier than the estimate
+     */
+    uint32_t get_latency(
+            const timestamp_t sender_time,
+            const timestamp_t local_time) const;
+
+    /**
+     * @brief reset clears the estimate
+     */
+    void reset();
+
+    /**
+     * @brief WINDOW_MILLIS provides the length of each minimum window
+     */
+    static const timestamp_t WINDOW_MILLIS = 10000;
+
+protected:
+    /**
+     * @brief current_min provides the smallest offset within the current window
+     */
+    std::atomic<int32_t> current_min;
+
+    /**
+     * @brief previous_min provides the smallest offset within the previous window
+     */
+    std::atomic<int32_t> previous_min;
+
+    /**
+     * @brief window_start provides the local time the current window started
+     */
+    std::atomic<timestamp_t> window_start;
+
+    /**
+     * @brief sample_state is 0 before any sample, 1 within the first window and 2 once
+     * the previous window is valid
+     */
+    std::atomic<uint8_t> sample_state;
+};
+
+/**
+ * @brief The SignalLatency class provides the latency histograms for each signal
+ * in the database. The transit histogram records the time from the sender
+ * timestamp to the local receive time, using a clock offset estimate for each
+ * source device. The dwell histogram records the time from a value being stored
+ * in the database until it is consumed by a reader
+ */
+class SignalLatency
+{
+public:
+    /**
+     * @brief SignalLatency constructs disabled latency tracking with no signals
+     */
+    SignalLatency();
+
+    /**
+     * @brief init allocates histograms for the provided signal indices
+     * @param signal_indices is the list of signal indices within the database
+     * @param signal_count is the number of signal indices
+     */
+    void init(
+            const uint16_t* signal_indices,
+            const size_t signal_count);
+
+    /**
+     * @brief set_enabled enables or disables recording of latency
+     * @param enabled is true to record latency
+     */
+    void set_enabled(const bool enabled);
+
+    /**
+     * @brief is_enabled determines if latency is being recorded
+     * @return true if latency is being recorded
+     */
+    bool is_enabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief reset clears all histograms and clock offset estimates
+     */
+    void reset();
+
+    /**
+     * @brief record_transit records the transit latency of a received signal
+     * @param signal_index is the signal index of the record
+     * @param from_device is the device the record was received from
+     * @param sender_time is the timestamp in the record header
+     * @param local_time is the local time the record was accepted
+     */
+    void record_transit(
+            const size_t signal_index,
+            const uint8_t from_device,
+            const timestamp_t sender_time,
+            const timestamp_t local_time);
+
+    /**
+     * @brief record_consumed records the dwell time of a value when consumed by a
+     * reader. Each stored value is recorded at most once
+     * @param signal_index is the signal index of the consumed value
+     * @param updated_time is the time the value was stored
+     * @param local_time is the local time the value was consumed
+     */
+    void record_consumed(
+            const size_t signal_index,
+            const timestamp_t updated_time,
+            const timestamp_t local_time);
+
+    /**
+     * @brief get_transit_histogram provides the transit histogram for a signal
+     * @param signal_index is the signal index
+     * @return the histogram, or nullptr if the signal has no histogram
+     */
+    const LatencyHistogram* get_transit_histogram(const size_t signal_index) const;
+
+    /**
+     * @brief get_dwell_histogram provides the dwell histogram for a signal
+     * @param signal_index is the signal index
+     * @return the histogram, or nullptr if the signal has no histogram
+     */
+    const LatencyHistogram* get_dwell_histogram(const size_t signal_index) const;
+
+    /**
+     * @brief get_clock_offset provides the clock offset estimate for a device
+     * @param from_device is the device to provide the estimate for
+     * @return the clock offset estimator
+     */
+    const ClockOffsetEstimator& get_clock_offset(const uint8_t from_device) const;
+
+    /**
+     * @brief merge_transit adds every signal transit histogram into a single histogram
+     * @param histogram is the histogram to merge into
+     */
+    void merge_transit(LatencyHistogram& histogram) const;
+
+    /**
+     * @brief merge_dwell adds every signal dwell histogram into a single histogram
+     * @param histogram is the histogram to merge into
+     */
+    void merge_dwell(LatencyHistogram& histogram) const;
+
+    /**
+     * @brief dump writes a text table of the latency percentiles of every signal with
+     * recorded values
+     * @param stream is the stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+    /**
+     * @brief write_csv writes the non-empty buckets of every histogram as CSV, with
+     * the signal name, histogram kind, bucket low value, bucket high value and count
+     * @param stream is the stream to write to
+     */
+    void write_csv(std::ostream& stream) const;
+
+    /**
+     * @brief NO_SLOT marks signal indices without histograms
+     */
+    static const uint16_t NO_SLOT = 0xFFFF;
+
+protected:
+    /**
+     * @brief The Entry struct provides the histograms for a single signal
+     */
+    struct Entry
+    {
+        LatencyHistogram transit;
+        LatencyHistogram dwell;
+        std::atomic<uint64_t> consumed_update;
+    };
+
+    /**
+     * @brief CONSUMED_FLAG marks consumed_update as holding the update time of a consumed value
+     */
+    static const uint64_t CONSUMED_FLAG = static_cast<uint64_t>(1) << 32;
+
+    /**
+     * @brief entry_for provides the histograms for a signal index
+     * @param signal_index is the signal index
+     * @return the entry, or nullptr if the signal has no histograms
+     */
+    Entry* entry_for(const size_t signal_index) const;
+
+    /**
+     * @brief get_signal_name provides the name of a signal index for output
+     * @param signal_index is the signal index
+     * @return the signal name
+     */
+    static std::string get_signal_name(const uint16_t signal_index);
+
+protected:
+    /**
+     * @brief entries provides the histograms for each signal slot
+     */
+    std::unique_ptr<Entry[]> entries;
+
+    /**
+     * @brief signal_slots maps each signal index to its histogram slot
+     */
+    std::unique_ptr<uint16_t[]> signal_slots;
+
+    /**
+     * @brief signal_slot_indices provides the signal index for each histogram slot
+     */
+    std::unique_ptr<uint16_t[]> signal_slot_indices;
+
+    /**
+     * @brief signal_slot_count provides the number of histogram slots
+     */
+    size_t signal_slot_count;
+
+    /**
+     * @brief clock_offsets provides the clock offset estimate for each source device
+     */
+    ClockOffsetEstimator clock_offsets[256];
+
+    /**
+     * @brief enabled is true if latency is being recorded
+     */
+    std::atomic<bool> enabled;
+};
+
+}
+
+#endif // TF_SIGNAL_LATENCY_H
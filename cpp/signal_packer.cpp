@@ -0,0 +1,347 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_packer.h"
+
+#include "signal_database.h"
+#include "signal_time.h"
+
+#include <algorithm>
+
+using namespace efis_signals;
+
+/**
+ * @brief The GroupChunk struct provides a run of signals from a single group
+ * that is placed into a frame as a whole
+ */
+struct GroupChunk
+{
+    /**
+     * @brief size provides the total record size of the signals in the chunk
+     */
+    size_t size;
+
+    /**
+     * @brief frame provides the frame assigned to the chunk
+     */
+    size_t frame;
+};
+
+FramePacker::FramePacker(
+        const size_t mtu,
+        const size_t reserved,
+        const WireFormat format) :
+    capacity(reserved < mtu ? mtu - reserved : 0),
+    format(format),
+    split_group_count(0)
+{
+    // Empty Constructor
+}
+
+bool FramePacker::add(const SignalDef& signal_def)
+{
+    return add(signal_def, signal_def.category_id);
+}
+
+bool FramePacker::add(
+        const SignalDef& signal_def,
+        const uint16_t group)
+{
+    SignalTypeBase* signal = nullptr;
+    if (added.test(signal_def.signal_index()) ||
+            !SignalDatabase::get_instance().get_signal(signal_def, &signal))
+    {
+        return false;
+    }
+
+    // Size the record as it would be sent now, so that compressed data signals
+    // are placed by their compressed size
+    const size_t payload_size = signal->encoded_packet_size();
+    const size_t record_size = SignalHeader::record_overhead(format, payload_size) + payload_size;
+    if (record_size > capacity)
+    {
+        return false;
+    }
+
+    PendingSignal pending_signal;
+    pending_signal.signal_index = static_cast<uint16_t>(signal_def.signal_index());
+    pending_signal.group = group;
+    pending_signal.record_size = record_size;
+    pending_signal.frame = 0;
+
+    pending.push_back(pending_signal);
+    added.set(signal_def.signal_index(), true);
+    return true;
+}
+
+size_t FramePacker::pack()
+{
+    frame_sizes.clear();
+    frame_starts.clear();
+    split_group_count = 0;
+
+    if (pending.empty())
+    {
+        return 0;
+    }
+
+    // Pack both by whole groups and by individual signals, keeping the group
+    // packing unless splitting groups saves a frame
+    std::vector<size_t> group_sizes;
+    const size_t group_frames = pack_groups(group_sizes);
+    const std::vector<PendingSignal> group_packing = pending;
+
+    std::vector<size_t> signal_sizes;
+    const size_t signal_frames = pack_signals(signal_sizes);
+
+    if (group_frames <= signal_frames)
+    {
+        pending = group_packing;
+        frame_sizes.swap(group_sizes);
+    }
+    else
+    {
+        frame_sizes.swap(signal_sizes);
+    }
+
+    // Order the signals by frame, keeping groups together within each frame
+    std::stable_sort(
+            pending.begin(),
+            pending.end(),
+            [](const PendingSignal& a, const PendingSignal& b)
+    {
+        return a.frame != b.frame ? a.frame < b.frame : a.group < b.group;
+    });
+
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        if (i == 0 || pending[i].frame != pending[i - 1].frame)
+        {
+            frame_starts.push_back(i);
+        }
+    }
+    frame_starts.push_back(pending.size());
+
+    // Count the groups that appear in more than one frame
+    std::vector<PendingSignal> by_group = pending;
+    std::stable_sort(
+            by_group.begin(),
+            by_group.end(),
+            [](const PendingSignal& a, const PendingSignal& b)
+    {
+        return a.group < b.group;
+    });
+
+    size_t group_start = 0;
+    for (size_t i = 1; i <= by_group.size(); ++i)
+    {
+        if (i == by_group.size() || by_group[i].group != by_group[group_start].group)
+        {
+            // The signals of a group are in frame order, so a split group ends in
+            // a different frame than it starts in
+            if (by_group[i - 1].frame != by_group[group_start].frame)
+            {
+                split_group_count += 1;
+            }
+            group_start = i;
+        }
+    }
+
+    return frame_sizes.size();
+}
+
+size_t FramePacker::get_frame_count() const
+{
+    return frame_sizes.size();
+}
+
+size_t FramePacker::get_frame_size(const size_t frame) const
+{
+    if (frame < frame_sizes.size())
+    {
+        return frame_sizes[frame];
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+size_t FramePacker::get_split_group_count() const
+{
+    return split_group_count;
+}
+
+bool FramePacker::write_frame(
+        const size_t frame,
+        DataWriter& writer) const
+{
+    if (frame >= frame_sizes.size())
+    {
+        return false;
+    }
+
+    const SignalDatabase& database = SignalDatabase::get_instance();
+    const timestamp_t now = get_millis();
+    for (size_t i = frame_starts[frame]; i < frame_starts[frame + 1]; ++i)
+    {
+        SignalTypeBase* signal = nullptr;
+        const size_t record_start = writer.bytes_written();
+        size_t payload_start = 0;
+        if (!database.get_signal_for_index(pending[i].signal_index, &signal))
+        {
+            return false;
+        }
+
+        const size_t payload_size = signal->encoded_packet_size();
+        if (!signal->get_header().write_record_start(writer, format, payload_size, payload_start) ||
+                !signal->serialize(writer) ||
+                !SignalHeader::write_record_end(writer, format, payload_size, payload_start))
+        {
+            // Remove the partial record, leaving the records already written intact
+            writer.truncate(record_start);
+            return false;
+        }
+
+        signal->set_transmitted(now);
+    }
+
+    return true;
+}
+
+void FramePacker::reset()
+{
+    // Clear only the pending signals, rather than the whole bitmap, as the packer
+    // is reset on every tick
+    for (const PendingSignal& signal : pending)
+    {
+        added.set(signal.signal_index, false);
+    }
+
+    pending.clear();
+    frame_sizes.clear();
+    frame_starts.clear();
+    split_group_count = 0;
+}
+
+size_t FramePacker::pack_groups(std::vector<size_t>& sizes)
+{
+    // Order the signals by group, largest records first within each group
+    std::stable_sort(
+            pending.begin(),
+            pending.end(),
+            [](const PendingSignal& a, const PendingSignal& b)
+    {
+        return a.group != b.group ? a.group < b.group : a.record_size > b.record_size;
+    });
+
+    // Divide each group into chunks that fit within a frame. Groups that fit are a
+    // single chunk, and larger groups are packed into as few chunks as possible.
+    // The chunk of each signal is held in the frame field until the chunks are placed
+    std::vector<GroupChunk> chunks;
+    size_t group_start = 0;
+    for (size_t i = 1; i <= pending.size(); ++i)
+    {
+        if (i == pending.size() || pending[i].group != pending[group_start].group)
+        {
+            std::vector<size_t> chunk_sizes;
+            for (size_t j = group_start; j < i; ++j)
+            {
+                pending[j].frame = chunks.size() + place(pending[j].record_size, chunk_sizes);
+            }
+
+            for (const size_t chunk_size : chunk_sizes)
+            {
+                GroupChunk chunk;
+                chunk.size = chunk_size;
+                chunk.frame = 0;
+                chunks.push_back(chunk);
+            }
+
+            group_start = i;
+        }
+    }
+
+    // Place the chunks into frames with first-fit decreasing
+    std::vector<size_t> chunk_order(chunks.size());
+    for (size_t i = 0; i < chunk_order.size(); ++i)
+    {
+        chunk_order[i] = i;
+    }
+
+    std::stable_sort(
+            chunk_order.begin(),
+            chunk_order.end(),
+            [&chunks](const size_t a, const size_t b)
+    {
+        return chunks[a].size > chunks[b].size;
+    });
+
+    sizes.clear();
+    for (const size_t index : chunk_order)
+    {
+        chunks[index].frame = place(chunks[index].size, sizes);
+    }
+
+    for (PendingSignal& signal : pending)
+    {
+        signal.frame = chunks[signal.frame].frame;
+    }
+
+    return sizes.size();
+}
+
+size_t FramePacker::pack_signals(std::vector<size_t>& sizes)
+{
+    // Place the largest records first, keeping signals of the same size and
+    // group together so that they tend to share a frame
+    std::stable_sort(
+            pending.begin(),
+            pending.end(),
+            [](const PendingSignal& a, const PendingSignal& b)
+    {
+        return a.record_size != b.record_size ? a.record_size > b.record_size : a.group < b.group;
+    });
+
+    sizes.clear();
+    for (PendingSignal& signal : pending)
+    {
+        signal.frame = place(signal.record_size, sizes);
+    }
+
+    return sizes.size();
+}
+
+size_t FramePacker::place(
+        const size_t size,
+        std::vector<size_t>& sizes) const
+{
+    size_t frame = 0;
+    while (frame < sizes.size() && sizes[frame] + size > capacity)
+    {
+        frame += 1;
+    }
+
+    if (frame == sizes.size())
+    {
+        sizes.push_back(0);
+    }
+
+    sizes[frame] += size;
+    return frame;
+}
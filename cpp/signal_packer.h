@@ -0,0 +1,214 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_PACKER_H
+#define TF_SIGNAL_PACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_writer.h"
+#include "signal_bitmap.h"
+#include "signal_def.h"
+#include "signal_header.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The FramePacker class assigns a set of pending signals to MTU-sized
+ * frames before they are sent. Signals are placed by their record size, the
+ * encoded packet size of the signal plus the header cost for the packer wire
+ * format, so that compressed data signals are placed by their compressed size.
+ * Signals are grouped by category, or by a provided group such as a display
+ * page, and each group is kept within a single frame where possible so that a
+ * lost datagram affects as few groups as possible. The number of frames is
+ * minimised first, and groups are only split across frames where keeping them
+ * together would require an additional frame
+ */
+class FramePacker
+{
+public:
+    /**
+     * @brief FramePacker constructs an empty frame packer
+     * @param mtu is the maximum number of bytes to write into a single frame
+     * @param reserved is the number of bytes to leave free in each frame, such as
+     * for a frame information record
+     * @param format is the wire format to write records with
+     */
+    FramePacker(
+            const size_t mtu,
+            const size_t reserved,
+            const WireFormat format);
+
+    /**
+     * @brief add adds a pending signal from the signal database, grouped with the
+     * other signals of the same category
+     * @param signal_def is the signal to add
+     * @return true if the signal is available, not already pending and fits within a single frame
+     */
+    bool add(const SignalDef& signal_def);
+
+    /**
+     * @brief add adds a pending signal from the signal database to the provided group
+     * @param signal_def is the signal to add
+     * @param group is the group to keep the signal with, such as a display page
+     * @return true if the signal is available, not already pending and fits within a single frame
+     */
+    bool add(
+            const SignalDef& signal_def,
+            const uint16_t group);
+
+    /**
+     * @brief pack assigns the pending signals to frames, replacing any previous packing
+     * @return the number of frames required
+     */
+    size_t pack();
+
+    /**
+     * @brief get_frame_count provides the number of frames from the last pack
+     * @return the number of frames
+     */
+    size_t get_frame_count() const;
+
+    /**
+     * @brief get_frame_size provides the number of bytes of records within a frame
+     * @param frame is the frame index, less than get_frame_count()
+     * @return the frame size in bytes, or zero if the frame does not exist
+     */
+    size_t get_frame_size(const size_t frame) const;
+
+    /**
+     * @brief get_split_group_count provides the number of groups from the last
+     * pack that were split across more than one frame
+     * @return the number of split groups
+     */
+    size_t get_split_group_count() const;
+
+    /**
+     * @brief write_frame writes the records of each signal assigned to a frame,
+     * marking each signal as transmitted. A record that fails to be written is
+     * removed from the writer and the remaining records are not written
+     * @param frame is the frame index, less than get_frame_count()
+     * @param writer is the writer to place the records into
+     * @return true if every record in the frame was written
+     */
+    bool write_frame(
+            const size_t frame,
+            DataWriter& writer) const;
+
+    /**
+     * @brief reset removes every pending signal and the last packing
+     */
+    void reset();
+
+protected:
+    /**
+     * @brief The PendingSignal struct provides a signal waiting to be packed
+     */
+    struct PendingSignal
+    {
+        /**
+         * @brief signal_index provides the index of the signal in the database
+         */
+        uint16_t signal_index;
+
+        /**
+         * @brief group provides the group to keep the signal with
+         */
+        uint16_t group;
+
+        /**
+         * @brief record_size provides the size of the record, including the header
+         */
+        size_t record_size;
+
+        /**
+         * @brief frame provides the frame assigned to the signal
+         */
+        size_t frame;
+    };
+
+    /**
+     * @brief pack_groups packs whole groups with first-fit decreasing, splitting
+     * only groups larger than a single frame
+     * @param sizes provides the resulting size of each frame
+     * @return the number of frames used
+     */
+    size_t pack_groups(std::vector<size_t>& sizes);
+
+    /**
+     * @brief pack_signals packs individual signals with first-fit decreasing,
+     * keeping signals of the same group adjacent where sizes are equal
+     * @param sizes provides the resulting size of each frame
+     * @return the number of frames used
+     */
+    size_t pack_signals(std::vector<size_t>& sizes);
+
+    /**
+     * @brief place adds a record or chunk to the first frame with enough space,
+     * adding a new frame if required
+     * @param size is the number of bytes to place
+     * @param sizes provides the current size of each frame
+     * @return the index of the frame used
+     */
+    size_t place(
+            const size_t size,
+            std::vector<size_t>& sizes) const;
+
+    /**
+     * @brief capacity provides the number of record bytes available in each frame
+     */
+    size_t capacity;
+
+    /**
+     * @brief format provides the wire format to write records with
+     */
+    WireFormat format;
+
+    /**
+     * @brief pending provides the signals to pack, ordered by frame once packed
+     */
+    std::vector<PendingSignal> pending;
+
+    /**
+     * @brief added provides the signals that are pending, to reject duplicates
+     */
+    SignalBitmap added;
+
+    /**
+     * @brief frame_sizes provides the size of each frame from the last pack
+     */
+    std::vector<size_t> frame_sizes;
+
+    /**
+     * @brief frame_starts provides the index of the first pending signal in each
+     * frame, along with a final entry for the end of the last frame
+     */
+    std::vector<size_t> frame_starts;
+
+    /**
+     * @brief split_group_count provides the number of groups split by the last pack
+     */
+    size_t split_group_count;
+};
+
+}
+
+#endif // TF_SIGNAL_PACKER_H
@@ -0,0 +1,250 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_rate_limit.h"
+
+#include <iomanip>
+
+using namespace efis_signals;
+
+TokenBucket::TokenBucket() :
+    tokens(0),
+    last_refill(0),
+    rate(0),
+    burst(0),
+    dropped_count(0),
+    started(false)
+{
+    // Empty Constructor
+}
+
+void TokenBucket::configure(
+        const uint32_t rate_per_second,
+        const uint32_t burst_size)
+{
+    rate = rate_per_second;
+    burst = burst_size > 0 ? burst_size : 1;
+    reset();
+}
+
+bool TokenBucket::try_consume(const timestamp_t now)
+{
+    if (!is_limited())
+    {
+        return true;
+    }
+
+    if (!started)
+    {
+        last_refill = now;
+        started = true;
+    }
+
+    // A rate of N tokens per second adds N thousandths of a token per millisecond
+    const uint64_t capacity = static_cast<uint64_t>(burst) * TOKEN_SCALE;
+    const uint32_t elapsed = now - last_refill;
+    if (elapsed > 0)
+    {
+        const uint64_t refilled = tokens + static_cast<uint64_t>(elapsed) * rate;
+        tokens = refilled < capacity ? refilled : capacity;
+        last_refill = now;
+    }
+
+    if (tokens >= TOKEN_SCALE)
+    {
+        tokens -= TOKEN_SCALE;
+        return true;
+    }
+    else
+    {
+        dropped_count += 1;
+        return false;
+    }
+}
+
+uint32_t TokenBucket::get_dropped_count() const
+{
+    return dropped_count;
+}
+
+uint32_t TokenBucket::get_rate() const
+{
+    return rate;
+}
+
+uint32_t TokenBucket::get_burst() const
+{
+    return burst;
+}
+
+void TokenBucket::reset()
+{
+    tokens = static_cast<uint64_t>(burst) * TOKEN_SCALE;
+    last_refill = 0;
+    dropped_count = 0;
+    started = false;
+}
+
+RateLimiter::RateLimiter() :
+    signal_bucket_count(0),
+    dropped_count(0)
+{
+    for (size_t i = 0; i < MAX_SIGNAL_LIMITS; ++i)
+    {
+        signal_bucket_indices[i] = 0;
+    }
+}
+
+void RateLimiter::set_device_limit(
+        const uint8_t device_id,
+        const uint32_t rate_per_second,
+        const uint32_t burst)
+{
+    device_buckets[device_id].configure(rate_per_second, burst);
+}
+
+bool RateLimiter::set_signal_limit(
+        const size_t signal_index,
+        const uint32_t rate_per_second,
+        const uint32_t burst)
+{
+    if (signal_index >= SignalDef::MAX_SIGNAL_COUNT)
+    {
+        return false;
+    }
+
+    if (signal_slots == nullptr)
+    {
+        signal_slots.reset(new uint8_t[SignalDef::MAX_SIGNAL_COUNT]);
+        for (size_t i = 0; i < SignalDef::MAX_SIGNAL_COUNT; ++i)
+        {
+            signal_slots[i] = NO_SLOT;
+        }
+    }
+
+    // Reuse the existing bucket if the signal already has a limit
+    uint8_t slot = signal_slots[signal_index];
+    if (slot == NO_SLOT)
+    {
+        if (signal_bucket_count >= MAX_SIGNAL_LIMITS)
+        {
+            return false;
+        }
+
+        slot = static_cast<uint8_t>(signal_bucket_count);
+        signal_bucket_indices[slot] = static_cast<uint16_t>(signal_index);
+        signal_slots[signal_index] = slot;
+        signal_bucket_count += 1;
+    }
+
+    signal_buckets[slot].configure(rate_per_second, burst);
+    return true;
+}
+
+const TokenBucket& RateLimiter::get_device_bucket(const uint8_t device_id) const
+{
+    return device_buckets[device_id];
+}
+
+const TokenBucket* RateLimiter::get_signal_bucket(const size_t signal_index) const
+{
+    if (signal_slots == nullptr ||
+            signal_index >= SignalDef::MAX_SIGNAL_COUNT ||
+            signal_slots[signal_index] == NO_SLOT)
+    {
+        return nullptr;
+    }
+    else
+    {
+        return &signal_buckets[signal_slots[signal_index]];
+    }
+}
+
+uint32_t RateLimiter::get_dropped_count() const
+{
+    return dropped_count;
+}
+
+void RateLimiter::reset()
+{
+    for (size_t i = 0; i < 256; ++i)
+    {
+        device_buckets[i].reset();
+    }
+
+    for (size_t i = 0; i < signal_bucket_count; ++i)
+    {
+        signal_buckets[i].reset();
+    }
+
+    dropped_count = 0;
+}
+
+void RateLimiter::dump(std::ostream& stream) const
+{
+    stream << std::left << std::setw(10) << "limit" << std::right
+           << std::setw(10) << "id"
+           << std::setw(10) << "rate"
+           << std::setw(10) << "burst"
+           << std::setw(10) << "dropped" << '\n';
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        const TokenBucket& bucket = device_buckets[i];
+        if (bucket.is_limited())
+        {
+            stream << std::left << std::setw(10) << "device" << std::right
+                   << std::setw(10) << i
+                   << std::setw(10) << bucket.get_rate()
+                   << std::setw(10) << bucket.get_burst()
+                   << std::setw(10) << bucket.get_dropped_count() << '\n';
+        }
+    }
+
+    for (size_t i = 0; i < signal_bucket_count; ++i)
+    {
+        const TokenBucket& bucket = signal_buckets[i];
+        if (bucket.is_limited())
+        {
+            stream << std::left << std::setw(10) << "signal" << std::right
+                   << std::setw(10) << signal_bucket_indices[i]
+                   << std::setw(10) << bucket.get_rate()
+                   << std::setw(10) << bucket.get_burst()
+                   << std::setw(10) << bucket.get_dropped_count() << '\n';
+        }
+    }
+
+    stream << "dropped " << dropped_count << '\n';
+}
+
+bool RateLimiter::consume(
+        const uint8_t device_id,
+        const uint8_t slot,
+        const timestamp_t now)
+{
+    const bool allowed =
+            device_buckets[device_id].try_consume(now) &&
+            (slot == NO_SLOT || signal_buckets[slot].try_consume(now));
+
+    if (!allowed)
+    {
+        dropped_count += 1;
+    }
+
+    return allowed;
+}
@@ -0,0 +1,282 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_RATE_LIMIT_H
+#define TF_SIGNAL_RATE_LIMIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include "signal_def.h"
+#include "signal_header.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The TokenBucket class provides a token bucket rate limit. Tokens are
+ * added at a fixed rate up to the burst size, and each allowed record takes
+ * a single token. Tokens are held in thousandths so that millisecond refills
+ * at low rates are not lost to rounding
+ */
+class TokenBucket
+{
+public:
+    /**
+     * @brief TokenBucket constructs an unlimited token bucket
+     */
+    TokenBucket();
+
+    /**
+     * @brief configure sets the rate limit, starting with a full bucket
+     * @param rate_per_second is the number of records allowed per second, or zero if unlimited
+     * @param burst_size is the number of records that may be allowed at once
+     */
+    void configure(
+            const uint32_t rate_per_second,
+            const uint32_t burst_size);
+
+    /**
+     * @brief is_limited determines if the bucket has a rate limit
+     * @return true if a rate limit is configured
+     */
+    bool is_limited() const
+    {
+        return rate > 0;
+    }
+
+    /**
+     * @brief try_consume refills the bucket for the elapsed time and takes a token
+     * @param now is the current time
+     * @return true if a token was available, or the bucket is unlimited
+     */
+    bool try_consume(const timestamp_t now);
+
+    /**
+     * @brief get_dropped_count provides the number of records refused by the bucket
+     * @return the dropped record count
+     */
+    uint32_t get_dropped_count() const;
+
+    /**
+     * @brief get_rate provides the configured rate
+     * @return the number of records allowed per second
+     */
+    uint32_t get_rate() const;
+
+    /**
+     * @brief get_burst provides the configured burst size
+     * @return the number of records that may be allowed at once
+     */
+    uint32_t get_burst() const;
+
+    /**
+     * @brief reset refills the bucket and clears the dropped record count
+     */
+    void reset();
+
+protected:
+    /**
+     * @brief TOKEN_SCALE provides the number of stored units for each token
+     */
+    static const uint64_t TOKEN_SCALE = 1000;
+
+    /**
+     * @brief tokens provides the available tokens, in thousandths
+     */
+    uint64_t tokens;
+
+    /**
+     * @brief last_refill provides the time the bucket was last refilled
+     */
+    timestamp_t last_refill;
+
+    /**
+     * @brief rate provides the number of tokens added per second
+     */
+    uint32_t rate;
+
+    /**
+     * @brief burst provides the maximum number of tokens held
+     */
+    uint32_t burst;
+
+    /**
+     * @brief dropped_count provides the number of records refused
+     */
+    uint32_t dropped_count;
+
+    /**
+     * @brief started is true once the first record has been checked, so that the
+     * first refill does not count the time since startup
+     */
+    bool started;
+};
+
+/**
+ * @brief The RateLimiter class provides receive rate limits for each source device
+ * and for individual signals, checked directly after the record header is read.
+ * A record must be allowed by both its device and signal limits, where configured,
+ * so that a looping or misbehaving source cannot use up the receive time budget
+ */
+class RateLimiter
+{
+public:
+    /**
+     * @brief MAX_SIGNAL_LIMITS provides the number of signals that may have a rate limit
+     */
+    static const size_t MAX_SIGNAL_LIMITS = 64;
+
+    /**
+     * @brief RateLimiter constructs a rate limiter without any limits
+     */
+    RateLimiter();
+
+    /**
+     * @brief set_device_limit sets the rate limit for records from a source device
+     * @param device_id is the device ID
+     * @param rate_per_second is the number of records allowed per second, or zero if unlimited
+     * @param burst is the number of records that may be allowed at once
+     */
+    void set_device_limit(
+            const uint8_t device_id,
+            const uint32_t rate_per_second,
+            const uint32_t burst);
+
+    /**
+     * @brief set_signal_limit sets the rate limit for records of a signal, from any device
+     * @param signal_index is the signal index
+     * @param rate_per_second is the number of records allowed per second, or zero if unlimited
+     * @param burst is the number of records that may be allowed at once
+     * @return true if the limit was set, or false if MAX_SIGNAL_LIMITS has been reached
+     */
+    bool set_signal_limit(
+            const size_t signal_index,
+            const uint32_t rate_per_second,
+            const uint32_t burst);
+
+    /**
+     * @brief is_allowed determines if a received record is within its rate limits,
+     * taking a token from each bucket that applies. The clock is only read for
+     * records that have a rate limit
+     * @param header is the record header
+     * @return true if the record is allowed
+     */
+    bool is_allowed(const SignalHeader& header)
+    {
+        const size_t signal_index = (static_cast<size_t>(header.cat_id) << 8) | header.sub_id;
+        const uint8_t slot = signal_slots != nullptr ? signal_slots[signal_index] : NO_SLOT;
+
+        if (!device_buckets[header.from_device].is_limited() && slot == NO_SLOT)
+        {
+            return true;
+        }
+        else
+        {
+            return consume(header.from_device, slot, get_millis());
+        }
+    }
+
+    /**
+     * @brief get_device_bucket provides the rate limit for a source device
+     * @param device_id is the device ID
+     * @return the device token bucket
+     */
+    const TokenBucket& get_device_bucket(const uint8_t device_id) const;
+
+    /**
+     * @brief get_signal_bucket provides the rate limit for a signal
+     * @param signal_index is the signal index
+     * @return the signal token bucket, or nullptr if the signal is not limited
+     */
+    const TokenBucket* get_signal_bucket(const size_t signal_index) const;
+
+    /**
+     * @brief get_dropped_count provides the total number of records dropped
+     * @return the dropped record count
+     */
+    uint32_t get_dropped_count() const;
+
+    /**
+     * @brief reset refills every bucket and clears the dropped record counts,
+     * keeping the configured limits
+     */
+    void reset();
+
+    /**
+     * @brief dump writes the configured limits and dropped record counts
+     * @param stream is the output stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+protected:
+    /**
+     * @brief NO_SLOT provides the slot value for signals without a rate limit
+     */
+    static const uint8_t NO_SLOT = 0xFF;
+
+    /**
+     * @brief consume takes a token from the device and signal buckets
+     * @param device_id is the source device ID
+     * @param slot is the signal bucket slot, or NO_SLOT
+     * @param now is the current time
+     * @return true if the record is allowed
+     */
+    bool consume(
+            const uint8_t device_id,
+            const uint8_t slot,
+            const timestamp_t now);
+
+    /**
+     * @brief device_buckets provides the rate limit for each source device
+     */
+    TokenBucket device_buckets[256];
+
+    /**
+     * @brief signal_buckets provides the rate limits for limited signals
+     */
+    TokenBucket signal_buckets[MAX_SIGNAL_LIMITS];
+
+    /**
+     * @brief signal_bucket_indices provides the signal index for each signal bucket
+     */
+    uint16_t signal_bucket_indices[MAX_SIGNAL_LIMITS];
+
+    /**
+     * @brief signal_bucket_count provides the number of signal buckets in use
+     */
+    size_t signal_bucket_count;
+
+    /**
+     * @brief signal_slots maps each signal index to its signal bucket, allocated
+     * when the first signal limit is set
+     */
+    std::unique_ptr<uint8_t[]> signal_slots;
+
+    /**
+     * @brief dropped_count provides the total number of records dropped
+     */
+    uint32_t dropped_count;
+};
+
+}
+
+#endif // TF_SIGNAL_RATE_LIMIT_H
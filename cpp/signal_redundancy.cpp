@@ -0,0 +1,171 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_redundancy.h"
+
+#include "gen_signal_def.h"
+#include "signal_header.h"
+
+#include <iomanip>
+
+using namespace efis_signals;
+
+RedundancyManager::RedundancyManager()
+{
+    reset();
+}
+
+bool RedundancyManager::accept_frame(
+        const size_t network,
+        const DataReader& reader,
+        const timestamp_t now)
+{
+    if (network >= NETWORK_COUNT)
+    {
+        return false;
+    }
+
+    NetworkHealth& health = network_health[network];
+    health.received_count += 1;
+    health.last_receive_time = now;
+
+    uint8_t from_device = 0;
+    uint32_t sequence = 0;
+    if (!read_frame_sequence(reader, from_device, sequence))
+    {
+        health.unsequenced_count += 1;
+        return true;
+    }
+
+    network_sequences[network].update(from_device, sequence);
+
+    const SequenceResult result = merged_sequences.update(from_device, sequence);
+    if (result == SequenceResult::Duplicate || result == SequenceResult::Stale)
+    {
+        health.duplicate_count += 1;
+        return false;
+    }
+    else
+    {
+        health.first_count += 1;
+        return true;
+    }
+}
+
+const NetworkHealth& RedundancyManager::get_network_health(const size_t network) const
+{
+    return network_health[network < NETWORK_COUNT ? network : 0];
+}
+
+const SequenceTable& RedundancyManager::get_network_sequences(const size_t network) const
+{
+    return network_sequences[network < NETWORK_COUNT ? network : 0];
+}
+
+bool RedundancyManager::is_network_active(
+        const size_t network,
+        const timestamp_t now) const
+{
+    if (network >= NETWORK_COUNT)
+    {
+        return false;
+    }
+
+    const NetworkHealth& health = network_health[network];
+    return health.received_count > 0 &&
+            now - health.last_receive_time < NETWORK_TIMEOUT_MILLIS;
+}
+
+void RedundancyManager::reset()
+{
+    merged_sequences.reset();
+
+    for (size_t i = 0; i < NETWORK_COUNT; ++i)
+    {
+        network_sequences[i].reset();
+
+        NetworkHealth& health = network_health[i];
+        health.received_count = 0;
+        health.first_count = 0;
+        health.duplicate_count = 0;
+        health.unsequenced_count = 0;
+        health.last_receive_time = 0;
+    }
+}
+
+void RedundancyManager::dump(
+        std::ostream& stream,
+        const timestamp_t now) const
+{
+    stream << std::left << std::setw(10) << "network" << std::right
+           << std::setw(8) << "active"
+           << std::setw(10) << "received"
+           << std::setw(10) << "first"
+           << std::setw(11) << "duplicate"
+           << std::setw(13) << "unsequenced"
+           << std::setw(8) << "lost" << '\n';
+
+    for (size_t i = 0; i < NETWORK_COUNT; ++i)
+    {
+        // Sum the frames lost on this network across every sending device
+        uint32_t lost_count = 0;
+        for (size_t device = 0; device < 256; ++device)
+        {
+            lost_count += network_sequences[i].get_tracker(static_cast<uint8_t>(device)).get_lost_count();
+        }
+
+        const NetworkHealth& health = network_health[i];
+        stream << std::left << std::setw(10) << static_cast<char>('A' + i) << std::right
+               << std::setw(8) << (is_network_active(i, now) ? "yes" : "no")
+               << std::setw(10) << health.received_count
+               << std::setw(10) << health.first_count
+               << std::setw(11) << health.duplicate_count
+               << std::setw(13) << health.unsequenced_count
+               << std::setw(8) << lost_count << '\n';
+    }
+}
+
+bool RedundancyManager::read_frame_sequence(
+        DataReader reader,
+        uint8_t& from_device,
+        uint32_t& sequence)
+{
+    // The frame information header marks the wire format of the frame
+    SignalHeader header;
+    WireFormat format = WireFormat::V1;
+    if (!header.read_header(reader) ||
+            header.cat_id != SIGNAL_DEF_FRAME_INFO.category_id ||
+            header.sub_id != SIGNAL_DEF_FRAME_INFO.sub_id ||
+            !get_frame_info_format(header.priority, format))
+    {
+        return false;
+    }
+
+    DataReader payload_reader = reader;
+    if (format == WireFormat::V2 && !SignalHeader::read_record_payload(reader, payload_reader))
+    {
+        return false;
+    }
+    else if (!payload_reader.read_uint(sequence))
+    {
+        return false;
+    }
+
+    from_device = header.from_device;
+    return true;
+}
@@ -0,0 +1,180 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_REDUNDANCY_H
+#define TF_SIGNAL_REDUNDANCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "data_reader.h"
+#include "signal_sequence.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The NetworkHealth struct provides the receive counters for a single network
+ */
+struct NetworkHealth
+{
+    /**
+     * @brief received_count provides the number of frames received on the network
+     */
+    uint32_t received_count;
+
+    /**
+     * @brief first_count provides the number of frames where this network delivered the first copy
+     */
+    uint32_t first_count;
+
+    /**
+     * @brief duplicate_count provides the number of frames dropped as already received
+     */
+    uint32_t duplicate_count;
+
+    /**
+     * @brief unsequenced_count provides the number of frames without frame information,
+     * which cannot be checked for duplicates and are always accepted
+     */
+    uint32_t unsequenced_count;
+
+    /**
+     * @brief last_receive_time provides the time the last frame was received on the network
+     */
+    timestamp_t last_receive_time;
+};
+
+/**
+ * @brief The RedundancyManager class removes duplicate frames received over
+ * redundant networks before the frames are decoded. Each frame is identified
+ * by the sending device and the sequence number in the frame information
+ * record at the start of the frame. The first copy of each frame is accepted
+ * and any later copies are dropped, using the sequence window of the sending
+ * device. Sequence tracking is also kept for each network on its own, so that
+ * frames lost on a single network are visible even when the other network
+ * delivers them
+ */
+class RedundancyManager
+{
+public:
+    /**
+     * @brief RedundancyManager constructs a manager with no frames received
+     */
+    RedundancyManager();
+
+    /**
+     * @brief accept_frame determines if a received frame should be read into the
+     * database. The reader is not modified
+     * @param network is the index of the network the frame was received on
+     * @param reader is the reader positioned at the start of the frame
+     * @param now is the current time
+     * @return true if the frame is the first copy received and should be read
+     */
+    bool accept_frame(
+            const size_t network,
+            const DataReader& reader,
+            const timestamp_t now);
+
+    /**
+     * @brief get_network_health provides the receive counters for a network
+     * @param network is the index of the network
+     * @return the network receive counters
+     */
+    const NetworkHealth& get_network_health(const size_t network) const;
+
+    /**
+     * @brief get_network_sequences provides the sequence tracking for the frames
+     * received on a single network, including frames dropped as duplicates
+     * @param network is the index of the network
+     * @return the network sequence table
+     */
+    const SequenceTable& get_network_sequences(const size_t network) const;
+
+    /**
+     * @brief is_network_active determines if a frame has been received on the
+     * network within NETWORK_TIMEOUT_MILLIS
+     * @param network is the index of the network
+     * @param now is the current time
+     * @return true if the network is active
+     */
+    bool is_network_active(
+            const size_t network,
+            const timestamp_t now) const;
+
+    /**
+     * @brief reset clears all sequence tracking and counters
+     */
+    void reset();
+
+    /**
+     * @brief dump writes a text summary of the health of each network
+     * @param stream is the stream to write to
+     * @param now is the current time
+     */
+    void dump(
+            std::ostream& stream,
+            const timestamp_t now) const;
+
+    /**
+     * @brief NETWORK_COUNT provides the number of redundant networks
+     */
+    static const size_t NETWORK_COUNT = 2;
+
+    /**
+     * @brief NETWORK_TIMEOUT_MILLIS provides the time without frames after which a
+     * network is considered inactive
+     */
+    static const timestamp_t NETWORK_TIMEOUT_MILLIS = 500;
+
+protected:
+    /**
+     * @brief read_frame_sequence reads the frame information record at the start of a frame
+     * @param reader is the reader positioned at the start of the frame
+     * @param from_device stores the sending device
+     * @param sequence stores the frame sequence number
+     * @return true if the frame starts with a frame information record
+     */
+    static bool read_frame_sequence(
+            DataReader reader,
+            uint8_t& from_device,
+            uint32_t& sequence);
+
+protected:
+    /**
+     * @brief merged_sequences provides the sequence windows used to detect duplicates
+     * across every network
+     */
+    SequenceTable merged_sequences;
+
+    /**
+     * @brief network_sequences provides the sequence tracking for each network
+     */
+    SequenceTable network_sequences[NETWORK_COUNT];
+
+    /**
+     * @brief network_health provides the receive counters for each network
+     */
+    NetworkHealth network_health[NETWORK_COUNT];
+};
+
+}
+
+#endif // TF_SIGNAL_REDUNDANCY_H
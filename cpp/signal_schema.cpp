@@ -0,0 +1,203 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_schema.h"
+
+#include <iomanip>
+
+using namespace efis_signals;
+
+SchemaTranslator::SchemaTranslator() :
+    revision(nullptr)
+{
+    // Empty Constructor
+}
+
+void SchemaTranslator::set_revision(const SignalRevisionDef* revision)
+{
+    this->revision = revision;
+    changed.clear_all();
+
+    if (revision != nullptr)
+    {
+        for (size_t i = 0; i < revision->translation_count; ++i)
+        {
+            changed.set(revision->translations[i].from_index, true);
+        }
+    }
+}
+
+const SignalRevisionDef* SchemaTranslator::get_revision() const
+{
+    return revision;
+}
+
+const SignalTranslationDef* SchemaTranslator::find_translation(const size_t signal_index) const
+{
+    if (revision == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Translations are sorted by the older signal index
+    size_t lower = 0;
+    size_t upper = revision->translation_count;
+    while (lower < upper)
+    {
+        const size_t middle = lower + (upper - lower) / 2;
+        const SignalTranslationDef& translation = revision->translations[middle];
+
+        if (translation.from_index == signal_index)
+        {
+            return &translation;
+        }
+        else if (translation.from_index < signal_index)
+        {
+            lower = middle + 1;
+        }
+        else
+        {
+            upper = middle;
+        }
+    }
+
+    return nullptr;
+}
+
+SchemaTable::SchemaTable(
+        const uint32_t fingerprint,
+        const SignalRevisionDef* revisions,
+        const size_t revision_count) :
+    fingerprint(fingerprint),
+    revision_count(revisions != nullptr ? revision_count : 0)
+{
+    if (this->revision_count > 0)
+    {
+        translators.reset(new SchemaTranslator[this->revision_count]);
+        for (size_t i = 0; i < this->revision_count; ++i)
+        {
+            translators[i].set_revision(&revisions[i]);
+        }
+    }
+
+    reset();
+}
+
+bool SchemaTable::update(
+        const uint8_t from_device,
+        const uint32_t fingerprint)
+{
+    // Only resolve the fingerprint when it changes, which is normally only on the
+    // first frame from each device
+    if (device_fingerprints[from_device] == fingerprint)
+    {
+        return states[from_device] != SchemaState::Unknown;
+    }
+
+    device_fingerprints[from_device] = fingerprint;
+    device_translators[from_device] = 0;
+
+    if (fingerprint == this->fingerprint)
+    {
+        states[from_device] = SchemaState::Current;
+        return true;
+    }
+
+    for (size_t i = 0; i < revision_count; ++i)
+    {
+        if (translators[i].get_revision()->fingerprint == fingerprint)
+        {
+            states[from_device] = SchemaState::Translated;
+            device_translators[from_device] = i;
+            return true;
+        }
+    }
+
+    states[from_device] = SchemaState::Unknown;
+    return false;
+}
+
+SchemaState SchemaTable::get_state(const uint8_t from_device) const
+{
+    return states[from_device];
+}
+
+const SchemaTranslator* SchemaTable::get_translator(const uint8_t from_device) const
+{
+    if (states[from_device] == SchemaState::Translated)
+    {
+        return &translators[device_translators[from_device]];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+uint32_t SchemaTable::get_fingerprint(const uint8_t from_device) const
+{
+    return device_fingerprints[from_device];
+}
+
+size_t SchemaTable::get_revision_count() const
+{
+    return revision_count;
+}
+
+void SchemaTable::reset()
+{
+    for (size_t i = 0; i < DEVICE_COUNT; ++i)
+    {
+        states[i] = SchemaState::Current;
+        device_translators[i] = 0;
+        device_fingerprints[i] = fingerprint;
+    }
+}
+
+void SchemaTable::dump(std::ostream& stream) const
+{
+    stream << std::left << std::setw(10) << "device" << std::right
+           << std::setw(14) << "fingerprint"
+           << std::setw(12) << "state"
+           << std::setw(10) << "version" << '\n';
+
+    for (size_t i = 0; i < DEVICE_COUNT; ++i)
+    {
+        if (states[i] == SchemaState::Current)
+        {
+            continue;
+        }
+
+        const SchemaTranslator* translator = get_translator(static_cast<uint8_t>(i));
+        stream << std::left << std::setw(10) << i << std::right
+               << std::setw(6) << "0x" << std::hex << std::setfill('0') << std::setw(8) << device_fingerprints[i]
+               << std::dec << std::setfill(' ')
+               << std::setw(12) << (translator != nullptr ? "translated" : "unknown");
+
+        if (translator != nullptr)
+        {
+            stream << std::setw(10) << translator->get_revision()->version;
+        }
+        else
+        {
+            stream << std::setw(10) << "-";
+        }
+
+        stream << '\n';
+    }
+}
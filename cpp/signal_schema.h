@@ -0,0 +1,222 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_SCHEMA_H
+#define TF_SIGNAL_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include "signal_bitmap.h"
+#include "signal_def.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SchemaTranslator class provides the lookup of signal translations
+ * for an older signal list revision. Signals that are sent identically in both
+ * revisions are found with a single bitmap test
+ */
+class SchemaTranslator
+{
+public:
+    /**
+     * @brief SchemaTranslator constructs a translator without a revision
+     */
+    SchemaTranslator();
+
+    /**
+     * @brief set_revision sets the revision to translate from
+     * @param revision is the older signal list revision
+     */
+    void set_revision(const SignalRevisionDef* revision);
+
+    /**
+     * @brief get_revision provides the revision translated from
+     * @return the older signal list revision, or nullptr if not set
+     */
+    const SignalRevisionDef* get_revision() const;
+
+    /**
+     * @brief find provides the translation for a signal sent by the older revision
+     * @param signal_index is the signal index from the record header
+     * @return the translation, or nullptr if the signal is unchanged
+     */
+    inline const SignalTranslationDef* find(const size_t signal_index) const
+    {
+        if (!changed.test(signal_index))
+        {
+            return nullptr;
+        }
+        else
+        {
+            return find_translation(signal_index);
+        }
+    }
+
+protected:
+    /**
+     * @brief find_translation searches the translations of the revision for a signal
+     * @param signal_index is the signal index within the older revision
+     * @return the translation, or nullptr if not found
+     */
+    const SignalTranslationDef* find_translation(const size_t signal_index) const;
+
+    /**
+     * @brief revision provides the older signal list revision
+     */
+    const SignalRevisionDef* revision;
+
+    /**
+     * @brief changed provides the signal indices within the older revision that have translations
+     */
+    SignalBitmap changed;
+};
+
+/**
+ * @brief The SchemaState enum provides the signal list revision used by a device
+ */
+enum class SchemaState : uint8_t
+{
+    Current = 0,
+    Translated = 1,
+    Unknown = 2
+};
+
+/**
+ * @brief The SchemaTable class tracks the signal list fingerprint sent by each
+ * device in its frame information. The fingerprint is only resolved when it
+ * changes, so that records from devices using the current signal list need a
+ * single state check. Devices that have not sent a fingerprint are assumed to
+ * use the current signal list
+ */
+class SchemaTable
+{
+public:
+    /**
+     * @brief SchemaTable constructs the schema table
+     * @param fingerprint is the fingerprint of the current signal list
+     * @param revisions provides the older signal list revisions that can be translated
+     * @param revision_count is the number of older revisions
+     */
+    SchemaTable(
+            const uint32_t fingerprint,
+            const SignalRevisionDef* revisions,
+            const size_t revision_count);
+
+    /**
+     * @brief update records the signal list fingerprint sent by a device
+     * @param from_device is the device that sent the fingerprint
+     * @param fingerprint is the signal list fingerprint sent
+     * @return true if the fingerprint is the current signal list or a known revision
+     */
+    bool update(
+            const uint8_t from_device,
+            const uint32_t fingerprint);
+
+    /**
+     * @brief is_current determines if a device uses the current signal list
+     * @param from_device is the device to check
+     * @return true if records from the device need no translation
+     */
+    inline bool is_current(const uint8_t from_device) const
+    {
+        return states[from_device] == SchemaState::Current;
+    }
+
+    /**
+     * @brief get_state provides the signal list revision state of a device
+     * @param from_device is the device to check
+     * @return the revision state
+     */
+    SchemaState get_state(const uint8_t from_device) const;
+
+    /**
+     * @brief get_translator provides the translator for a device using an older revision
+     * @param from_device is the device to check
+     * @return the translator, or nullptr if the device is not in the translated state
+     */
+    const SchemaTranslator* get_translator(const uint8_t from_device) const;
+
+    /**
+     * @brief get_fingerprint provides the last signal list fingerprint sent by a device
+     * @param from_device is the device to check
+     * @return the last fingerprint, or the current fingerprint if none has been sent
+     */
+    uint32_t get_fingerprint(const uint8_t from_device) const;
+
+    /**
+     * @brief get_revision_count provides the number of older revisions that can be translated
+     * @return the number of older revisions
+     */
+    size_t get_revision_count() const;
+
+    /**
+     * @brief reset returns every device to the current signal list
+     */
+    void reset();
+
+    /**
+     * @brief dump writes the revision state of each device not using the current signal list
+     * @param stream is the stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+    /**
+     * @brief DEVICE_COUNT provides the number of device IDs tracked
+     */
+    static const size_t DEVICE_COUNT = 256;
+
+protected:
+    /**
+     * @brief fingerprint provides the fingerprint of the current signal list
+     */
+    uint32_t fingerprint;
+
+    /**
+     * @brief revision_count provides the number of older revisions
+     */
+    size_t revision_count;
+
+    /**
+     * @brief translators provides a translator for each older revision
+     */
+    std::unique_ptr<SchemaTranslator[]> translators;
+
+    /**
+     * @brief states provides the revision state of each device
+     */
+    SchemaState states[DEVICE_COUNT];
+
+    /**
+     * @brief device_translators provides the translator index of each device in the translated state
+     */
+    size_t device_translators[DEVICE_COUNT];
+
+    /**
+     * @brief device_fingerprints provides the last fingerprint sent by each device
+     */
+    uint32_t device_fingerprints[DEVICE_COUNT];
+};
+
+}
+
+#endif // TF_SIGNAL_SCHEMA_H
@@ -0,0 +1,198 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_sequence.h"
+
+#include <iomanip>
+
+using namespace efis_signals;
+
+SequenceTracker::SequenceTracker()
+{
+    reset();
+}
+
+SequenceResult SequenceTracker::update(const uint32_t sequence)
+{
+    received_count += 1;
+
+    if (!started)
+    {
+        restart(sequence);
+        return SequenceResult::New;
+    }
+
+    const int32_t distance = static_cast<int32_t>(sequence - highest);
+
+    if (distance > static_cast<int32_t>(RESET_DISTANCE) || distance < -static_cast<int32_t>(RESET_DISTANCE))
+    {
+        // Treat large jumps as a restart of the sending device
+        reset_count += 1;
+        restart(sequence);
+        return SequenceResult::Reset;
+    }
+    else if (distance > 0)
+    {
+        // Advance the window, counting the skipped sequence numbers as lost until received
+        const uint32_t advance = static_cast<uint32_t>(distance);
+        window = advance < WINDOW_SIZE ? (window << advance) | 1 : 1;
+        highest = sequence;
+        lost_count += advance - 1;
+        return SequenceResult::New;
+    }
+    else if (distance == 0)
+    {
+        duplicate_count += 1;
+        return SequenceResult::Duplicate;
+    }
+
+    const uint32_t age = static_cast<uint32_t>(-distance);
+    if (age >= WINDOW_SIZE)
+    {
+        stale_count += 1;
+        return SequenceResult::Stale;
+    }
+
+    const uint64_t bit = static_cast<uint64_t>(1) << age;
+    if ((window & bit) != 0)
+    {
+        duplicate_count += 1;
+        return SequenceResult::Duplicate;
+    }
+    else
+    {
+        // A late sequence number fills a gap that was counted as lost
+        window |= bit;
+        reordered_count += 1;
+        if (lost_count > 0)
+        {
+            lost_count -= 1;
+        }
+        return SequenceResult::Reordered;
+    }
+}
+
+void SequenceTracker::reset()
+{
+    window = 0;
+    highest = 0;
+    received_count = 0;
+    lost_count = 0;
+    reordered_count = 0;
+    duplicate_count = 0;
+    stale_count = 0;
+    reset_count = 0;
+    started = false;
+}
+
+void SequenceTracker::restart(const uint32_t sequence)
+{
+    window = 1;
+    highest = sequence;
+    started = true;
+}
+
+bool SequenceTracker::is_started() const
+{
+    return started;
+}
+
+uint32_t SequenceTracker::get_highest() const
+{
+    return highest;
+}
+
+uint32_t SequenceTracker::get_received_count() const
+{
+    return received_count;
+}
+
+uint32_t SequenceTracker::get_lost_count() const
+{
+    return lost_count;
+}
+
+uint32_t SequenceTracker::get_reordered_count() const
+{
+    return reordered_count;
+}
+
+uint32_t SequenceTracker::get_duplicate_count() const
+{
+    return duplicate_count;
+}
+
+uint32_t SequenceTracker::get_stale_count() const
+{
+    return stale_count;
+}
+
+uint32_t SequenceTracker::get_reset_count() const
+{
+    return reset_count;
+}
+
+SequenceResult SequenceTable::update(
+        const uint8_t from_device,
+        const uint32_t sequence)
+{
+    return trackers[from_device].update(sequence);
+}
+
+const SequenceTracker& SequenceTable::get_tracker(const uint8_t from_device) const
+{
+    return trackers[from_device];
+}
+
+void SequenceTable::reset()
+{
+    for (size_t i = 0; i < 256; ++i)
+    {
+        trackers[i].reset();
+    }
+}
+
+void SequenceTable::dump(std::ostream& stream) const
+{
+    stream << std::left << std::setw(10) << "device" << std::right
+           << std::setw(12) << "highest"
+           << std::setw(10) << "received"
+           << std::setw(10) << "lost"
+           << std::setw(11) << "reordered"
+           << std::setw(11) << "duplicate"
+           << std::setw(8) << "stale"
+           << std::setw(8) << "resets" << '\n';
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        const SequenceTracker& tracker = trackers[i];
+        if (!tracker.is_started())
+        {
+            continue;
+        }
+
+        stream << std::left << std::setw(10) << i << std::right
+               << std::setw(12) << tracker.get_highest()
+               << std::setw(10) << tracker.get_received_count()
+               << std::setw(10) << tracker.get_lost_count()
+               << std::setw(11) << tracker.get_reordered_count()
+               << std::setw(11) << tracker.get_duplicate_count()
+               << std::setw(8) << tracker.get_stale_count()
+               << std::setw(8) << tracker.get_reset_count() << '\n';
+    }
+}
@@ -0,0 +1,227 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_SEQUENCE_H
+#define TF_SIGNAL_SEQUENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SequenceResult enum provides the classification of a received sequence number
+ */
+enum class SequenceResult
+{
+    New = 0,
+    Reordered = 1,
+    Duplicate = 2,
+    Stale = 3,
+    Reset = 4
+};
+
+/**
+ * @brief The SequenceTracker class tracks the frame sequence numbers received
+ * from a single device. The most recent WINDOW_SIZE sequence numbers are kept
+ * in a bitmap, so that gaps, late arrivals and duplicates can be told apart
+ */
+class SequenceTracker
+{
+public:
+    /**
+     * @brief SequenceTracker constructs a tracker that has not received any sequence numbers
+     */
+    SequenceTracker();
+
+    /**
+     * @brief update adds a received sequence number to the tracker
+     * @param sequence is the received sequence number
+     * @return the classification of the sequence number
+     */
+    SequenceResult update(const uint32_t sequence);
+
+    /**
+     * @brief reset clears the tracker and its counters
+     */
+    void reset();
+
+    /**
+     * @brief is_started determines if any sequence number has been received
+     * @return true if a sequence number has been received
+     */
+    bool is_started() const;
+
+    /**
+     * @brief get_highest provides the newest sequence number received
+     * @return the newest sequence number
+     */
+    uint32_t get_highest() const;
+
+    /**
+     * @brief get_received_count provides the number of sequence numbers received,
+     * including duplicates
+     * @return the received count
+     */
+    uint32_t get_received_count() const;
+
+    /**
+     * @brief get_lost_count provides the number of sequence numbers skipped and not
+     * yet received
+     * @return the lost count
+     */
+    uint32_t get_lost_count() const;
+
+    /**
+     * @brief get_reordered_count provides the number of sequence numbers received
+     * after a newer sequence number
+     * @return the reordered count
+     */
+    uint32_t get_reordered_count() const;
+
+    /**
+     * @brief get_duplicate_count provides the number of sequence numbers received more than once
+     * @return the duplicate count
+     */
+    uint32_t get_duplicate_count() const;
+
+    /**
+     * @brief get_stale_count provides the number of sequence numbers too old to
+     * be checked against the window
+     * @return the stale count
+     */
+    uint32_t get_stale_count() const;
+
+    /**
+     * @brief get_reset_count provides the number of times tracking restarted after a
+     * large jump, such as a device restart
+     * @return the reset count
+     */
+    uint32_t get_reset_count() const;
+
+    /**
+     * @brief WINDOW_SIZE provides the number of recent sequence numbers kept in the window
+     */
+    static const uint32_t WINDOW_SIZE = 64;
+
+    /**
+     * @brief RESET_DISTANCE provides the jump in sequence number beyond which tracking restarts
+     */
+    static const uint32_t RESET_DISTANCE = 4096;
+
+protected:
+    /**
+     * @brief restart restarts tracking from the provided sequence number
+     * @param sequence is the sequence number to restart from
+     */
+    void restart(const uint32_t sequence);
+
+protected:
+    /**
+     * @brief window provides the received state of recent sequence numbers, where
+     * bit i is set if sequence number highest - i has been received
+     */
+    uint64_t window;
+
+    /**
+     * @brief highest provides the newest sequence number received
+     */
+    uint32_t highest;
+
+    /**
+     * @brief received_count provides the number of sequence numbers received
+     */
+    uint32_t received_count;
+
+    /**
+     * @brief lost_count provides the number of sequence numbers skipped and not yet received
+     */
+    uint32_t lost_count;
+
+    /**
+     * @brief reordered_count provides the number of late sequence numbers
+     */
+    uint32_t reordered_count;
+
+    /**
+     * @brief duplicate_count provides the number of repeated sequence numbers
+     */
+    uint32_t duplicate_count;
+
+    /**
+     * @brief stale_count provides the number of sequence numbers older than the window
+     */
+    uint32_t stale_count;
+
+    /**
+     * @brief reset_count provides the number of tracking restarts
+     */
+    uint32_t reset_count;
+
+    /**
+     * @brief started is true once a sequence number has been received
+     */
+    bool started;
+};
+
+/**
+ * @brief The SequenceTable class provides a sequence tracker for every device ID
+ */
+class SequenceTable
+{
+public:
+    /**
+     * @brief update adds a received sequence number for a device
+     * @param from_device is the device the sequence number was received from
+     * @param sequence is the received sequence number
+     * @return the classification of the sequence number
+     */
+    SequenceResult update(
+            const uint8_t from_device,
+            const uint32_t sequence);
+
+    /**
+     * @brief get_tracker provides the tracker for a device
+     * @param from_device is the device to provide the tracker for
+     * @return the sequence tracker
+     */
+    const SequenceTracker& get_tracker(const uint8_t from_device) const;
+
+    /**
+     * @brief reset clears every tracker
+     */
+    void reset();
+
+    /**
+     * @brief dump writes a text table of every device that has sent a sequence number
+     * @param stream is the stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+protected:
+    /**
+     * @brief trackers provides the tracker for each device ID
+     */
+    SequenceTracker trackers[256];
+};
+
+}
+
+#endif // TF_SIGNAL_SEQUENCE_H
@@ -0,0 +1,291 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_statistics.h"
+
+#include "gen_signal_def.h"
+
+#include <new>
+#include <iomanip>
+#include <string>
+
+using namespace efis_signals;
+
+const char* efis_signals::get_reject_reason_name(const RejectReason reason)
+{
+    switch (reason)
+    {
+    case RejectReason::UnknownId:
+        return "unknown_id";
+    case RejectReason::ShortBuffer:
+        return "short_buffer";
+    case RejectReason::PriorityLoss:
+        return "priority_loss";
+    case RejectReason::DeserializeFailed:
+        return "deserialize_failed";
+    case RejectReason::FragmentRejected:
+        return "fragment_rejected";
+    case RejectReason::DeltaRejected:
+        return "delta_rejected";
+    case RejectReason::Filtered:
+        return "filtered";
+    case RejectReason::RateLimited:
+        return "rate_limited";
+    case RejectReason::SchemaMismatch:
+        return "schema_mismatch";
+    default:
+        return "unknown";
+    }
+}
+
+SignalStatistics::SignalStatistics() :
+    signal_counters(nullptr),
+    signal_slot_count(0),
+    pending_device(0),
+    pending_device_count(0),
+    pending_device_time(0),
+    header_errors(0),
+    enabled(false)
+{
+    for (size_t i = 0; i < 256; ++i)
+    {
+        clear_counters(device_counters[i]);
+    }
+
+    clear_counters(overflow_counters);
+}
+
+void SignalStatistics::init(
+        const uint16_t* signal_indices,
+        const size_t signal_count)
+{
+    // Allocate the counters with room to align the first block to a cache line
+    const size_t alignment = alignof(Counters);
+    signal_counter_storage.reset(new uint8_t[sizeof(Counters) * signal_count + alignment]);
+
+    const uintptr_t storage_address = reinterpret_cast<uintptr_t>(signal_counter_storage.get());
+    const uintptr_t aligned_address = (storage_address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    signal_counters = reinterpret_cast<Counters*>(aligned_address);
+
+    signal_slots.reset(new uint16_t[SignalDef::MAX_SIGNAL_COUNT]);
+    signal_slot_indices.reset(new uint16_t[signal_count]);
+    signal_slot_count = signal_count;
+
+    for (size_t i = 0; i < SignalDef::MAX_SIGNAL_COUNT; ++i)
+    {
+        signal_slots[i] = NO_SLOT;
+    }
+
+    for (size_t i = 0; i < signal_count; ++i)
+    {
+        new (&signal_counters[i]) Counters;
+        clear_counters(signal_counters[i]);
+        signal_slots[signal_indices[i]] = static_cast<uint16_t>(i);
+        signal_slot_indices[i] = signal_indices[i];
+    }
+}
+
+void SignalStatistics::set_enabled(const bool enabled)
+{
+    this->enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SignalStatistics::reset()
+{
+    for (size_t i = 0; i < 256; ++i)
+    {
+        clear_counters(device_counters[i]);
+    }
+
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        clear_counters(signal_counters[i]);
+    }
+
+    clear_counters(overflow_counters);
+    pending_device_count = 0;
+    header_errors.store(0, std::memory_order_relaxed);
+}
+
+bool SignalStatistics::get_signal_snapshot(
+        const size_t signal_index,
+        StatisticsSnapshot& snapshot) const
+{
+    if (signal_index >= SignalDef::MAX_SIGNAL_COUNT ||
+            signal_slots == nullptr ||
+            signal_slots[signal_index] == NO_SLOT)
+    {
+        return false;
+    }
+    else
+    {
+        fill_snapshot(signal_counters[signal_slots[signal_index]], snapshot);
+        return true;
+    }
+}
+
+void SignalStatistics::get_device_snapshot(
+        const uint8_t from_device,
+        StatisticsSnapshot& snapshot) const
+{
+    fill_snapshot(device_counters[from_device], snapshot);
+}
+
+uint32_t SignalStatistics::get_header_error_count() const
+{
+    return header_errors.load(std::memory_order_relaxed);
+}
+
+void SignalStatistics::dump(std::ostream& stream) const
+{
+    const std::ios::fmtflags flags = stream.flags();
+
+    stream << std::left << std::setw(24) << "name" << std::right
+           << std::setw(10) << "received"
+           << std::setw(10) << "accepted";
+    for (size_t r = 0; r < REJECT_REASON_COUNT; ++r)
+    {
+        stream << ' ' << get_reject_reason_name(static_cast<RejectReason>(r));
+    }
+    stream << std::setw(12) << "interval_ms"
+           << std::setw(10) << "rate_hz" << '\n';
+
+    auto write_row = [&stream](const std::string& name, const StatisticsSnapshot& snapshot)
+    {
+        stream << std::left << std::setw(24) << name << std::right
+               << std::setw(10) << snapshot.received
+               << std::setw(10) << snapshot.accepted;
+        for (size_t r = 0; r < REJECT_REASON_COUNT; ++r)
+        {
+            const std::string reason_name = get_reject_reason_name(static_cast<RejectReason>(r));
+            stream << std::setw(static_cast<int>(reason_name.size()) + 1) << snapshot.rejected[r];
+        }
+        stream << std::setw(12) << snapshot.last_interval_millis
+               << std::setw(10) << std::fixed << std::setprecision(1) << snapshot.rate_hz << '\n';
+    };
+
+    StatisticsSnapshot snapshot;
+
+    for (size_t i = 0; i < signal_slot_count; ++i)
+    {
+        fill_snapshot(signal_counters[i], snapshot);
+        if (snapshot.received == 0)
+        {
+            continue;
+        }
+
+        const uint16_t signal_index = signal_slot_indices[i];
+        SignalDef signal_def;
+        std::string name;
+        if (!get_signal_for_cat_sub_id(
+                    static_cast<uint8_t>(signal_index >> 8),
+                    static_cast<uint8_t>(signal_index & 0xFF),
+                    signal_def) ||
+                !get_signal_name_for_def(signal_def, name))
+        {
+            name = "signal_" + std::to_string(signal_index);
+        }
+
+        write_row(name, snapshot);
+    }
+
+    fill_snapshot(overflow_counters, snapshot);
+    if (snapshot.received != 0)
+    {
+        write_row("(other)", snapshot);
+    }
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        fill_snapshot(device_counters[i], snapshot);
+        if (snapshot.received != 0)
+        {
+            write_row("device_" + std::to_string(i), snapshot);
+        }
+    }
+
+    stream << "header_errors " << get_header_error_count() << '\n';
+    stream.flags(flags);
+}
+
+void SignalStatistics::flush_device_batch()
+{
+    add_accepted(device_counters[pending_device], pending_device_count, pending_device_time);
+    pending_device_count = 0;
+}
+
+void SignalStatistics::sample_interval(
+        Counters& counters,
+        const uint32_t accepted,
+        const timestamp_t now)
+{
+    const uint32_t sampled = counters.sampled_accepted.load(std::memory_order_relaxed);
+    if (sampled != 0)
+    {
+        // Spread the time since the last sample over the records accepted since
+        const uint32_t elapsed = now - counters.last_arrival.load(std::memory_order_relaxed);
+        const uint32_t records = accepted - sampled;
+        counters.last_interval.store(elapsed / records, std::memory_order_relaxed);
+
+        // Update the exponentially-weighted average interval, with a weight of 1/8
+        const int64_t scaled_interval = static_cast<int64_t>(elapsed) * INTERVAL_SCALE / records;
+        const int64_t average = counters.average_interval.load(std::memory_order_relaxed);
+        const int64_t updated = average == 0 ?
+                    scaled_interval :
+                    average + (scaled_interval - average) / 8;
+        counters.average_interval.store(static_cast<uint32_t>(updated), std::memory_order_relaxed);
+    }
+
+    counters.sampled_accepted.store(accepted, std::memory_order_relaxed);
+    counters.last_arrival.store(now, std::memory_order_relaxed);
+}
+
+void SignalStatistics::fill_snapshot(
+        const Counters& counters,
+        StatisticsSnapshot& snapshot)
+{
+    snapshot.accepted = counters.accepted.load(std::memory_order_relaxed);
+    snapshot.received = snapshot.accepted;
+
+    for (size_t r = 0; r < REJECT_REASON_COUNT; ++r)
+    {
+        snapshot.rejected[r] = counters.rejected[r].load(std::memory_order_relaxed);
+        snapshot.received += snapshot.rejected[r];
+    }
+
+    snapshot.last_arrival = counters.last_arrival.load(std::memory_order_relaxed);
+    snapshot.last_interval_millis = counters.last_interval.load(std::memory_order_relaxed);
+
+    const uint32_t average = counters.average_interval.load(std::memory_order_relaxed);
+    snapshot.rate_hz = average != 0 ?
+                1000.0 * INTERVAL_SCALE / average :
+                0.0;
+}
+
+void SignalStatistics::clear_counters(Counters& counters)
+{
+    counters.accepted.store(0, std::memory_order_relaxed);
+    for (size_t r = 0; r < REJECT_REASON_COUNT; ++r)
+    {
+        counters.rejected[r].store(0, std::memory_order_relaxed);
+    }
+    counters.last_arrival.store(0, std::memory_order_relaxed);
+    counters.sampled_accepted.store(0, std::memory_order_relaxed);
+    counters.last_interval.store(0, std::memory_order_relaxed);
+    counters.average_interval.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,444 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_STATISTICS_H
+#define TF_SIGNAL_STATISTICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include "signal_def.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The RejectReason enum provides the reasons that a received record may be rejected
+ */
+enum class RejectReason
+{
+    UnknownId = 0,
+    ShortBuffer = 1,
+    PriorityLoss = 2,
+    DeserializeFailed = 3,
+    FragmentRejected = 4,
+    DeltaRejected = 5,
+    Filtered = 6,
+    RateLimited = 7,
+    SchemaMismatch = 8
+};
+
+/**
+ * @brief REJECT_REASON_COUNT provides the number of reject reasons
+ */
+const size_t REJECT_REASON_COUNT = 9;
+
+/**
+ * @brief get_reject_reason_name provides a short name for the reject reason
+ * @param reason is the reason to provide the name for
+ * @return the reject reason name
+ */
+const char* get_reject_reason_name(const RejectReason reason);
+
+/**
+ * @brief The StatisticsSnapshot struct provides a copy of the ingest counters
+ * for a single signal or source device
+ */
+struct StatisticsSnapshot
+{
+    /**
+     * @brief received provides the number of records received
+     */
+    uint32_t received;
+
+    /**
+     * @brief accepted provides the number of records accepted into the database
+     */
+    uint32_t accepted;
+
+    /**
+     * @brief rejected provides the number of records rejected, for each reject reason
+     */
+    uint32_t rejected[REJECT_REASON_COUNT];
+
+    /**
+     * @brief last_arrival provides the time of the last accepted record, to the
+     * millisecond the intervals were last sampled at
+     */
+    timestamp_t last_arrival;
+
+    /**
+     * @brief last_interval_millis provides the average time between the accepted
+     * records of the last sampled millisecond and those of the sample before
+     */
+    uint32_t last_interval_millis;
+
+    /**
+     * @brief rate_hz provides the smoothed rate of accepted records
+     */
+    double rate_hz;
+};
+
+/**
+ * @brief The SignalStatistics class provides ingest counters for each signal in
+ * the database and for each source device. Counters are grouped into cache-line
+ * sized blocks so that updates to one signal do not contend with another. The
+ * counters are written only by the ingest thread, and may be read from other
+ * threads through the snapshot functions. Accepted records are counted against
+ * their source device in batches, which are published when the source device
+ * changes and when flush is called at the end of each frame. Arrival intervals
+ * are sampled once the arrival time moves on to a new millisecond, so that each
+ * further record within the same millisecond only updates the accepted count
+ */
+class SignalStatistics
+{
+public:
+    /**
+     * @brief SignalStatistics constructs disabled statistics with no signals
+     */
+    SignalStatistics();
+
+    /**
+     * @brief init allocates counters for the provided signal indices
+     * @param signal_indices is the list of signal indices within the database
+     * @param signal_count is the number of signal indices
+     */
+    void init(
+            const uint16_t* signal_indices,
+            const size_t signal_count);
+
+    /**
+     * @brief set_enabled enables or disables recording of statistics
+     * @param enabled is true to record statistics
+     */
+    void set_enabled(const bool enabled);
+
+    /**
+     * @brief is_enabled determines if statistics are being recorded
+     * @return true if statistics are being recorded
+     */
+    bool is_enabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief reset clears all counters
+     */
+    void reset();
+
+    /**
+     * @brief record_accepted records an accepted record
+     * @param signal_index is the signal index of the record
+     * @param from_device is the device the record was received from
+     * @param now is the time the record was accepted
+     */
+    void record_accepted(
+            const size_t signal_index,
+            const uint8_t from_device,
+            const timestamp_t now)
+    {
+        if (is_enabled())
+        {
+            add_accepted(signal_counters_for(signal_index), 1, now);
+
+            // Records within a frame share a source device, so the device counters
+            // are only updated once the device changes or the frame ends
+            if (pending_device_count != 0 && pending_device != from_device)
+            {
+                flush_device_batch();
+            }
+
+            pending_device = from_device;
+            pending_device_count += 1;
+            pending_device_time = now;
+        }
+    }
+
+    /**
+     * @brief record_accepted records an accepted record at the current time
+     * @param signal_index is the signal index of the record
+     * @param from_device is the device the record was received from
+     */
+    void record_accepted(
+            const size_t signal_index,
+            const uint8_t from_device)
+    {
+        if (is_enabled())
+        {
+            record_accepted(signal_index, from_device, get_millis());
+        }
+    }
+
+    /**
+     * @brief record_rejected records a rejected record
+     * @param signal_index is the signal index of the record
+     * @param from_device is the device the record was received from
+     * @param reason is the reason the record was rejected
+     */
+    void record_rejected(
+            const size_t signal_index,
+            const uint8_t from_device,
+            const RejectReason reason)
+    {
+        if (is_enabled())
+        {
+            add_rejected(signal_counters_for(signal_index), reason);
+            add_rejected(device_counters[from_device], reason);
+        }
+    }
+
+    /**
+     * @brief flush publishes any accepted records not yet added to the device counters.
+     * Called by the database at the end of each frame
+     */
+    void flush()
+    {
+        if (pending_device_count != 0)
+        {
+            flush_device_batch();
+        }
+    }
+
+    /**
+     * @brief record_header_error records data that could not be read as a signal header
+     */
+    void record_header_error()
+    {
+        if (is_enabled())
+        {
+            increment(header_errors);
+        }
+    }
+
+    /**
+     * @brief get_signal_snapshot provides the counters for a signal
+     * @param signal_index is the signal index to provide counters for
+     * @param snapshot stores the counters
+     * @return true if the signal has counters
+     */
+    bool get_signal_snapshot(
+            const size_t signal_index,
+            StatisticsSnapshot& snapshot) const;
+
+    /**
+     * @brief get_device_snapshot provides the counters for a source device
+     * @param from_device is the device to provide counters for
+     * @param snapshot stores the counters
+     */
+    void get_device_snapshot(
+            const uint8_t from_device,
+            StatisticsSnapshot& snapshot) const;
+
+    /**
+     * @brief get_header_error_count provides the number of header read failures
+     * @return the header error count
+     */
+    uint32_t get_header_error_count() const;
+
+    /**
+     * @brief dump writes a text table of every signal and device with received records
+     * @param stream is the stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+    /**
+     * @brief NO_SLOT marks signal indices without counters
+     */
+    static const uint16_t NO_SLOT = 0xFFFF;
+
+protected:
+    /**
+     * @brief The Counters struct provides the counters for a single signal or device,
+     * padded to a cache line
+     */
+    struct alignas(64) Counters
+    {
+        std::atomic<uint32_t> accepted;
+        std::atomic<uint32_t> rejected[REJECT_REASON_COUNT];
+        std::atomic<uint32_t> last_arrival;
+        std::atomic<uint32_t> sampled_accepted;
+        std::atomic<uint32_t> last_interval;
+        std::atomic<uint32_t> average_interval;
+    };
+
+    /**
+     * @brief increment adds one to a counter. Counters have a single writer, and so
+     * a relaxed load and store is used instead of a locked read-modify-write
+     * @param counter is the counter to increment
+     */
+    static void increment(std::atomic<uint32_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief add_accepted updates the counters for a batch of accepted records.
+     * The intervals are only sampled once the arrival time has changed, so that
+     * records arriving within the same millisecond cost a single counter update
+     * @param counters is the counters to update
+     * @param count is the number of records accepted
+     * @param now is the time the last record was accepted
+     */
+    static void add_accepted(
+            Counters& counters,
+            const uint32_t count,
+            const timestamp_t now)
+    {
+        const uint32_t accepted = counters.accepted.load(std::memory_order_relaxed) + count;
+        counters.accepted.store(accepted, std::memory_order_relaxed);
+
+        if (counters.last_arrival.load(std::memory_order_relaxed) != now)
+        {
+            sample_interval(counters, accepted, now);
+        }
+    }
+
+    /**
+     * @brief sample_interval updates the intervals from the records accepted since
+     * the last sample, and records the arrival time
+     * @param counters is the counters to update
+     * @param accepted is the number of records accepted, including the new records
+     * @param now is the time the last record was accepted
+     */
+    static void sample_interval(
+            Counters& counters,
+            const uint32_t accepted,
+            const timestamp_t now);
+
+    /**
+     * @brief flush_device_batch adds the pending accepted records to the device counters
+     */
+    void flush_device_batch();
+
+    /**
+     * @brief add_rejected updates the counters for a rejected record
+     * @param counters is the counters to update
+     * @param reason is the reason the record was rejected
+     */
+    static void add_rejected(
+            Counters& counters,
+            const RejectReason reason)
+    {
+        increment(counters.rejected[static_cast<size_t>(reason)]);
+    }
+
+    /**
+     * @brief signal_counters_for provides the counters for a signal index. Signals
+     * without counters share the overflow counters
+     * @param signal_index is the signal index
+     * @return the counters for the signal
+     */
+    Counters& signal_counters_for(const size_t signal_index)
+    {
+        const uint16_t slot = signal_index < SignalDef::MAX_SIGNAL_COUNT && signal_slots != nullptr ?
+                    signal_slots[signal_index] :
+                    NO_SLOT;
+        return slot != NO_SLOT ? signal_counters[slot] : overflow_counters;
+    }
+
+    /**
+     * @brief fill_snapshot copies counters into a snapshot
+     * @param counters is the counters to copy
+     * @param snapshot stores the copied counters
+     */
+    static void fill_snapshot(
+            const Counters& counters,
+            StatisticsSnapshot& snapshot);
+
+    /**
+     * @brief clear_counters resets the counters to zero
+     * @param counters is the counters to clear
+     */
+    static void clear_counters(Counters& counters);
+
+    /**
+     * @brief INTERVAL_SCALE provides the fixed-point scale of the average interval
+     */
+    static const uint32_t INTERVAL_SCALE = 16;
+
+protected:
+    /**
+     * @brief device_counters provides the counters for each source device
+     */
+    Counters device_counters[256];
+
+    /**
+     * @brief overflow_counters provides the counters for records without a signal slot
+     */
+    Counters overflow_counters;
+
+    /**
+     * @brief signal_counter_storage provides the allocation for the signal counters
+     */
+    std::unique_ptr<uint8_t[]> signal_counter_storage;
+
+    /**
+     * @brief signal_counters provides the counters for each signal, aligned within the storage
+     */
+    Counters* signal_counters;
+
+    /**
+     * @brief signal_slots maps each signal index to its counter slot
+     */
+    std::unique_ptr<uint16_t[]> signal_slots;
+
+    /**
+     * @brief signal_slot_indices provides the signal index for each counter slot
+     */
+    std::unique_ptr<uint16_t[]> signal_slot_indices;
+
+    /**
+     * @brief signal_slot_count provides the number of signal counter slots
+     */
+    size_t signal_slot_count;
+
+    /**
+     * @brief pending_device provides the source device of the pending accepted records
+     */
+    uint8_t pending_device;
+
+    /**
+     * @brief pending_device_count provides the number of accepted records not yet
+     * added to the device counters
+     */
+    uint32_t pending_device_count;
+
+    /**
+     * @brief pending_device_time provides the time of the last pending accepted record
+     */
+    timestamp_t pending_device_time;
+
+    /**
+     * @brief header_errors provides the number of header read failures
+     */
+    std::atomic<uint32_t> header_errors;
+
+    /**
+     * @brief enabled is true if statistics are being recorded
+     */
+    std::atomic<bool> enabled;
+};
+
+}
+
+#endif // TF_SIGNAL_STATISTICS_H
@@ -0,0 +1,279 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_subscription.h"
+
+#include <iomanip>
+
+using namespace efis_signals;
+
+SubscriptionTable::SubscriptionTable() :
+    timeout_millis(0),
+    enabled(false)
+{
+    reset();
+}
+
+void SubscriptionTable::set_enabled(const bool is_enabled)
+{
+    enabled = is_enabled;
+}
+
+bool SubscriptionTable::is_enabled() const
+{
+    return enabled;
+}
+
+void SubscriptionTable::set_timeout(const uint32_t timeout)
+{
+    timeout_millis = timeout;
+}
+
+bool SubscriptionTable::read_subscription(
+        const uint8_t from_device,
+        DataReader& reader,
+        const timestamp_t now)
+{
+    uint16_t word_count = 0;
+    if (!reader.read_ushort(word_count) ||
+            reader.bytes_available() < word_count * WORD_ENTRY_SIZE)
+    {
+        return false;
+    }
+
+    // Check the word list before changing the table, so that a corrupt
+    // subscription does not replace a valid one. Word indexes must ascend. A
+    // periodic refresh usually repeats the current subscription, which is found
+    // by comparing the words against the slot, so that the table is only
+    // rewritten when the subscription changes
+    Subscriber* slot = find_slot(from_device, now);
+    const bool is_current = slot != nullptr && slot->in_use && slot->device_id == from_device;
+
+    DataReader check_reader = reader;
+    uint32_t next_index = 0;
+    size_t set_word_count = 0;
+    bool is_changed = !is_current;
+
+    for (size_t i = 0; i < word_count; ++i)
+    {
+        uint16_t word_index = 0;
+        uint32_t word_high = 0;
+        uint32_t word_low = 0;
+
+        if (!check_reader.read_ushort(word_index) ||
+                !check_reader.read_uint(word_high) ||
+                !check_reader.read_uint(word_low) ||
+                word_index < next_index ||
+                word_index >= SignalBitmap::WORD_COUNT)
+        {
+            return false;
+        }
+
+        const uint64_t word = (static_cast<uint64_t>(word_high) << 32) | word_low;
+        if (word != 0)
+        {
+            set_word_count += 1;
+        }
+
+        if (!is_changed && slot->signals.get_word(word_index) != word)
+        {
+            is_changed = true;
+        }
+
+        next_index = word_index + 1u;
+    }
+
+    if (slot == nullptr)
+    {
+        reader.skip(word_count * WORD_ENTRY_SIZE);
+        return false;
+    }
+    else if (!is_changed && set_word_count == slot->set_word_count)
+    {
+        reader.skip(word_count * WORD_ENTRY_SIZE);
+        slot->update_time = now;
+        return true;
+    }
+
+    slot->signals.clear_all();
+    for (size_t i = 0; i < word_count; ++i)
+    {
+        uint16_t word_index = 0;
+        uint32_t word_high = 0;
+        uint32_t word_low = 0;
+
+        reader.read_ushort(word_index);
+        reader.read_uint(word_high);
+        reader.read_uint(word_low);
+
+        slot->signals.set_word(word_index, (static_cast<uint64_t>(word_high) << 32) | word_low);
+    }
+
+    slot->update_time = now;
+    slot->set_word_count = set_word_count;
+    slot->device_id = from_device;
+    slot->in_use = true;
+
+    rebuild_merged();
+    return true;
+}
+
+size_t SubscriptionTable::expire(const timestamp_t now)
+{
+    size_t removed_count = 0;
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        Subscriber& subscriber = subscribers[i];
+        if (subscriber.in_use && now - subscriber.update_time > timeout_millis)
+        {
+            subscriber.in_use = false;
+            removed_count += 1;
+        }
+    }
+
+    if (removed_count > 0)
+    {
+        rebuild_merged();
+    }
+
+    return removed_count;
+}
+
+size_t SubscriptionTable::get_subscriber_count() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        if (subscribers[i].in_use)
+        {
+            count += 1;
+        }
+    }
+    return count;
+}
+
+const SignalBitmap& SubscriptionTable::get_merged() const
+{
+    return merged;
+}
+
+void SubscriptionTable::reset()
+{
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        subscribers[i].signals.clear_all();
+        subscribers[i].update_time = 0;
+        subscribers[i].set_word_count = 0;
+        subscribers[i].device_id = 0;
+        subscribers[i].in_use = false;
+    }
+    merged.clear_all();
+}
+
+void SubscriptionTable::dump(std::ostream& stream) const
+{
+    stream << std::left << std::setw(10) << "device" << std::right
+           << std::setw(10) << "signals"
+           << std::setw(14) << "update_time" << '\n';
+
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        const Subscriber& subscriber = subscribers[i];
+        if (!subscriber.in_use)
+        {
+            continue;
+        }
+
+        stream << std::left << std::setw(10) << static_cast<uint32_t>(subscriber.device_id) << std::right
+               << std::setw(10) << subscriber.signals.count()
+               << std::setw(14) << subscriber.update_time << '\n';
+    }
+
+    stream << "merged " << merged.count() << '\n';
+}
+
+size_t SubscriptionTable::payload_size(const SignalBitmap& signals)
+{
+    size_t word_count = 0;
+    for (size_t i = 0; i < SignalBitmap::WORD_COUNT; ++i)
+    {
+        if (signals.get_word(i) != 0)
+        {
+            word_count += 1;
+        }
+    }
+    return 2 + word_count * WORD_ENTRY_SIZE;
+}
+
+bool SubscriptionTable::write_payload(
+        const SignalBitmap& signals,
+        DataWriter& writer)
+{
+    const size_t size = payload_size(signals);
+    if (writer.bytes_available() < size)
+    {
+        return false;
+    }
+
+    bool success = writer.add_ushort(static_cast<uint16_t>((size - 2) / WORD_ENTRY_SIZE));
+    for (size_t i = 0; i < SignalBitmap::WORD_COUNT && success; ++i)
+    {
+        const uint64_t word = signals.get_word(i);
+        if (word != 0)
+        {
+            success =
+                    writer.add_ushort(static_cast<uint16_t>(i)) &&
+                    writer.add_uint(static_cast<uint32_t>(word >> 32)) &&
+                    writer.add_uint(static_cast<uint32_t>(word));
+        }
+    }
+    return success;
+}
+
+SubscriptionTable::Subscriber* SubscriptionTable::find_slot(
+        const uint8_t device_id,
+        const timestamp_t now)
+{
+    Subscriber* free_slot = nullptr;
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        Subscriber& subscriber = subscribers[i];
+        if (subscriber.in_use && subscriber.device_id == device_id)
+        {
+            return &subscriber;
+        }
+        else if (free_slot == nullptr &&
+                 (!subscriber.in_use || now - subscriber.update_time > timeout_millis))
+        {
+            free_slot = &subscriber;
+        }
+    }
+    return free_slot;
+}
+
+void SubscriptionTable::rebuild_merged()
+{
+    merged.clear_all();
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i)
+    {
+        if (subscribers[i].in_use)
+        {
+            merged.merge(subscribers[i].signals);
+        }
+    }
+}
@@ -0,0 +1,219 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_SUBSCRIPTION_H
+#define TF_SIGNAL_SUBSCRIPTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "signal_bitmap.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SubscriptionTable class keeps the signal indexes that each receiving
+ * device has subscribed to, along with the merged set of signals that at least
+ * one device wants. Subscriptions are sent as a sparse list of the non-zero
+ * 64-bit words of the subscribed signal bitmap, and expire unless announced again
+ * within the timeout
+ */
+class SubscriptionTable
+{
+public:
+    /**
+     * @brief MAX_SUBSCRIBERS provides the number of devices that may hold a subscription
+     */
+    static const size_t MAX_SUBSCRIBERS = 8;
+
+    /**
+     * @brief WORD_ENTRY_SIZE provides the encoded size of each non-zero bitmap word
+     */
+    static const size_t WORD_ENTRY_SIZE = 2 + 8;
+
+    /**
+     * @brief SubscriptionTable constructs an empty, disabled subscription table
+     */
+    SubscriptionTable();
+
+    /**
+     * @brief set_enabled sets whether transmission is limited to subscribed signals.
+     * When disabled, subscriptions are still tracked but every signal is published
+     * @param is_enabled is true to only publish subscribed signals
+     */
+    void set_enabled(const bool is_enabled);
+
+    /**
+     * @brief is_enabled determines if transmission is limited to subscribed signals
+     * @return true if enabled
+     */
+    bool is_enabled() const;
+
+    /**
+     * @brief set_timeout sets the time after which a subscription that has not been
+     * announced again is removed
+     * @param timeout is the subscription timeout in milliseconds
+     */
+    void set_timeout(const uint32_t timeout);
+
+    /**
+     * @brief is_subscribed determines if any device has subscribed to a signal
+     * @param signal_index is the signal index to check
+     * @return true if the signal is subscribed to
+     */
+    bool is_subscribed(const size_t signal_index) const
+    {
+        return merged.test(signal_index);
+    }
+
+    /**
+     * @brief read_subscription reads a subscription payload, replacing any previous
+     * subscription from the device. The payload is checked before the table is updated
+     * @param from_device is the device that sent the subscription
+     * @param reader is the reader, positioned at the start of the payload
+     * @param now is the current time
+     * @return true if the subscription was read and stored
+     */
+    bool read_subscription(
+            const uint8_t from_device,
+            DataReader& reader,
+            const timestamp_t now);
+
+    /**
+     * @brief expire removes subscriptions that have not been announced within the timeout
+     * @param now is the current time
+     * @return the number of subscriptions removed
+     */
+    size_t expire(const timestamp_t now);
+
+    /**
+     * @brief get_subscriber_count provides the number of devices with a current subscription
+     * @return the number of subscribers
+     */
+    size_t get_subscriber_count() const;
+
+    /**
+     * @brief get_merged provides the set of signals subscribed to by any device
+     * @return the merged subscription bitmap
+     */
+    const SignalBitmap& get_merged() const;
+
+    /**
+     * @brief reset removes every subscription
+     */
+    void reset();
+
+    /**
+     * @brief dump writes the current subscribers and their signal counts
+     * @param stream is the output stream to write to
+     */
+    void dump(std::ostream& stream) const;
+
+    /**
+     * @brief payload_size determines the encoded size of a subscription payload
+     * @param signals is the set of subscribed signal indexes
+     * @return the payload size in bytes
+     */
+    static size_t payload_size(const SignalBitmap& signals);
+
+    /**
+     * @brief write_payload writes a subscription payload for the provided signals
+     * @param signals is the set of subscribed signal indexes
+     * @param writer is the writer to write the payload into
+     * @return true if the payload was written
+     */
+    static bool write_payload(
+            const SignalBitmap& signals,
+            DataWriter& writer);
+
+protected:
+    /**
+     * @brief The Subscriber struct provides the subscription for a single device
+     */
+    struct Subscriber
+    {
+        /**
+         * @brief signals provides the signal indexes the device subscribed to
+         */
+        SignalBitmap signals;
+
+        /**
+         * @brief update_time provides the time the subscription was last announced
+         */
+        timestamp_t update_time;
+
+        /**
+         * @brief set_word_count provides the number of non-zero words in the signal bitmap
+         */
+        size_t set_word_count;
+
+        /**
+         * @brief device_id provides the subscribing device
+         */
+        uint8_t device_id;
+
+        /**
+         * @brief in_use is true if the subscriber slot holds a subscription
+         */
+        bool in_use;
+    };
+
+    /**
+     * @brief find_slot finds the slot for a device, or a free or expired slot
+     * @param device_id is the subscribing device
+     * @param now is the current time
+     * @return the slot to use, or nullptr if the table is full
+     */
+    Subscriber* find_slot(
+            const uint8_t device_id,
+            const timestamp_t now);
+
+    /**
+     * @brief rebuild_merged recomputes the merged subscription bitmap
+     */
+    void rebuild_merged();
+
+    /**
+     * @brief subscribers provides the per-device subscriptions
+     */
+    Subscriber subscribers[MAX_SUBSCRIBERS];
+
+    /**
+     * @brief merged provides the union of every subscription
+     */
+    SignalBitmap merged;
+
+    /**
+     * @brief timeout_millis provides the subscription timeout
+     */
+    uint32_t timeout_millis;
+
+    /**
+     * @brief enabled is true if transmission is limited to subscribed signals
+     */
+    bool enabled;
+};
+
+}
+
+#endif // TF_SIGNAL_SUBSCRIPTION_H
@@ -0,0 +1,184 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_sync.h"
+
+#include "signal_database.h"
+
+using namespace efis_signals;
+
+SignalSyncBurst::SignalSyncBurst(
+        const SignalDatabase& database,
+        const size_t mtu,
+        const uint32_t bytes_per_milli) :
+    database(database),
+    mtu(mtu),
+    format(database.get_wire_format()),
+    bytes_per_milli(bytes_per_milli),
+    budget(mtu * BUDGET_FRAME_COUNT),
+    last_refill(get_millis()),
+    next_position(0),
+    signals_remaining(0),
+    last_request_count(database.get_sync_request_count()),
+    fragmenter(mtu, format),
+    skipped_count(0)
+{
+    // Empty Constructor
+}
+
+bool SignalSyncBurst::poll_requests()
+{
+    const uint32_t request_count = database.get_sync_request_count();
+    if (request_count != last_request_count)
+    {
+        last_request_count = request_count;
+        start();
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+void SignalSyncBurst::start()
+{
+    signals_remaining = database.get_signal_count();
+}
+
+bool SignalSyncBurst::is_active() const
+{
+    return signals_remaining > 0 || fragmenter.is_active();
+}
+
+uint32_t SignalSyncBurst::get_skipped_count() const
+{
+    return skipped_count;
+}
+
+bool SignalSyncBurst::write_frame(DataWriter& writer)
+{
+    // Only write a frame if a full frame is allowed by the rate limit
+    refill_budget(get_millis());
+    if (!is_active() || budget < mtu)
+    {
+        return false;
+    }
+
+    const size_t initial_available = writer.bytes_available();
+    const size_t frame_size = initial_available < mtu ? initial_available : mtu;
+    const size_t signal_count = database.get_signal_count();
+
+    bool frame_full = false;
+    size_t frame_used = 0;
+
+    // Continue the fragments of an oversize data signal before moving on
+    if (fragmenter.is_active())
+    {
+        if (fragmenter.write_fragment(writer))
+        {
+            frame_used = initial_available - writer.bytes_available();
+        }
+        else
+        {
+            // The fragment was unable to be written into an empty frame
+            fragmenter.cancel();
+            skipped_count += 1;
+        }
+
+        frame_full = fragmenter.is_active();
+    }
+
+    while (signals_remaining > 0 && !frame_full && signal_count > 0)
+    {
+        SignalTypeBase* signal = nullptr;
+        const bool should_send =
+                database.get_signal_for_index(database.get_signal_index(next_position), &signal) &&
+                signal->get_source_type() == SignalSourceType::Transmitted &&
+                signal->is_valid();
+
+        // Size the record as it would be sent now, which may be compressed
+        const size_t payload_size = should_send ? signal->encoded_packet_size() : 0;
+        const size_t record_size = should_send ?
+                    SignalHeader::record_overhead(format, payload_size) + payload_size :
+                    0;
+
+        if (should_send && frame_used + record_size > frame_size && frame_used > 0)
+        {
+            // Leave the signal to start the next frame
+            frame_full = true;
+            continue;
+        }
+
+        if (should_send && record_size > frame_size)
+        {
+            // Send data signals larger than a single frame as fragments, starting
+            // with this frame. Other signals are unable to be sent
+            const SignalTypeData* data = dynamic_cast<const SignalTypeData*>(signal);
+            if (data != nullptr && fragmenter.start(*data) && fragmenter.write_fragment(writer))
+            {
+                frame_used = initial_available - writer.bytes_available();
+                frame_full = fragmenter.is_active();
+            }
+            else
+            {
+                fragmenter.cancel();
+                skipped_count += 1;
+            }
+        }
+        else if (should_send)
+        {
+            const size_t record_start = writer.bytes_written();
+            size_t payload_start = 0;
+            if (!signal->get_header().write_record_start(writer, format, payload_size, payload_start) ||
+                    !signal->serialize(writer) ||
+                    !SignalHeader::write_record_end(writer, format, payload_size, payload_start))
+            {
+                // Remove the partial record. The signal is retried in the next
+                // frame, unless it was unable to be written into an empty frame
+                writer.truncate(record_start);
+                frame_full = true;
+                if (frame_used > 0)
+                {
+                    continue;
+                }
+
+                skipped_count += 1;
+            }
+            else
+            {
+                frame_used = initial_available - writer.bytes_available();
+            }
+        }
+
+        next_position = (next_position + 1) % signal_count;
+        signals_remaining -= 1;
+    }
+
+    budget -= frame_used;
+    return frame_used > 0;
+}
+
+void SignalSyncBurst::refill_budget(const timestamp_t now)
+{
+    const size_t budget_limit = mtu * BUDGET_FRAME_COUNT;
+    const size_t added = static_cast<size_t>(now - last_refill) * bytes_per_milli;
+
+    budget = (added > budget_limit - budget) ? budget_limit : budget + added;
+    last_refill = now;
+}
@@ -0,0 +1,169 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_SYNC_H
+#define TF_SIGNAL_SYNC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "data_writer.h"
+#include "signal_database.h"
+#include "signal_fragment.h"
+#include "signal_time.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SignalSyncBurst class provides the producer side of the state
+ * synchronization protocol. When a sync request is received by the database,
+ * the burst sends the current state of every valid transmitted signal, packed
+ * into MTU-sized frames and limited to a configured byte rate so that a
+ * joining device is brought up to date without flooding the network. Data
+ * signals too large for a single frame are sent as fragments, one per frame,
+ * before the burst moves on to the following signals
+ */
+class SignalSyncBurst
+{
+public:
+    /**
+     * @brief SignalSyncBurst constructs an inactive sync burst
+     * @param database is the signal database to send signals from and poll for requests.
+     * The database must remain available for the lifetime of the burst, and records
+     * are written with the wire format of the database when the burst is constructed
+     * @param mtu is the maximum number of bytes to write into a single frame
+     * @param bytes_per_milli is the maximum average number of bytes to send per millisecond
+     */
+    SignalSyncBurst(
+            const SignalDatabase& database,
+            const size_t mtu,
+            const uint32_t bytes_per_milli);
+
+    /**
+     * @brief poll_requests checks the signal database for new sync requests,
+     * starting a burst if any have been received since the last poll
+     * @return true if a new burst was started
+     */
+    bool poll_requests();
+
+    /**
+     * @brief start starts a burst, sending every transmitted signal once. If a
+     * burst is already active, the burst is extended to cover every signal again
+     * from the current position
+     */
+    void start();
+
+    /**
+     * @brief is_active determines if a burst is in progress
+     * @return true if signals or fragments remain to be sent
+     */
+    bool is_active() const;
+
+    /**
+     * @brief get_skipped_count provides the number of signals that were unable to
+     * be sent in any burst, such as records that fail to write into an empty frame
+     * or data signals that are unable to be fragmented
+     * @return the number of skipped signals
+     */
+    uint32_t get_skipped_count() const;
+
+    /**
+     * @brief write_frame writes the next frame of the burst into the writer.
+     * No data is written if the rate limit does not currently allow a full frame.
+     * A record that fails to write is removed from the writer, and is retried in
+     * the next frame unless it could not be written into an empty frame
+     * @param writer is the writer to place the frame into
+     * @return true if at least one signal was written into the frame
+     */
+    bool write_frame(DataWriter& writer);
+
+protected:
+    /**
+     * @brief refill_budget adds the byte budget accumulated since the last refill
+     * @param now is the current time
+     */
+    void refill_budget(const timestamp_t now);
+
+    /**
+     * @brief BUDGET_FRAME_COUNT provides the number of full frames that may be
+     * sent back-to-back before the rate limit applies
+     */
+    static const size_t BUDGET_FRAME_COUNT = 4;
+
+protected:
+    /**
+     * @brief database provides the signal database to send signals from
+     */
+    const SignalDatabase& database;
+
+    /**
+     * @brief mtu provides the maximum size of each frame
+     */
+    size_t mtu;
+
+    /**
+     * @brief format provides the wire format to write records with
+     */
+    WireFormat format;
+
+    /**
+     * @brief bytes_per_milli provides the rate limit in bytes per millisecond
+     */
+    uint32_t bytes_per_milli;
+
+    /**
+     * @brief budget provides the number of bytes that may currently be sent
+     */
+    size_t budget;
+
+    /**
+     * @brief last_refill provides the last time the byte budget was refilled
+     */
+    timestamp_t last_refill;
+
+    /**
+     * @brief next_position provides the position of the next signal to consider
+     * for sending, within the defined signals of the database
+     */
+    size_t next_position;
+
+    /**
+     * @brief signals_remaining provides the number of signals left to consider
+     */
+    size_t signals_remaining;
+
+    /**
+     * @brief last_request_count provides the database sync request count at the last poll
+     */
+    uint32_t last_request_count;
+
+    /**
+     * @brief fragmenter provides the transfer of a data signal larger than a frame
+     */
+    SignalFragmenter fragmenter;
+
+    /**
+     * @brief skipped_count provides the number of signals unable to be sent
+     */
+    uint32_t skipped_count;
+};
+
+}
+
+#endif // TF_SIGNAL_SYNC_H
@@ -30,3 +30,10 @@ efis_signals::timestamp_t efis_signals::get_millis()
     static ChronoTime time;
     return time.get_millis();
 }
+
+
+uint64_t efis_signals::get_epoch_millis()
+{
+    const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+}
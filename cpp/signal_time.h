@@ -31,6 +31,12 @@ using timestamp_t = uint32_t;
  */
 timestamp_t get_millis();
 
+/**
+ * @brief get_epoch_millis provides the current wall-clock time in milliseconds
+ * @return the current milliseconds from the system clock epoch
+ */
+uint64_t get_epoch_millis();
+
 }
 
 #endif // TF_SIGNAL_TIME_H
@@ -0,0 +1,246 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include "signal_trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace efis_signals;
+
+/**
+ * @brief The TraceRing struct provides the event ring for a single thread. The
+ * events and positions are only written by the owning thread. Other threads
+ * request a clear by advancing the clear generation, which the owning thread
+ * applies by moving the tail up to the head
+ */
+struct TraceRing
+{
+    TraceEvent events[TRACE_RING_CAPACITY];
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> clear_generation;
+    std::atomic<uint32_t> applied_generation;
+    uint32_t thread_id;
+};
+
+/**
+ * @brief get_ring_range provides the positions of the events held within a ring
+ * @param ring is the ring to check
+ * @param start stores the position of the oldest event held
+ * @param head stores the position after the newest event
+ */
+static void get_ring_range(
+        const TraceRing& ring,
+        uint64_t& start,
+        uint64_t& head)
+{
+    head = ring.head.load(std::memory_order_acquire);
+    const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+
+    if (ring.clear_generation.load(std::memory_order_acquire) != ring.applied_generation.load(std::memory_order_acquire))
+    {
+        start = head;
+    }
+    else
+    {
+        start = head - tail > TRACE_RING_CAPACITY ? head - TRACE_RING_CAPACITY : tail;
+    }
+}
+
+/**
+ * @brief The TraceRegistry struct provides the rings of every thread that has
+ * recorded an event. Rings are kept after the owning thread exits, so that
+ * events may be written at the end of a run
+ */
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+};
+
+static TraceRegistry& get_registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+static TraceRing* register_ring()
+{
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::unique_ptr<TraceRing> ring(new TraceRing());
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->clear_generation.store(0, std::memory_order_relaxed);
+    ring->applied_generation.store(0, std::memory_order_relaxed);
+    ring->thread_id = static_cast<uint32_t>(registry.rings.size() + 1);
+
+    registry.rings.push_back(std::move(ring));
+    return registry.rings.back().get();
+}
+
+static std::chrono::steady_clock::time_point get_trace_epoch()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+const char* efis_signals::get_trace_stage_name(const TraceStage stage)
+{
+    switch (stage)
+    {
+    case TraceStage::Receive:
+        return "receive";
+    case TraceStage::HeaderDecode:
+        return "header_decode";
+    case TraceStage::Lookup:
+        return "lookup";
+    case TraceStage::Arbitration:
+        return "arbitration";
+    case TraceStage::Deserialize:
+        return "deserialize";
+    case TraceStage::Transmit:
+        return "transmit";
+    case TraceStage::Serialize:
+        return "serialize";
+    case TraceStage::Compress:
+        return "compress";
+    case TraceStage::Decompress:
+        return "decompress";
+    default:
+        return "unknown";
+    }
+}
+
+uint64_t efis_signals::trace_now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - get_trace_epoch()).count());
+}
+
+void efis_signals::trace_record(
+        const TraceStage stage,
+        const uint16_t signal_index,
+        const uint64_t begin_nanos,
+        const uint64_t end_nanos)
+{
+    static thread_local TraceRing* ring = register_ring();
+
+    // Only the owning thread writes to the ring, so the head is advanced without a locked operation
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+
+    // Apply any clear requested since the last event
+    const uint32_t generation = ring->clear_generation.load(std::memory_order_acquire);
+    if (generation != ring->applied_generation.load(std::memory_order_relaxed))
+    {
+        ring->tail.store(head, std::memory_order_release);
+        ring->applied_generation.store(generation, std::memory_order_release);
+    }
+
+    TraceEvent& event = ring->events[head % TRACE_RING_CAPACITY];
+    event.begin_nanos = begin_nanos;
+    event.duration_nanos = static_cast<uint32_t>(end_nanos - begin_nanos);
+    event.signal_index = signal_index;
+    event.stage = stage;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void efis_signals::trace_clear()
+{
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const std::unique_ptr<TraceRing>& ring : registry.rings)
+    {
+        ring->clear_generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+size_t efis_signals::trace_event_count()
+{
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    size_t count = 0;
+    for (const std::unique_ptr<TraceRing>& ring : registry.rings)
+    {
+        uint64_t start = 0;
+        uint64_t head = 0;
+        get_ring_range(*ring, start, head);
+        count += static_cast<size_t>(head - start);
+    }
+
+    return count;
+}
+
+void efis_signals::write_chrome_trace(std::ostream& stream)
+{
+    TraceRegistry& registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    const std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const std::unique_ptr<TraceRing>& ring : registry.rings)
+    {
+        stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << ring->thread_id << ",\"args\":{\"name\":\"signals_" << ring->thread_id << "\"}}";
+        first = false;
+
+        // Write the events still held in the ring, oldest first
+        uint64_t start = 0;
+        uint64_t head = 0;
+        get_ring_range(*ring, start, head);
+
+        for (uint64_t i = start; i < head; ++i)
+        {
+            // Copy the event, then check that the owning thread has not started
+            // to overwrite it, which happens once the head reaches a full ring
+            // past the event
+            const TraceEvent event = ring->events[i % TRACE_RING_CAPACITY];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (i + TRACE_RING_CAPACITY <= ring->head.load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+
+            stream << ",\n{\"name\":\"" << get_trace_stage_name(event.stage)
+                   << "\",\"cat\":\"signals\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->thread_id
+                   << ",\"ts\":" << event.begin_nanos / 1000.0
+                   << ",\"dur\":" << event.duration_nanos / 1000.0;
+
+            if (event.signal_index != TRACE_NO_SIGNAL)
+            {
+                stream << ",\"args\":{\"signal\":" << event.signal_index << '}';
+            }
+
+            stream << '}';
+        }
+    }
+
+    stream << "\n]}\n";
+    stream.flags(flags);
+}
@@ -0,0 +1,213 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_TRACE_H
+#define TF_SIGNAL_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace efis_signals
+{
+
+/**
+ * @brief The TraceStage enum provides the probe points recorded by the trace hooks
+ */
+enum class TraceStage : uint8_t
+{
+    Receive = 0,
+    HeaderDecode = 1,
+    Lookup = 2,
+    Arbitration = 3,
+    Deserialize = 4,
+    Transmit = 5,
+    Serialize = 6,
+    Compress = 7,
+    Decompress = 8
+};
+
+/**
+ * @brief get_trace_stage_name provides the name of a trace stage
+ * @param stage is the stage to provide the name for
+ * @return the stage name
+ */
+const char* get_trace_stage_name(const TraceStage stage);
+
+/**
+ * @brief The TraceEvent struct provides a single completed trace span
+ */
+struct TraceEvent
+{
+    /**
+     * @brief begin_nanos provides the start of the span, from the trace clock epoch
+     */
+    uint64_t begin_nanos;
+
+    /**
+     * @brief duration_nanos provides the length of the span
+     */
+    uint32_t duration_nanos;
+
+    /**
+     * @brief signal_index provides the signal index of the span, or TRACE_NO_SIGNAL
+     */
+    uint16_t signal_index;
+
+    /**
+     * @brief stage provides the probe point that recorded the span
+     */
+    TraceStage stage;
+};
+
+/**
+ * @brief TRACE_NO_SIGNAL marks spans that are not associated with a single signal
+ */
+const uint16_t TRACE_NO_SIGNAL = 0xFFFF;
+
+/**
+ * @brief TRACE_RING_CAPACITY provides the number of events kept for each thread.
+ * Older events are overwritten once the ring is full
+ */
+const size_t TRACE_RING_CAPACITY = 16384;
+
+/**
+ * @brief trace_now provides the current time of the trace clock
+ * @return the nanoseconds from the trace clock epoch
+ */
+uint64_t trace_now();
+
+/**
+ * @brief trace_record adds a span to the trace ring of the calling thread
+ * @param stage is the probe point of the span
+ * @param signal_index is the signal index of the span
+ * @param begin_nanos is the start of the span, from trace_now
+ * @param end_nanos is the end of the span, from trace_now
+ */
+void trace_record(
+        const TraceStage stage,
+        const uint16_t signal_index,
+        const uint64_t begin_nanos,
+        const uint64_t end_nanos);
+
+/**
+ * @brief trace_clear removes the recorded events from every thread. Each ring is
+ * only written by its owning thread, so the clear is requested here and applied by
+ * the owning thread before it records its next event. Events of a ring with a clear
+ * pending are not counted or written
+ */
+void trace_clear();
+
+/**
+ * @brief trace_event_count provides the number of events currently held across all
+ * threads. The count is only exact while the traced threads are idle
+ * @return the number of events available to write
+ */
+size_t trace_event_count();
+
+/**
+ * @brief write_chrome_trace writes the recorded events of every thread as Chrome
+ * trace event JSON, which may be loaded into chrome://tracing or Perfetto. Events
+ * that may have been overwritten while being written out are left out, so the
+ * output is only exact while the traced threads are idle
+ * @param stream is the stream to write to
+ */
+void write_chrome_trace(std::ostream& stream);
+
+/**
+ * @brief The TraceScope class records a span for the lifetime of the object
+ */
+class TraceScope
+{
+public:
+    /**
+     * @brief TraceScope starts a span
+     * @param stage is the probe point of the span
+     * @param signal_index is the signal index of the span
+     */
+    TraceScope(
+            const TraceStage stage,
+            const size_t signal_index) :
+        begin_nanos(trace_now()),
+        signal_index(static_cast<uint16_t>(signal_index)),
+        stage(stage)
+    {
+        // Empty Constructor
+    }
+
+    /**
+     * @brief ~TraceScope ends the span and records it
+     */
+    ~TraceScope()
+    {
+        trace_record(stage, signal_index, begin_nanos, trace_now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+protected:
+    /**
+     * @brief begin_nanos provides the start of the span
+     */
+    const uint64_t begin_nanos;
+
+    /**
+     * @brief signal_index provides the signal index of the span
+     */
+    const uint16_t signal_index;
+
+    /**
+     * @brief stage provides the probe point of the span
+     */
+    const TraceStage stage;
+};
+
+}
+
+// Trace hooks are only compiled in when TF_SIGNALS_ENABLE_TRACE is defined, and
+// otherwise expand to nothing (or to the traced expression alone)
+#ifdef TF_SIGNALS_ENABLE_TRACE
+
+#define TF_TRACE_CONCAT_INNER(a, b) a##b
+#define TF_TRACE_CONCAT(a, b) TF_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief TF_TRACE_SCOPE records a span from this point to the end of the enclosing scope
+ */
+#define TF_TRACE_SCOPE(stage, signal_index) \
+    ::efis_signals::TraceScope TF_TRACE_CONCAT(tf_trace_scope_, __LINE__)(stage, signal_index)
+
+/**
+ * @brief TF_TRACE_CALL records a span around the evaluation of an expression,
+ * providing the result of the expression
+ */
+#define TF_TRACE_CALL(stage, signal_index, expression) \
+    ([&]() { ::efis_signals::TraceScope tf_trace_call_scope(stage, signal_index); return (expression); }())
+
+#else
+
+#define TF_TRACE_SCOPE(stage, signal_index) \
+    do { } while (false)
+
+#define TF_TRACE_CALL(stage, signal_index, expression) \
+    (expression)
+
+#endif
+
+#endif // TF_SIGNAL_TRACE_H
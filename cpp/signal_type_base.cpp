@@ -17,17 +17,82 @@
 
 #include "signal_type_base.h"
 
+#include <limits>
+
 using namespace efis_signals;
 
 SignalTypeBase::SignalTypeBase(const SignalDef& signal) :
     source_type(SignalSourceType::Received),
-    updated_time(0)
+    updated_time(0),
+    transmitted_time(0),
+    timeout_millis(signal.timeout_millis),
+    min_interval(0),
+    transmit_pending(false),
+    first_source(0),
+    first_source_known(false),
+    multiple_sources(false),
+    has_transmitted(false)
 {
     // Set Base Parameters
     header.cat_id = signal.category_id;
     header.sub_id = signal.sub_id;
 }
 
+SignalTypeBase::SignalTypeBase(const SignalTypeBase& other) :
+    header(other.header),
+    source_type(other.source_type),
+    updated_time(other.updated_time),
+    transmitted_time(other.transmitted_time),
+    timeout_millis(other.timeout_millis),
+    min_interval(other.min_interval),
+    transmit_pending(other.transmit_pending),
+    candidates(other.candidates != nullptr ? new SignalCandidateSet(*other.candidates) : nullptr),
+    first_source(other.first_source),
+    first_source_known(other.first_source_known),
+    multiple_sources(other.multiple_sources),
+    has_transmitted(other.has_transmitted)
+{
+    // Empty Constructor
+}
+
+SignalTypeBase& SignalTypeBase::operator=(const SignalTypeBase& other)
+{
+    // Check for self-assignment
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    header = other.header;
+    source_type = other.source_type;
+    updated_time = other.updated_time;
+    transmitted_time = other.transmitted_time;
+    timeout_millis = other.timeout_millis;
+    min_interval = other.min_interval;
+    transmit_pending = other.transmit_pending;
+    first_source = other.first_source;
+    first_source_known = other.first_source_known;
+    multiple_sources = other.multiple_sources;
+    has_transmitted = other.has_transmitted;
+
+    // Reuse the candidate set if one is already allocated
+    if (other.candidates == nullptr)
+    {
+        candidates.reset();
+    }
+    else if (candidates == nullptr)
+    {
+        candidates.reset(new SignalCandidateSet(*other.candidates));
+    }
+    else
+    {
+        *candidates = *other.candidates;
+    }
+
+    // Return the provided pointer
+    return *this;
+}
+
 bool SignalTypeBase::serialize(DataWriter&) const
 {
     return is_transmit();
@@ -38,6 +103,13 @@ bool SignalTypeBase::deserialize(DataReader&)
     return is_receive();
 }
 
+bool SignalTypeBase::deserialize_rescaled(
+        DataReader& reader,
+        const double)
+{
+    return deserialize(reader);
+}
+
 bool SignalTypeBase::update_header(const SignalHeader& other)
 {
     // Ensure that the ID of the signal matches
@@ -75,6 +147,109 @@ bool SignalTypeBase::update_header(const SignalHeader& other)
     }
 }
 
+bool SignalTypeBase::add_candidate(
+        const SignalHeader& other,
+        const DataReader& reader,
+        const timestamp_t now)
+{
+    const bool id_matches =
+            other.cat_id == header.cat_id &&
+            other.sub_id == header.sub_id;
+
+    if (!is_receive() || !id_matches)
+    {
+        return false;
+    }
+    else if (!multiple_sources)
+    {
+        // Candidates are only needed for failover between sources, so nothing is
+        // allocated or copied until a second source device has been seen
+        if (!first_source_known || other.from_device == first_source)
+        {
+            first_source = other.from_device;
+            first_source_known = true;
+            return false;
+        }
+
+        multiple_sources = true;
+        if (keeps_candidates())
+        {
+            candidates.reset(new SignalCandidateSet());
+            seed_candidate();
+        }
+    }
+
+    if (candidates == nullptr)
+    {
+        return false;
+    }
+
+    // Read the payload from a separate reader so that the caller's position is kept
+    const uint8_t* payload = nullptr;
+    const size_t size = packet_size();
+
+    DataReader payload_reader = reader;
+    return
+            payload_reader.read_span(payload, size) &&
+            candidates->update(other, payload, size, now, timeout_millis);
+}
+
+bool SignalTypeBase::promote_candidate(const timestamp_t now)
+{
+    const bool current_valid =
+            (header.priority & 0x80) > 0 &&
+            now - updated_time <= timeout_millis;
+
+    if (!is_receive() || current_valid || candidates == nullptr)
+    {
+        return false;
+    }
+
+    const SignalCandidate* best = candidates->find_best(now, timeout_millis);
+    if (best == nullptr)
+    {
+        return false;
+    }
+
+    DataReader payload_reader;
+    payload_reader.set_buffer(best->payload, best->payload_size);
+
+    if (deserialize(payload_reader))
+    {
+        header.from_device = best->from_device;
+        header.priority = best->priority;
+        header.timestamp = best->timestamp;
+        updated_time = best->receive_time;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+const SignalCandidateSet& SignalTypeBase::get_candidates() const
+{
+    static const SignalCandidateSet empty_candidates;
+    return candidates != nullptr ? *candidates : empty_candidates;
+}
+
+void SignalTypeBase::seed_candidate()
+{
+    // The current value is the latest value received from the first source, if
+    // a valid value from the first source has been accepted
+    uint8_t payload[SignalCandidate::PAYLOAD_SIZE];
+    DataWriter writer;
+    writer.set_buffer(payload, sizeof(payload));
+
+    if ((header.priority & 0x80) != 0 &&
+            header.from_device == first_source &&
+            save_state_payload(writer))
+    {
+        candidates->update(header, payload, writer.bytes_written(), updated_time, timeout_millis);
+    }
+}
+
 bool SignalTypeBase::is_valid() const
 {
     const bool priority_valid = (header.priority & 0x80) > 0;
@@ -88,6 +263,16 @@ size_t SignalTypeBase::packet_size() const
     return 0;
 }
 
+size_t SignalTypeBase::min_packet_size() const
+{
+    return packet_size();
+}
+
+size_t SignalTypeBase::encoded_packet_size() const
+{
+    return packet_size();
+}
+
 void SignalTypeBase::set_updated_time_to_now()
 {
     const efis_signals::timestamp_t millis = get_millis();
@@ -95,14 +280,58 @@ void SignalTypeBase::set_updated_time_to_now()
     if (is_transmit())
     {
         header.timestamp = millis;
+        transmit_pending = transmit_pending || is_change_significant();
     }
 }
 
+timestamp_t SignalTypeBase::get_updated_time() const
+{
+    return updated_time;
+}
+
+bool SignalTypeBase::is_transmit_due(const timestamp_t now) const
+{
+    if (!is_transmit() || !is_valid())
+    {
+        return false;
+    }
+
+    const timestamp_t since_transmit = now - transmitted_time;
+    const uint32_t keep_alive = timeout_millis / 2;
+
+    return
+            !has_transmitted ||
+            (transmit_pending && since_transmit >= min_interval) ||
+            since_transmit >= keep_alive;
+}
+
+void SignalTypeBase::set_transmitted(const timestamp_t now)
+{
+    transmitted_time = now;
+    transmit_pending = false;
+    has_transmitted = true;
+}
+
+void SignalTypeBase::set_min_interval(const uint32_t interval_millis)
+{
+    min_interval = interval_millis;
+}
+
+bool SignalTypeBase::is_change_significant() const
+{
+    return true;
+}
+
 void SignalTypeBase::set_source_type(const SignalSourceType type)
 {
     source_type = type;
 }
 
+SignalSourceType SignalTypeBase::get_source_type() const
+{
+    return source_type;
+}
+
 bool SignalTypeBase::set_priority(const uint8_t priority)
 {
     if (is_transmit())
@@ -134,6 +363,79 @@ const SignalHeader& SignalTypeBase::get_header() const
     return header;
 }
 
+size_t SignalTypeBase::state_size() const
+{
+    return STATE_BASE_SIZE + packet_size();
+}
+
+bool SignalTypeBase::save_state(
+        DataWriter& writer,
+        const timestamp_t now) const
+{
+    return
+            header.write_header(writer) &&
+            writer.add_ubyte(static_cast<uint8_t>(source_type)) &&
+            writer.add_uint(now - updated_time) &&
+            save_state_payload(writer);
+}
+
+bool SignalTypeBase::restore_state(
+        DataReader& reader,
+        const timestamp_t now,
+        const uint32_t elapsed)
+{
+    SignalHeader saved_header;
+    uint8_t saved_source = 0;
+    uint32_t saved_age = 0;
+
+    if (!saved_header.read_header(reader) ||
+            !reader.read_ubyte(saved_source) ||
+            !reader.read_uint(saved_age))
+    {
+        return false;
+    }
+
+    // Only restore state saved for the same signal and signal direction
+    const bool matches =
+            saved_header.cat_id == header.cat_id &&
+            saved_header.sub_id == header.sub_id &&
+            saved_source == static_cast<uint8_t>(source_type);
+
+    if (matches && restore_state_payload(reader))
+    {
+        // Limit the age to half of the timestamp range so that old values
+        // cannot wrap back around into validity
+        const uint32_t max_age = static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
+        const uint32_t age = (saved_age > max_age || elapsed > max_age - saved_age) ?
+                    max_age :
+                    saved_age + elapsed;
+
+        header = saved_header;
+        updated_time = now - age;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool SignalTypeBase::save_state_payload(DataWriter&) const
+{
+    return true;
+}
+
+bool SignalTypeBase::restore_state_payload(DataReader&)
+{
+    return true;
+}
+
+bool SignalTypeBase::keeps_candidates() const
+{
+    const size_t size = packet_size();
+    return size == min_packet_size() && size <= SignalCandidate::PAYLOAD_SIZE;
+}
+
 bool SignalTypeBase::is_receive() const
 {
     return source_type == SignalSourceType::Received;
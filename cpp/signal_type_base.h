@@ -27,8 +27,10 @@
 #include "signal_time.h"
 
 #include "signal_header.h"
+#include "signal_candidate.h"
 
 #include <chrono>
+#include <memory>
 
 namespace efis_signals
 {
@@ -59,6 +61,19 @@ public:
      */
     SignalTypeBase(const SignalDef& signal);
 
+    /**
+     * @brief SignalTypeBase copies the signal, including any candidate values
+     * @param other is the signal to copy
+     */
+    SignalTypeBase(const SignalTypeBase& other);
+
+    /**
+     * @brief operator= copies the signal, including any candidate values
+     * @param other is the signal to copy
+     * @return a reference to the signal
+     */
+    SignalTypeBase& operator=(const SignalTypeBase& other);
+
     /**
      * @brief serialize writes data information to the writer,
      * not including the header (Tx only)
@@ -73,6 +88,18 @@ public:
      */
     virtual bool deserialize(DataReader&);
 
+    /**
+     * @brief deserialize_rescaled reads data sent by a device using an older signal
+     * list revision with a different resolution, not including the header (Rx only).
+     * Signals without a resolution read the data as for deserialize
+     * @param reader is the data to read from
+     * @param source_resolution is the resolution the data was sent with
+     * @return true if the data is able to be read
+     */
+    virtual bool deserialize_rescaled(
+            DataReader& reader,
+            const double source_resolution);
+
     /**
      * @brief update_header attempts to update the signal header
      * from the other header provided (presumably read from the
@@ -90,6 +117,52 @@ public:
      */
     bool update_header(const SignalHeader& other);
 
+    /**
+     * @brief update_candidate stores the value that follows the header in the reader
+     * as the latest value from the sending device, whether or not the header wins
+     * arbitration, so that the device can take over if the current source expires.
+     * The reader is not advanced. Only receiving signals with a fixed payload of
+     * no more than SignalCandidate::PAYLOAD_SIZE bytes keep candidates (Rx only).
+     * No candidates are kept until a second source device has been seen, at which
+     * point the candidate set is allocated and the current value is kept as the
+     * candidate for the first source device. Records from the only source seen so
+     * far are rejected inline, so that signals with a single source make a single
+     * comparison and no call
+     * @param other is the header read from the network
+     * @param reader is the reader, positioned at the start of the signal payload
+     * @param now is the time that the value was received
+     * @return true if the value was stored as a candidate
+     */
+    bool update_candidate(
+            const SignalHeader& other,
+            const DataReader& reader,
+            const timestamp_t now)
+    {
+        if (!multiple_sources && first_source_known && other.from_device == first_source)
+        {
+            return false;
+        }
+        else
+        {
+            return add_candidate(other, reader, now);
+        }
+    }
+
+    /**
+     * @brief promote_candidate replaces the current value with the best live
+     * candidate once the current source has expired, so that a standby source
+     * takes over without waiting for its next transmission (Rx only)
+     * @param now is the current time
+     * @return true if a candidate was promoted
+     */
+    bool promote_candidate(const timestamp_t now);
+
+    /**
+     * @brief get_candidates provides the per-device candidate values
+     * @return the candidate set, which is empty until a second source device has been seen
+     */
+    const SignalCandidateSet& get_candidates() const;
+
     /**
      * @brief is_valid determines if the signal is valid, based on
      * timeout and priority validity parameters
@@ -104,19 +177,71 @@ public:
      */
     virtual size_t packet_size() const;
 
+    /**
+     * @brief min_packet_size determines the smallest size of the data packet, not
+     * including the header, for signals with a variable-length encoding
+     * @return minimum packet size in bytes
+     */
+    virtual size_t min_packet_size() const;
+
+    /**
+     * @brief encoded_packet_size determines the size of the data packet as it would
+     * be serialized now, not including the header, for signals with a
+     * variable-length encoding
+     * @return encoded packet size in bytes
+     */
+    virtual size_t encoded_packet_size() const;
+
     /**
      * @brief set_updated_time_to_now updates the last updated time
      * to the current time value. If Tx, will also update the header
-     * updated timestamp to the current timestamp
+     * updated timestamp to the current timestamp, and mark the signal
+     * for transmission if the change is significant
      */
     void set_updated_time_to_now();
 
+    /**
+     * @brief get_updated_time provides the last time that the signal was updated
+     * @return the last updated time
+     */
+    timestamp_t get_updated_time() const;
+
+    /**
+     * @brief is_transmit_due determines if the signal should be transmitted.
+     * A valid Tx signal is due if it has a pending change and the minimum
+     * interval has passed since the last transmission, or if half of the
+     * signal timeout has passed since the last transmission (keep-alive)
+     * @param now is the current time
+     * @return true if the signal should be transmitted
+     */
+    bool is_transmit_due(const timestamp_t now) const;
+
+    /**
+     * @brief set_transmitted records that the signal has been transmitted,
+     * clearing any pending change
+     * @param now is the time of transmission
+     */
+    virtual void set_transmitted(const timestamp_t now);
+
+    /**
+     * @brief set_min_interval sets the minimum time between transmissions of
+     * changed values. Changes within the interval are held until it has passed
+     * @param interval_millis is the minimum interval in milliseconds
+     */
+    void set_min_interval(const uint32_t interval_millis);
+
     /**
      * @brief set_source_type updates the signal's source type
      * @param type is the type to update the signal to
      */
     void set_source_type(const SignalSourceType type);
 
+    /**
+     * @brief get_source_type provides the signal's source type
+     * @return the current source type
+     */
+    SignalSourceType get_source_type() const;
+
     /**
      * @brief set_priority attempts to set the priority of the signal (Tx only)
      * @param priority is the new priority to set
@@ -137,7 +262,88 @@ public:
      */
     const SignalHeader& get_header() const;
 
+    /**
+     * @brief state_size provides the number of bytes required to store the
+     * complete signal state with save_state
+     * @return the state size in bytes
+     */
+    size_t state_size() const;
+
+    /**
+     * @brief save_state writes the complete signal state, including the header,
+     * source type, signal age and payload, into the writer for checkpointing
+     * @param writer is the data writer to write the state into
+     * @param now is the current time, used to determine the signal age
+     * @return true if the state was successfully written
+     */
+    bool save_state(
+            DataWriter& writer,
+            const timestamp_t now) const;
+
+    /**
+     * @brief restore_state reads the complete signal state written by save_state.
+     * The state is only restored if the signal ID, source type and payload match
+     * the current signal. The stored age is advanced by the provided elapsed time
+     * so that stale values continue to time out as expected
+     * @param reader is the data reader to read the state from
+     * @param now is the current time, used to re-create the updated time
+     * @param elapsed is the time, in milliseconds, that passed since the state was saved
+     * @return true if the state was successfully restored
+     */
+    bool restore_state(
+            DataReader& reader,
+            const timestamp_t now,
+            const uint32_t elapsed);
+
 protected:
+    /**
+     * @brief is_change_significant determines if the most recent Tx value update
+     * is significant enough to require transmission before the keep-alive deadline
+     * @return true if the change should be transmitted
+     */
+    virtual bool is_change_significant() const;
+
+    /**
+     * @brief save_state_payload writes the signal value for a checkpoint,
+     * regardless of the source type. The data written must be packet_size() bytes
+     * @param writer is the data writer to write the value into
+     * @return true if the value was written
+     */
+    virtual bool save_state_payload(DataWriter& writer) const;
+
+    /**
+     * @brief restore_state_payload reads the signal value for a checkpoint,
+     * regardless of the source type
+     * @param reader is the data reader to read the value from
+     * @return true if the value was read
+     */
+    virtual bool restore_state_payload(DataReader& reader);
+
+    /**
+     * @brief add_candidate provides the part of update_candidate taken for a record
+     * that is not from the only source seen so far
+     * @param other is the header read from the network
+     * @param reader is the reader, positioned at the start of the signal payload
+     * @param now is the time that the value was received
+     * @return true if the value was stored as a candidate
+     */
+    bool add_candidate(
+            const SignalHeader& other,
+            const DataReader& reader,
+            const timestamp_t now);
+
+    /**
+     * @brief seed_candidate stores the current value as the candidate for the
+     * current source device, once a second source device has been seen
+     */
+    void seed_candidate();
+
+    /**
+     * @brief keeps_candidates determines if the signal payload can be held as a candidate
+     * @return true if the payload has a fixed size that fits within a candidate
+     */
+    bool keeps_candidates() const;
+
     /**
      * @brief is_receive determines if the signal is receive
      * @return true if the signal is Rx
@@ -161,11 +367,65 @@ protected:
      */
     SignalSourceType source_type;
 
+    /**
+     * @brief STATE_BASE_SIZE provides the size of the state data written before
+     * the signal payload (header, source type and age)
+     */
+    static const size_t STATE_BASE_SIZE = SignalHeader::HEADER_SIZE + 1 + 4;
+
 private:
     /**
      * @brief updated_time defines the last time that the signal has been updated
      */
     efis_signals::timestamp_t updated_time;
+
+    /**
+     * @brief transmitted_time defines the last time that the signal was transmitted
+     */
+    efis_signals::timestamp_t transmitted_time;
+
+    /**
+     * @brief timeout_millis defines the signal timeout, in milliseconds
+     */
+    uint32_t timeout_millis;
+
+    /**
+     * @brief min_interval defines the minimum time, in milliseconds, between transmissions
+     * of changed values
+     */
+    uint32_t min_interval;
+
+    /**
+     * @brief transmit_pending is true if a significant change has not yet been transmitted
+     */
+    bool transmit_pending;
+
+    /**
+     * @brief candidates provides the latest value received from each source device,
+     * allocated once a second source device has been seen
+     */
+    std::unique_ptr<SignalCandidateSet> candidates;
+
+    /**
+     * @brief first_source provides the first source device seen for the signal
+     */
+    uint8_t first_source;
+
+    /**
+     * @brief first_source_known is true once a record has been received for the signal
+     */
+    bool first_source_known;
+
+    /**
+     * @brief multiple_sources is true once a second source device has been seen,
+     * after which candidates are kept for each source device
+     */
+    bool multiple_sources;
+
+    /**
+     * @brief has_transmitted is true once the signal has been transmitted at least once
+     */
+    bool has_transmitted;
 };
 
 }
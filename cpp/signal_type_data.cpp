@@ -17,35 +17,48 @@
 
 #include "signal_type_data.h"
 
+#include <cstring>
+
 using namespace efis_signals;
 
 SignalTypeData::SignalTypeData(
         const SignalDef& signal,
-        const data_size_t size) :
+        const data_size_t size,
+        DataArena* arena) :
     SignalTypeBase(signal),
     data_array_size(size),
-    data_array(nullptr)
+    data_array(nullptr),
+    data_array_owned(false),
+    data_version(0),
+    keyframe_version(0),
+    version_known(false),
+    compression(DataCompression::None),
+    compressed_size(0),
+    compressed_version(0),
+    compressed_valid(false)
 {
     // Define the data array
-    data_array = new data_t[data_array_size];
-    for (data_size_t i = 0; i < data_array_size; ++i)
-    {
-        data_array[i] = 0;
-    }
+    allocate_array(arena);
+    memset(data_array, 0, data_array_size);
 }
 
 SignalTypeData::SignalTypeData(const SignalTypeData& other) :
     SignalTypeBase(other),
     data_array_size(other.data_array_size),
-    data_array(nullptr)
-
+    data_array(nullptr),
+    data_array_owned(false),
+    data_version(other.data_version),
+    keyframe_version(other.keyframe_version),
+    version_known(other.version_known),
+    compression(DataCompression::None),
+    compressed_size(0),
+    compressed_version(0),
+    compressed_valid(false)
 {
-    // Define the data array
-    data_array = new data_t[data_array_size];
-    for (data_size_t i = 0; i < data_array_size; ++i)
-    {
-        data_array[i] = other.data_array[i];
-    }
+    // Define the data array, copying on to the heap if the other uses an arena
+    allocate_array(nullptr);
+    memcpy(data_array, other.data_array, data_array_size);
+    copy_compression(other);
 }
 
 SignalTypeData& SignalTypeData::operator=(const SignalTypeData& other)
@@ -56,23 +69,68 @@ SignalTypeData& SignalTypeData::operator=(const SignalTypeData& other)
         return *this;
     }
 
-    // Allocate new data size if required
+    // Allocate new data size if required, releasing the buffers sized for the
+    // previous array. Buffers of the same size are reused
     if (data_array_size != other.data_array_size)
     {
+        release_array();
         data_array_size = other.data_array_size;
-
-        if (data_array != nullptr)
-        {
-            delete[] data_array;
-        }
-
-        data_array = new data_t[data_array_size];
+        allocate_array(nullptr);
+        compressed_data.reset();
+        decode_buffer.reset();
     }
 
     // Copy data values
-    for (data_size_t i = 0; i < data_array_size; ++i)
+    memcpy(data_array, other.data_array, data_array_size);
+    data_version = other.data_version;
+    keyframe_version = other.keyframe_version;
+    version_known = other.version_known;
+    copy_compression(other);
+
+    // Return the provided pointer
+    return *this;
+}
+
+SignalTypeData::SignalTypeData(SignalTypeData&& other) :
+    SignalTypeBase(other),
+    data_array_size(0),
+    data_array(inline_data),
+    data_array_owned(false),
+    data_version(other.data_version),
+    keyframe_version(other.keyframe_version),
+    version_known(other.version_known),
+    compression(other.compression),
+    compressed_data(std::move(other.compressed_data)),
+    compressed_size(other.compressed_size),
+    compressed_version(other.compressed_version),
+    compressed_valid(other.compressed_valid),
+    decode_buffer(std::move(other.decode_buffer))
+{
+    // The compression buffers are sized for the array, and so move with it
+    take_array(other);
+    other.compressed_valid = false;
+}
+
+SignalTypeData& SignalTypeData::operator=(SignalTypeData&& other)
+{
+    // Check for self-assignment
+    if (this != &other)
     {
-        data_array[i] = other.data_array[i];
+        release_array();
+        take_array(other);
+        data_version = other.data_version;
+        keyframe_version = other.keyframe_version;
+        version_known = other.version_known;
+
+        // Exchange the compression buffers, which are sized for the arrays, so
+        // that the previous buffers are released with the other signal
+        compression = other.compression;
+        compressed_data.swap(other.compressed_data);
+        decode_buffer.swap(other.decode_buffer);
+        compressed_size = other.compressed_size;
+        compressed_version = other.compressed_version;
+        compressed_valid = other.compressed_valid;
+        other.compressed_valid = false;
     }
 
     // Return the provided pointer
@@ -86,6 +144,7 @@ bool SignalTypeData::set_value(
     if (is_transmit() && index < data_array_size)
     {
         data_array[index] = value;
+        data_version += 1;
         set_updated_time_to_now();
         return true;
     }
@@ -110,45 +169,263 @@ bool SignalTypeData::get_value(
     }
 }
 
-SignalTypeData::data_size_t SignalTypeData::data_size() const
+bool SignalTypeData::set_data(
+        const data_t* data,
+        const data_size_t size)
 {
-    return data_array_size;
+    if (is_transmit() && size == data_array_size && data != nullptr)
+    {
+        memcpy(data_array, data, data_array_size);
+        data_version += 1;
+        set_updated_time_to_now();
+        return true;
+    }
+    else
+    {
+        return false;
+    }
 }
 
-bool SignalTypeData::serialize(DataWriter& writer) const
+bool SignalTypeData::exchange_data(
+        std::unique_ptr<data_t[]>& buffer,
+        const data_size_t size)
 {
-    bool success =
-            SignalTypeBase::serialize(writer) &&
-            writer.add_uint(data_array_size);
+    if (!is_receive() || size != data_array_size || buffer == nullptr)
+    {
+        return false;
+    }
+    else if (data_array_size <= INLINE_CAPACITY)
+    {
+        // Small arrays remain inline, and so the values are copied instead
+        memcpy(data_array, buffer.get(), data_array_size);
+    }
+    else
+    {
+        data_t* previous_array = data_array_owned ? data_array : nullptr;
+        data_array = buffer.release();
+        data_array_owned = true;
+        buffer.reset(previous_array);
+    }
 
-    for (data_size_t i = 0; i < data_array_size; ++i)
+    return true;
+}
+
+bool SignalTypeData::apply_delta(
+        DataReader& reader,
+        const uint16_t version,
+        const uint16_t base_version,
+        const uint16_t range_count)
+{
+    // Check that every range lies within the array before changing any values
+    DataReader check_reader = reader;
+    bool ranges_valid = true;
+    for (uint16_t i = 0; ranges_valid && i < range_count; ++i)
+    {
+        uint32_t offset = 0;
+        uint16_t length = 0;
+        ranges_valid =
+                check_reader.read_uint(offset) &&
+                check_reader.read_ushort(length) &&
+                offset <= data_array_size &&
+                length <= data_array_size - offset &&
+                check_reader.skip(length);
+    }
+
+    if (!ranges_valid)
+    {
+        return false;
+    }
+    else if (!is_receive() || !can_apply_delta(version, base_version))
+    {
+        reader = check_reader;
+        return false;
+    }
+
+    // Patch the data array in place
+    for (uint16_t i = 0; i < range_count; ++i)
     {
-        success &= writer.add_ubyte(data_array[i]);
+        uint32_t offset = 0;
+        uint16_t length = 0;
+        reader.read_uint(offset);
+        reader.read_ushort(length);
+        reader.read_bytes(data_array + offset, length);
     }
 
-    return success;
+    data_version = version;
+    return true;
 }
 
-bool SignalTypeData::deserialize(DataReader& reader)
+bool SignalTypeData::can_apply_delta(
+        const uint16_t version,
+        const uint16_t base_version) const
 {
-    data_size_t new_size;
-    bool success =
-            SignalTypeBase::deserialize(reader) &&
-            reader.read_uint(new_size);
+    const int16_t version_change = static_cast<int16_t>(version - data_version);
+    return
+            version_known &&
+            keyframe_version == base_version &&
+            version_change > 0;
+}
+
+void SignalTypeData::set_keyframe_version(const uint16_t version)
+{
+    if (is_receive())
+    {
+        data_version = version;
+        keyframe_version = version;
+        version_known = true;
+    }
+}
+
+uint16_t SignalTypeData::get_data_version() const
+{
+    return data_version;
+}
+
+const SignalTypeData::data_t* SignalTypeData::get_data() const
+{
+    return data_array;
+}
+
+void SignalTypeData::set_compression(const DataCompression mode)
+{
+    compression = mode;
+    compressed_valid = false;
+
+    // Release any buffers sized for a previous data array, allocating the
+    // compressed buffer for the current size if required
+    compressed_data.reset();
+    decode_buffer.reset();
+
+    if (compression != DataCompression::None)
+    {
+        compressed_data.reset(new data_t[data_array_size > 0 ? data_array_size : 1]);
+    }
+}
+
+void SignalTypeData::copy_compression(const SignalTypeData& other)
+{
+    compression = other.compression;
+    compressed_valid = false;
+
+    if (compression == DataCompression::None)
+    {
+        return;
+    }
+    else if (compressed_data == nullptr)
+    {
+        compressed_data.reset(new data_t[data_array_size > 0 ? data_array_size : 1]);
+    }
+
+    // Copy the cached compressed values, which match the copied data version
+    if (other.compressed_valid && other.compressed_data != nullptr && other.compressed_size <= data_array_size)
+    {
+        memcpy(compressed_data.get(), other.compressed_data.get(), other.compressed_size);
+        compressed_size = other.compressed_size;
+        compressed_version = other.compressed_version;
+        compressed_valid = true;
+    }
+}
+
+DataCompression SignalTypeData::get_compression() const
+{
+    return compression;
+}
 
-    if (success && new_size == data_array_size)
+const SignalTypeData::data_t* SignalTypeData::get_encoded_data(
+        data_size_t& size,
+        bool& compressed) const
+{
+    if (compression == DataCompression::Lz && data_array_size > 1)
     {
-        for (data_size_t i = 0; i < data_array_size; ++i)
+        // Compress the current values if not already cached, requiring the
+        // compressed values to be smaller than the original values
+        if (!compressed_valid || compressed_version != data_version)
         {
-            success &= reader.read_ubyte(data_array[i]);
+            compressed_size = static_cast<data_size_t>(lz_compress(
+                        data_array,
+                        data_array_size,
+                        compressed_data.get(),
+                        data_array_size - 1));
+            compressed_version = data_version;
+            compressed_valid = true;
         }
 
-        return success;
+        if (compressed_size > 0)
+        {
+            size = compressed_size;
+            compressed = true;
+            return compressed_data.get();
+        }
     }
-    else
+
+    size = data_array_size;
+    compressed = false;
+    return data_array;
+}
+
+bool SignalTypeData::decode_compressed(
+        const data_t* data,
+        const data_size_t size)
+{
+    if (!is_receive() || data == nullptr)
+    {
+        return false;
+    }
+
+    // Decompress into a separate buffer, so that invalid input leaves the values unchanged
+    if (decode_buffer == nullptr)
+    {
+        decode_buffer.reset(new data_t[data_array_size > 0 ? data_array_size : 1]);
+    }
+
+    return
+            lz_decompress(data, size, decode_buffer.get(), data_array_size) &&
+            exchange_data(decode_buffer, data_array_size);
+}
+
+SignalTypeData::data_size_t SignalTypeData::data_size() const
+{
+    return data_array_size;
+}
+
+bool SignalTypeData::serialize(DataWriter& writer) const
+{
+    data_size_t encoded_size = 0;
+    bool compressed = false;
+    const data_t* encoded_data = get_encoded_data(encoded_size, compressed);
+
+    return
+            SignalTypeBase::serialize(writer) &&
+            writer.add_uint(compressed ? (encoded_size | COMPRESSED_SIZE_FLAG) : encoded_size) &&
+            writer.add_bytes(encoded_data, encoded_size);
+}
+
+bool SignalTypeData::deserialize(DataReader& reader)
+{
+    // Full records don't carry a data version, and so deltas may not be applied
+    version_known = false;
+
+    data_size_t new_size;
+    if (!SignalTypeBase::deserialize(reader) || !reader.read_uint(new_size))
     {
         return false;
     }
+    else if ((new_size & COMPRESSED_SIZE_FLAG) != 0)
+    {
+        // Decompress directly from the reader buffer
+        const data_size_t encoded_size = new_size & ~COMPRESSED_SIZE_FLAG;
+        const data_t* encoded_data = nullptr;
+        return
+                encoded_size < data_array_size &&
+                reader.read_span(encoded_data, encoded_size) &&
+                decode_compressed(encoded_data, encoded_size);
+    }
+    else
+    {
+        return
+                new_size == data_array_size &&
+                reader.read_bytes(data_array, data_array_size);
+    }
 }
 
 size_t SignalTypeData::packet_size() const
@@ -156,11 +433,100 @@ size_t SignalTypeData::packet_size() const
     return SignalTypeBase::packet_size() + 4 + data_array_size;
 }
 
-SignalTypeData::~SignalTypeData()
+size_t SignalTypeData::min_packet_size() const
 {
-    if (data_array != nullptr)
+    if (compression != DataCompression::None)
+    {
+        return SignalTypeBase::packet_size() + 4;
+    }
+    else
+    {
+        return packet_size();
+    }
+}
+
+size_t SignalTypeData::encoded_packet_size() const
+{
+    data_size_t encoded_size = 0;
+    bool compressed = false;
+    get_encoded_data(encoded_size, compressed);
+    return SignalTypeBase::packet_size() + 4 + encoded_size;
+}
+
+bool SignalTypeData::save_state_payload(DataWriter& writer) const
+{
+    return
+            writer.add_uint(data_array_size) &&
+            writer.add_bytes(data_array, data_array_size);
+}
+
+bool SignalTypeData::restore_state_payload(DataReader& reader)
+{
+    version_known = false;
+    compressed_valid = false;
+
+    data_size_t saved_size;
+    return
+            reader.read_uint(saved_size) &&
+            saved_size == data_array_size &&
+            reader.read_bytes(data_array, data_array_size);
+}
+
+void SignalTypeData::allocate_array(DataArena* arena)
+{
+    if (data_array_size <= INLINE_CAPACITY)
+    {
+        data_array = inline_data;
+        data_array_owned = false;
+    }
+    else if (arena != nullptr)
+    {
+        data_array = arena->allocate(data_array_size);
+        data_array_owned = false;
+    }
+    else
+    {
+        data_array = new data_t[data_array_size];
+        data_array_owned = true;
+    }
+}
+
+void SignalTypeData::release_array()
+{
+    if (data_array_owned)
     {
         delete[] data_array;
-        data_array = nullptr;
     }
+
+    data_array = inline_data;
+    data_array_owned = false;
+    data_array_size = 0;
+}
+
+void SignalTypeData::take_array(SignalTypeData& other)
+{
+    data_array_size = other.data_array_size;
+
+    if (other.data_array == other.inline_data)
+    {
+        // Inline values must be copied, as the storage is part of the other signal
+        data_array = inline_data;
+        data_array_owned = false;
+        memcpy(inline_data, other.inline_data, data_array_size);
+    }
+    else
+    {
+        // External storage may be taken directly
+        data_array = other.data_array;
+        data_array_owned = other.data_array_owned;
+    }
+
+    other.data_array = other.inline_data;
+    other.data_array_owned = false;
+    other.data_array_size = 0;
+}
+
+SignalTypeData::~SignalTypeData()
+{
+    release_array();
 }
@@ -20,14 +20,18 @@
 
 #include "signal_type_base.h"
 
+#include "data_arena.h"
+#include "data_compress.h"
+
+#include <memory>
+
 namespace efis_signals
 {
 
-// TODO - Replace with VarArray?
-
 /**
  * @brief The SignalTypeData class provides a signal type for
- * an array of byte values
+ * an array of byte values. Small arrays are stored inline within the signal,
+ * and larger arrays are stored in the provided arena, if any, or on the heap
  */
 class SignalTypeData : public SignalTypeBase
 {
@@ -40,10 +44,12 @@ public:
      * @brief SignalTypeData constructs the data array signal
      * @param signal is the signal definition to use
      * @param size is the base size of the data
+     * @param arena is the arena to allocate large data arrays from, or nullptr to use the heap
      */
     SignalTypeData(
             const SignalDef& signal,
-            const data_size_t size);
+            const data_size_t size,
+            DataArena* arena = nullptr);
 
     /**
      * @brief SignalTypeData is a copy constructor for the data values
@@ -58,6 +64,19 @@ public:
      */
     SignalTypeData& operator=(const SignalTypeData& other);
 
+    /**
+     * @brief SignalTypeData is a move constructor for the data values
+     * @param other is the other SignalTypeData to take the data array from
+     */
+    SignalTypeData(SignalTypeData&& other);
+
+    /**
+     * @brief operator = is the move assignment operator for the data type signal
+     * @param other is the other SignalTypeData to take the data array from
+     * @return the original instance updated to hold the other data array
+     */
+    SignalTypeData& operator=(SignalTypeData&& other);
+
     /**
      * @brief set_value sets the array index to the given value (Tx only)
      * @param index is the array index to set
@@ -78,6 +97,111 @@ public:
             const data_size_t index,
             data_t& value) const;
 
+    /**
+     * @brief set_data copies the provided values into the data array (Tx only)
+     * @param data is the values to copy
+     * @param size is the number of values to copy, which must match the array size
+     * @return true if the values were successfully set
+     */
+    bool set_data(
+            const data_t* data,
+            const data_size_t size);
+
+    /**
+     * @brief get_data provides direct read access to the data array
+     * @return a pointer to the data array values
+     */
+    const data_t* get_data() const;
+
+    /**
+     * @brief exchange_data replaces the data array with the provided heap buffer
+     * without copying the values (Rx only). If the current array is heap storage
+     * owned by the signal, the previous array is returned through the buffer
+     * so that it may be reused; otherwise the buffer is left empty
+     * @param buffer is the buffer to take the values from, holding at least the array size
+     * @param size is the number of values in the buffer, which must match the array size
+     * @return true if the values were successfully exchanged
+     */
+    bool exchange_data(
+            std::unique_ptr<data_t[]>& buffer,
+            const data_size_t size);
+
+    /**
+     * @brief apply_delta patches the data array in place from the ranges of a
+     * data_delta record (Rx only). The delta is only applied if the signal holds
+     * the keyframe the delta is based on and the delta is newer than the current
+     * values. The ranges are skipped if the delta is not applied
+     * @param reader is the reader positioned at the first delta range
+     * @param version is the data version after the delta is applied
+     * @param base_version is the keyframe version the delta is based on
+     * @param range_count is the number of ranges in the delta
+     * @return true if the delta was applied
+     */
+    bool apply_delta(
+            DataReader& reader,
+            const uint16_t version,
+            const uint16_t base_version,
+            const uint16_t range_count);
+
+    /**
+     * @brief can_apply_delta determines if a delta is able to be applied to the current values
+     * @param version is the data version after the delta is applied
+     * @param base_version is the keyframe version the delta is based on
+     * @return true if the delta is able to be applied
+     */
+    bool can_apply_delta(
+            const uint16_t version,
+            const uint16_t base_version) const;
+
+    /**
+     * @brief set_keyframe_version records that the full data array has been
+     * received for the provided version (Rx only)
+     * @param version is the version of the received data array
+     */
+    void set_keyframe_version(const uint16_t version);
+
+    /**
+     * @brief get_data_version provides the version of the current data values.
+     * The version is incremented for every change to a transmitted signal
+     * @return the data version
+     */
+    uint16_t get_data_version() const;
+
+    /**
+     * @brief set_compression selects the compression used when sending the data array
+     * @param mode is the compression mode to use
+     */
+    void set_compression(const DataCompression mode);
+
+    /**
+     * @brief get_compression provides the compression used when sending the data array
+     * @return the compression mode
+     */
+    DataCompression get_compression() const;
+
+    /**
+     * @brief get_encoded_data provides the data array as it is to be sent. If
+     * compression is enabled and reduces the size, the compressed values are
+     * provided, cached until the values next change
+     * @param size stores the number of encoded bytes
+     * @param compressed stores true if the encoded bytes are compressed
+     * @return a pointer to the encoded bytes
+     */
+    const data_t* get_encoded_data(
+            data_size_t& size,
+            bool& compressed) const;
+
+    /**
+     * @brief decode_compressed decompresses the provided values into the data
+     * array (Rx only). The array is unchanged if the input is not valid
+     * @param data is the compressed values
+     * @param size is the number of compressed bytes
+     * @return true if the values were successfully decompressed
+     */
+    bool decode_compressed(
+            const data_t* data,
+            const data_size_t size);
+
     /**
      * @brief data_size provides the size of the data array
      * @return the array size
@@ -104,11 +228,82 @@ public:
      */
     virtual size_t packet_size() const override;
 
+    /**
+     * @brief min_packet_size provides the smallest size of the packet, which is
+     * reduced when the data array may be sent compressed
+     * @return the minimum packet size
+     */
+    virtual size_t min_packet_size() const override;
+
+    /**
+     * @brief encoded_packet_size provides the size of the packet as it would be
+     * serialized now, using the compressed size where the data array is compressed
+     * @return the encoded packet size
+     */
+    virtual size_t encoded_packet_size() const override;
+
     /**
      * @brief ~SignalTypeData provides the destructor for the data array
      */
     virtual ~SignalTypeData();
 
+    /**
+     * @brief DELTA_RANGE_SIZE provides the size of the offset and length prefix of each delta range
+     */
+    static const size_t DELTA_RANGE_SIZE = 4 + 2;
+
+    /**
+     * @brief INLINE_CAPACITY provides the largest data array size stored inline
+     */
+    static const data_size_t INLINE_CAPACITY = 64;
+
+    /**
+     * @brief COMPRESSED_SIZE_FLAG is set in the size field of a serialized packet
+     * if the values that follow are compressed
+     */
+    static const data_size_t COMPRESSED_SIZE_FLAG = 0x80000000;
+
+protected:
+    /**
+     * @brief save_state_payload writes the signal value for a checkpoint
+     * @param writer is the data to write to
+     * @return true if able to be written
+     */
+    virtual bool save_state_payload(DataWriter& writer) const override;
+
+    /**
+     * @brief restore_state_payload reads the signal value from a checkpoint
+     * @param reader is the data to read from
+     * @return true if able to be read
+     */
+    virtual bool restore_state_payload(DataReader& reader) override;
+
+protected:
+    /**
+     * @brief allocate_array points the data array at storage for the current array size
+     * @param arena is the arena to allocate from, or nullptr to use the heap
+     */
+    void allocate_array(DataArena* arena);
+
+    /**
+     * @brief release_array releases any heap storage owned by the data array
+     */
+    void release_array();
+
+    /**
+     * @brief take_array takes the data array from the other signal, leaving it empty
+     * @param other is the other signal to take the data array from
+     */
+    void take_array(SignalTypeData& other);
+
+    /**
+     * @brief copy_compression copies the compression mode and cached compressed
+     * values from the other signal, once the data values have been copied. The
+     * compression buffers already allocated for the array are reused
+     * @param other is the other signal to copy from
+     */
+    void copy_compression(const SignalTypeData& other);
+
 protected:
     /**
      * @brief data_array_size provides the size of the data array
@@ -119,6 +314,64 @@ protected:
      * @brief data_array provides the actual data values for the array
      */
     data_t* data_array;
+
+    /**
+     * @brief data_array_owned is true if the data array is heap storage owned by this signal
+     */
+    bool data_array_owned;
+
+    /**
+     * @brief data_version provides the version of the current data values
+     */
+    uint16_t data_version;
+
+    /**
+     * @brief keyframe_version provides the version of the last full data array received
+     */
+    uint16_t keyframe_version;
+
+    /**
+     * @brief version_known is true if the received data values have a known version
+     */
+    bool version_known;
+
+    /**
+     * @brief compression provides the compression mode used when sending the data array
+     */
+    DataCompression compression;
+
+    /**
+     * @brief compressed_data provides the cached compressed values, allocated when
+     * compression is enabled
+     */
+    mutable std::unique_ptr<data_t[]> compressed_data;
+
+    /**
+     * @brief compressed_size provides the size of the cached compressed values, or
+     * zero if the values do not compress
+     */
+    mutable data_size_t compressed_size;
+
+    /**
+     * @brief compressed_version provides the data version of the cached compressed values
+     */
+    mutable uint16_t compressed_version;
+
+    /**
+     * @brief compressed_valid is true if the cached compressed values are available
+     */
+    mutable bool compressed_valid;
+
+    /**
+     * @brief decode_buffer provides the buffer that received compressed values are
+     * decompressed into before replacing the data array
+     */
+    std::unique_ptr<data_t[]> decode_buffer;
+
+    /**
+     * @brief inline_data provides the storage for small data arrays
+     */
+    data_t inline_data[INLINE_CAPACITY];
 };
 
 }
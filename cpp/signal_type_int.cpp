@@ -62,3 +62,13 @@ size_t SignalTypeInteger::packet_size() const
 {
     return SignalTypeBase::packet_size() + 4;
 }
+
+bool SignalTypeInteger::save_state_payload(DataWriter& writer) const
+{
+    return writer.add_uint(value);
+}
+
+bool SignalTypeInteger::restore_state_payload(DataReader& reader)
+{
+    return reader.read_uint(value);
+}
@@ -69,6 +69,21 @@ public:
      */
     virtual size_t packet_size() const override;
 
+protected:
+    /**
+     * @brief save_state_payload writes the signal value for a checkpoint
+     * @param writer is the data to write to
+     * @return true if able to be written
+     */
+    virtual bool save_state_payload(DataWriter& writer) const override;
+
+    /**
+     * @brief restore_state_payload reads the signal value from a checkpoint
+     * @param reader is the data to read from
+     * @return true if able to be read
+     */
+    virtual bool restore_state_payload(DataReader& reader) override;
+
 protected:
     /**
      * @brief value is the underlying data value
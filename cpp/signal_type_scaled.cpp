@@ -17,13 +17,19 @@
 
 #include "signal_type_scaled.h"
 
+#include <cmath>
+
 using namespace efis_signals;
 
 SignalTypeScaled::SignalTypeScaled(
         const SignalDef& signal,
-        const double resolution) :
+        const ScaledResolution& scale) :
     SignalTypeBase(signal),
-    value(resolution)
+    value(),
+    scale(&scale),
+    transmitted_value(0),
+    deadband_mode(DeadbandMode::None),
+    deadband(0.0)
 {
     // Empty Constructor
 }
@@ -32,7 +38,21 @@ bool SignalTypeScaled::set_value(const double input)
 {
     if (is_transmit())
     {
-        value.set_value(input);
+        value.set_value(input, *scale);
+        set_updated_time_to_now();
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool SignalTypeScaled::set_raw_value(const uint32_t raw)
+{
+    if (is_transmit())
+    {
+        value.set_raw_value(raw);
         set_updated_time_to_now();
         return true;
     }
@@ -44,7 +64,7 @@ bool SignalTypeScaled::set_value(const double input)
 
 double SignalTypeScaled::get_value() const
 {
-    return value.get_value();
+    return value.get_value(*scale);
 }
 
 const DataTypeScaled& SignalTypeScaled::get_data_value() const
@@ -52,6 +72,41 @@ const DataTypeScaled& SignalTypeScaled::get_data_value() const
     return value;
 }
 
+const ScaledResolution& SignalTypeScaled::get_scale() const
+{
+    return *scale;
+}
+
+void SignalTypeScaled::set_deadband(
+        const DeadbandMode mode,
+        const double deadband)
+{
+    deadband_mode = mode;
+    this->deadband = deadband;
+}
+
+void SignalTypeScaled::set_transmitted(const timestamp_t now)
+{
+    SignalTypeBase::set_transmitted(now);
+    transmitted_value = static_cast<int32_t>(value.get_raw_value());
+}
+
+bool SignalTypeScaled::is_change_significant() const
+{
+    const double last = static_cast<double>(transmitted_value) * scale->resolution;
+    const double change = std::fabs(value.get_value(*scale) - last);
+
+    switch (deadband_mode)
+    {
+    case DeadbandMode::Absolute:
+        return change > deadband;
+    case DeadbandMode::Relative:
+        return change > std::fabs(last) * deadband;
+    default:
+        return true;
+    }
+}
+
 bool SignalTypeScaled::serialize(DataWriter& writer) const
 {
     return
@@ -77,7 +132,37 @@ bool SignalTypeScaled::deserialize(DataReader& reader)
     }
 }
 
+bool SignalTypeScaled::deserialize_rescaled(
+        DataReader& reader,
+        const double source_resolution)
+{
+    uint32_t raw_value = 0;
+    const bool success =
+            SignalTypeBase::deserialize(reader) &&
+            reader.read_uint(raw_value);
+
+    if (success)
+    {
+        value.set_value(static_cast<int32_t>(raw_value) * source_resolution, *scale);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
 size_t SignalTypeScaled::packet_size() const
 {
     return SignalTypeBase::packet_size() + 4;
 }
+
+bool SignalTypeScaled::save_state_payload(DataWriter& writer) const
+{
+    return writer.add_scaled(value);
+}
+
+bool SignalTypeScaled::restore_state_payload(DataReader& reader)
+{
+    return reader.read_scaled(value);
+}
@@ -25,6 +25,17 @@
 namespace efis_signals
 {
 
+/**
+ * @brief The DeadbandMode enum provides the comparison used to determine if
+ * a change in a scaled value is large enough to transmit
+ */
+enum class DeadbandMode
+{
+    None = 0,
+    Absolute = 1,
+    Relative = 2
+};
+
 /**
  * @brief The SignalTypeScaled class provides a signal type
  * to hold a floating point value scaled into a 4-byte integer
@@ -36,11 +47,20 @@ public:
     /**
      * @brief SignalTypeScaled constructs the scaled data type
      * @param signal is the signal definition to use
-     * @param resolution is the resolution of the scaled data
+     * @param scale is the shared resolution of the scaled data, which must remain
+     * available for the lifetime of the signal
+     */
+    SignalTypeScaled(
+            const SignalDef& signal,
+            const ScaledResolution& scale);
+
+    /**
+     * @brief SignalTypeScaled is deleted for temporary resolutions, which would
+     * not outlive the signal
      */
     SignalTypeScaled(
             const SignalDef& signal,
-            const double resolution);
+            const ScaledResolution&& scale) = delete;
 
     /**
      * @brief set_value sets the scaled data value (Tx only)
@@ -61,6 +81,31 @@ public:
      */
     const DataTypeScaled& get_data_value() const;
 
+    /**
+     * @brief get_scale provides the shared resolution of the signal
+     * @return the resolution of the scaled data
+     */
+    const ScaledResolution& get_scale() const;
+
+    /**
+     * @brief set_deadband sets the change threshold for transmission. Values
+     * within the deadband of the last transmitted value are only sent once the
+     * keep-alive deadline is reached
+     * @param mode is the deadband comparison mode
+     * @param deadband is the band in engineering units for absolute mode, or a
+     * fraction of the last transmitted value for relative mode
+     */
+    void set_deadband(
+            const DeadbandMode mode,
+            const double deadband);
+
+    /**
+     * @brief set_transmitted records that the signal has been transmitted,
+     * storing the transmitted value for deadband comparison
+     * @param now is the time of transmission
+     */
+    virtual void set_transmitted(const timestamp_t now) override;
+
     /**
      * @brief serialize writes signal (Tx only)
      * @param writer is the data to write to
@@ -75,17 +120,77 @@ public:
      */
     virtual bool deserialize(DataReader& reader) override;
 
+    /**
+     * @brief deserialize_rescaled reads the signal from the reader, converting the
+     * raw value from the provided resolution to the signal resolution (Rx only)
+     * @param reader is the data to read from
+     * @param source_resolution is the resolution the raw value was sent with
+     * @return true if able to be read
+     */
+    virtual bool deserialize_rescaled(
+            DataReader& reader,
+            const double source_resolution) override;
+
     /**
      * @brief size provides the size of the packet, not including the header
      * @return the packet size
      */
     virtual size_t packet_size() const override;
 
+protected:
+    /**
+     * @brief is_change_significant determines if the current value is outside
+     * of the deadband around the last transmitted value
+     * @return true if the change should be transmitted
+     */
+    virtual bool is_change_significant() const override;
+
+    /**
+     * @brief set_raw_value sets the underlying raw data value (Tx only)
+     * @param raw is the new raw value to set
+     * @return true if the value can be set
+     */
+    bool set_raw_value(const uint32_t raw);
+
+    /**
+     * @brief save_state_payload writes the signal value for a checkpoint
+     * @param writer is the data to write to
+     * @return true if able to be written
+     */
+    virtual bool save_state_payload(DataWriter& writer) const override;
+
+    /**
+     * @brief restore_state_payload reads the signal value from a checkpoint
+     * @param reader is the data to read from
+     * @return true if able to be read
+     */
+    virtual bool restore_state_payload(DataReader& reader) override;
+
 protected:
     /**
      * @brief data provides the underlying data value
      */
     DataTypeScaled value;
+
+    /**
+     * @brief scale provides the shared resolution of the signal definition
+     */
+    const ScaledResolution* scale;
+
+    /**
+     * @brief transmitted_value provides the last transmitted raw value
+     */
+    int32_t transmitted_value;
+
+    /**
+     * @brief deadband_mode provides the deadband comparison mode
+     */
+    DeadbandMode deadband_mode;
+
+    /**
+     * @brief deadband provides the deadband magnitude
+     */
+    double deadband;
 };
 
 }
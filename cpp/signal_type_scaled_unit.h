@@ -0,0 +1,116 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#ifndef TF_SIGNAL_TYPE_SCALED_UNIT_H
+#define TF_SIGNAL_TYPE_SCALED_UNIT_H
+
+#include "signal_type_scaled.h"
+
+namespace efis_signals
+{
+
+/**
+ * @brief The SignalTypeScaledUnit class provides a scaled signal type where the
+ * resolution and engineering units are fixed at compile time. Each signal holds
+ * only the raw value. The SignalTypeScaled accessors take the resolution from the
+ * SCALE data shared by the type, while value() and set() use the compile-time
+ * resolution directly for callers holding the concrete signal type. Each signal
+ * is given its own concrete type deriving from this class, so that signals
+ * sharing a resolution and units remain distinct types
+ * @tparam Resolution provides the resolution as static constexpr double value()
+ * @tparam Units provides the units tag type, with static constexpr const char* name()
+ */
+template <typename Resolution, typename Units>
+class SignalTypeScaledUnit : public SignalTypeScaled
+{
+public:
+    // Define common types
+    using resolution_type = Resolution;
+    using units_type = Units;
+
+    /**
+     * @brief SignalTypeScaledUnit constructs the scaled data type
+     * @param signal is the signal definition to use
+     */
+    SignalTypeScaledUnit(const SignalDef& signal) :
+        SignalTypeScaled(signal, SCALE)
+    {
+        // Empty Constructor
+    }
+
+    /**
+     * @brief SCALE provides the resolution data shared by every signal of the type
+     */
+    static const ScaledResolution SCALE;
+
+    /**
+     * @brief resolution provides the compile-time resolution of the signal
+     * @return the signal resolution
+     */
+    static constexpr double resolution()
+    {
+        return Resolution::value();
+    }
+
+    /**
+     * @brief units provides the engineering units of the signal
+     * @return the units name
+     */
+    static constexpr const char* units()
+    {
+        return Units::name();
+    }
+
+    /**
+     * @brief value provides the current engineering value, scaling the raw value by
+     * the compile-time resolution rather than the shared SCALE data
+     * @return the signal value
+     */
+    double value() const
+    {
+        return static_cast<double>(static_cast<int32_t>(SignalTypeScaled::value.get_raw_value())) * Resolution::value();
+    }
+
+    /**
+     * @brief set sets the engineering value, scaling by the compile-time resolution
+     * rather than the shared SCALE data (Tx only)
+     * @param input is the new value to set
+     * @return true if the value can be set
+     */
+    bool set(const double input)
+    {
+        if (is_transmit())
+        {
+            SignalTypeScaled::value.set_raw_value(static_cast<uint32_t>(
+                    DataTypeScaled::saturate_raw(input * (1.0 / Resolution::value()))));
+            set_updated_time_to_now();
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+};
+
+template <typename Resolution, typename Units>
+const ScaledResolution SignalTypeScaledUnit<Resolution, Units>::SCALE(Resolution::value());
+
+}
+
+#endif // TF_SIGNAL_TYPE_SCALED_UNIT_H
@@ -27,6 +27,7 @@ from .signal_list import SignalList
 from .codegen_file import CodegenSection, CodegenSingle
 from .codegen_cpp_utils import CodegenCppIfMatchFunction, CodegenFileCppHeader, CodegenFileCppSource
 from .signal_def_base import SignalDefinitionBase
+from .signal_def_data import SignalDefinitionData
 from .signal_def_scaled import SignalDefinitionScaled
 
 
@@ -46,6 +47,46 @@ def _get_signal_version_name() -> str:
     return 'SIGNAL_LIST_VERSION_NUM'
 
 
+def _get_signal_fingerprint_name() -> str:
+    """
+    Defines the variable name to use for the signal list fingerprint
+    :return: the signal list fingerprint variable name
+    """
+    return 'SIGNAL_LIST_FINGERPRINT'
+
+
+def _get_revision_count_name() -> str:
+    """
+    Defines the variable name to use for the signal list revision count
+    :return: the revision count variable name
+    """
+    return 'SIGNAL_REVISION_COUNT'
+
+
+def _get_revision_list_name() -> str:
+    """
+    Defines the variable name to use for the signal list revision list
+    :return: the revision list variable name
+    """
+    return 'SIGNAL_REVISION_LIST'
+
+
+def _get_device_count_name() -> str:
+    """
+    Defines the variable name to use for the device count
+    :return: the device count variable name
+    """
+    return 'SIGNAL_DEVICE_COUNT'
+
+
+def _get_device_list_name() -> str:
+    """
+    Defines the variable name to use for the device list
+    :return: the device list variable name
+    """
+    return 'SIGNAL_DEVICE_LIST'
+
+
 def _signal_def_name(signal: SignalDefinitionBase) -> str:
     """
     Provides a signal ID variable name
@@ -64,6 +105,56 @@ def _signal_var_name(signal: SignalDefinitionBase) -> str:
     return 'signal_{:s}'.format(signal.name.lower())
 
 
+def _camel_case_name(name: str) -> str:
+    """
+    Provides a CamelCase identifier for the provided name, splitting on any non-alphanumeric characters
+    :param name: the name to convert
+    :return: the CamelCase identifier
+    """
+    parts = ''.join(c if c.isalnum() else ' ' for c in name.replace('/', ' per ')).split()
+    return ''.join(p[0].upper() + p[1:] for p in parts)
+
+
+def _resolution_type_name(signal: SignalDefinitionScaled) -> str:
+    """
+    Provides the compile-time resolution type name for a scaled signal
+    :param signal: the signal to generate the name for
+    :return: the associated type name
+    """
+    if signal.resolution_name is not None:
+        suffix = _camel_case_name(signal.resolution_name)
+    else:
+        suffix = '{:g}'.format(signal.resolution).replace('.', 'p').replace('-', 'm').replace('+', '')
+    return 'Resolution{:s}'.format(suffix)
+
+
+def _units_type_name(signal: SignalDefinitionScaled) -> str:
+    """
+    Provides the compile-time units type name for a scaled signal
+    :param signal: the signal to generate the name for
+    :return: the associated type name
+    """
+    return 'Units{:s}'.format(_camel_case_name(signal.units))
+
+
+def _signal_type_name(signal: SignalDefinitionBase) -> str:
+    """
+    Provides the concrete signal type name for a signal
+    :param signal: the signal to generate the name for
+    :return: the associated type name
+    """
+    return 'SignalType{:s}'.format(_camel_case_name(signal.name))
+
+
+def _scaled_signals(signal_list: SignalList) -> typing.List[SignalDefinitionScaled]:
+    """
+    Provides the scaled signals within the signal list
+    :param signal_list: the signal list to search
+    :return: the list of scaled signals
+    """
+    return [s for s in signal_list.definitions.values() if isinstance(s, SignalDefinitionScaled)]
+
+
 def _func_signal_def_for_name_callable(signal: SignalDefinitionBase) -> typing.Tuple[str, typing.List[str]]:
     """
     # TODO
@@ -180,9 +271,84 @@ def _generate_signal_def_hdr() -> CodegenFileCppHeader:
         section=CodegenSingle(
             printer=lambda _: ['extern const uint32_t {:s};'.format(_get_signal_version_name())]))
 
+    # Add the signal list fingerprint and the older revisions that can be translated
+    codegen.add_section(
+        section=CodegenSingle(
+            printer=lambda _: [
+                '/**',
+                ' * @brief {:s} provides the hash of the parameters that define how each signal'.format(
+                    _get_signal_fingerprint_name()),
+                ' * is sent, which is sent in the frame information so that receivers can check it',
+                ' */',
+                'extern const uint32_t {:s};'.format(_get_signal_fingerprint_name()),
+                '',
+                '/**',
+                ' * @brief {:s} provides the number of older signal list revisions'.format(
+                    _get_revision_count_name()),
+                ' */',
+                'extern const size_t {:s};'.format(_get_revision_count_name()),
+                '',
+                '/**',
+                ' * @brief {:s} provides the older signal list revisions that can be translated to'.format(
+                    _get_revision_list_name()),
+                ' * the current signal list, in ascending version order, or nullptr if there are none',
+                ' */',
+                'extern const SignalRevisionDef* const {:s};'.format(_get_revision_list_name())]))
+
     # Add the signal definition list printer
     codegen.add_section(section=CodegenSection(signal_printer=signal_def_extern_printer))
 
+    # Add the device list
+    codegen.add_section(
+        section=CodegenSingle(
+            printer=lambda _: [
+                '/**',
+                ' * @brief {:s} provides the number of devices within the signal list'.format(
+                    _get_device_count_name()),
+                ' */',
+                'extern const size_t {:s};'.format(_get_device_count_name()),
+                '',
+                '/**',
+                ' * @brief {:s} provides the devices within the signal list, in ascending device ID order'.format(
+                    _get_device_list_name()),
+                ' */',
+                'extern const SignalDeviceDef {:s}[];'.format(_get_device_list_name())]))
+
+    # Add the category and device enumerations
+    def id_enum_printer(
+            enum_name: str,
+            description: str,
+            values: typing.List[typing.Tuple[str, int]]) -> typing.List[str]:
+        lines = [
+            '/**',
+            ' * @brief The {0:s} enum provides the {1:s} IDs within the signal list'.format(
+                enum_name,
+                description),
+            ' */',
+            'enum class {:s} : uint8_t'.format(enum_name),
+            '{']
+        for i, (value_name, value_id) in enumerate(values):
+            lines.append('    {0:s} = {1:d}{2:s}'.format(
+                _camel_case_name(value_name),
+                value_id,
+                ',' if i + 1 < len(values) else ''))
+        lines.append('};')
+        return lines
+
+    codegen.add_section(
+        section=CodegenSingle(
+            printer=lambda signal_list: id_enum_printer(
+                enum_name='SignalCategory',
+                description='category',
+                values=signal_list.get_sorted_categories())))
+
+    codegen.add_section(
+        section=CodegenSingle(
+            printer=lambda signal_list: id_enum_printer(
+                enum_name='SignalDevice',
+                description='device',
+                values=signal_list.get_sorted_devices())))
+
     # Add signal definition functions
     codegen.add_section(section=FUNC_SIGNAL_DEF_FOR_NAME.codegen_for_header())
     codegen.add_section(section=FUNC_SIGNAL_NAME_FOR_DEF.codegen_for_header())
@@ -216,6 +382,59 @@ def _generate_signal_def_src() -> CodegenFileCppSource:
                     _get_signal_version_name(),
                     signal_list.version)]))
 
+    # Add the signal list fingerprint and the revision translation tables
+    def revision_list_printer(signal_list: SignalList) -> typing.List[str]:
+        revisions = signal_list.get_sorted_revisions()
+        lines = [
+            'const uint32_t {0:s}::{1:s} = 0x{2:08x};'.format(
+                _get_namespace_name(),
+                _get_signal_fingerprint_name(),
+                signal_list.get_fingerprint())]
+
+        for revision in revisions:
+            if len(revision.translations) == 0:
+                continue
+
+            lines.extend([
+                '',
+                'static const SignalTranslationDef signal_revision_{0:d}_translations[] = {{'.format(
+                    revision.version)])
+            for translation in revision.translations:
+                lines.append('    {{ {0:d}, {1:d}, {2:s}, {3:.24e} }},'.format(
+                    translation.from_index,
+                    translation.to_index if translation.to_index is not None else 0,
+                    'true' if translation.to_index is None else 'false',
+                    translation.source_resolution if translation.source_resolution is not None else 0.0))
+            lines.append('};')
+
+        if len(revisions) > 0:
+            lines.extend([
+                '',
+                'static const SignalRevisionDef signal_revision_list[] = {'])
+            for revision in revisions:
+                lines.append('    {{ {0:d}, 0x{1:08x}, {2:s}, {3:d} }},'.format(
+                    revision.version,
+                    revision.fingerprint,
+                    'signal_revision_{:d}_translations'.format(revision.version)
+                    if len(revision.translations) > 0 else 'nullptr',
+                    len(revision.translations)))
+            lines.append('};')
+
+        lines.extend([
+            '',
+            'const size_t {0:s}::{1:s} = {2:d};'.format(
+                _get_namespace_name(),
+                _get_revision_count_name(),
+                len(revisions)),
+            '',
+            'const SignalRevisionDef* const {0:s}::{1:s} = {2:s};'.format(
+                _get_namespace_name(),
+                _get_revision_list_name(),
+                'signal_revision_list' if len(revisions) > 0 else 'nullptr')])
+        return lines
+
+    codegen.add_section(section=CodegenSingle(printer=revision_list_printer))
+
     # Add the constructor section for the different signal definition constructors
     def signal_def_constructor_printer(_, __, signal: SignalDefinitionBase) -> typing.List[str]:
         return [
@@ -228,6 +447,25 @@ def _generate_signal_def_src() -> CodegenFileCppSource:
 
     codegen.add_section(section=CodegenSection(signal_printer=signal_def_constructor_printer))
 
+    # Add the device list
+    def device_list_printer(signal_list: SignalList) -> typing.List[str]:
+        devices = signal_list.get_sorted_devices()
+        lines = [
+            'const size_t {0:s}::{1:s} = {2:d};'.format(
+                _get_namespace_name(),
+                _get_device_count_name(),
+                len(devices)),
+            '',
+            'const SignalDeviceDef {0:s}::{1:s}[] = {{'.format(
+                _get_namespace_name(),
+                _get_device_list_name())]
+        for device_name, device_id in devices:
+            lines.append('    {{ "{0:s}", {1:d} }},'.format(device_name, device_id))
+        lines.append('};')
+        return lines
+
+    codegen.add_section(section=CodegenSingle(printer=device_list_printer))
+
     # Add signal definition functions
     codegen.add_section(section=FUNC_SIGNAL_DEF_FOR_NAME.section_for_source())
     codegen.add_section(section=FUNC_SIGNAL_NAME_FOR_DEF.section_for_source())
@@ -240,6 +478,87 @@ def _generate_signal_def_src() -> CodegenFileCppSource:
     return codegen
 
 
+def _generate_signal_types_hdr() -> CodegenFileCppHeader:
+    """
+    Provides the code generator required to generate the concrete signal types header file,
+    for gen_signal_types.h
+    :return: the associated C++ header code generator
+    """
+    codegen = CodegenFileCppHeader(
+        base_name='signal_types',
+        namespace=_get_namespace_name())
+
+    # Define the resolution tag types, one per unique resolution
+    def resolution_printer(signal_list: SignalList) -> typing.List[str]:
+        resolutions = dict()
+        for signal in _scaled_signals(signal_list=signal_list):
+            resolutions[_resolution_type_name(signal=signal)] = signal.resolution
+
+        lines = list()
+        for name, resolution in resolutions.items():
+            if len(lines) > 0:
+                lines.append('')
+            lines.extend([
+                '/**',
+                ' * @brief {:s} provides the compile-time resolution {:g}'.format(name, resolution),
+                ' */',
+                'struct {:s}'.format(name),
+                '{',
+                '    static constexpr double value() {{ return {:.24e}; }}'.format(resolution),
+                '};'])
+        return lines
+
+    # Define the units tag types, one per unique unit
+    def units_printer(signal_list: SignalList) -> typing.List[str]:
+        units = dict()
+        for signal in _scaled_signals(signal_list=signal_list):
+            units[_units_type_name(signal=signal)] = signal.units
+
+        lines = list()
+        for name, unit in units.items():
+            if len(lines) > 0:
+                lines.append('')
+            lines.extend([
+                '/**',
+                ' * @brief {:s} provides the units tag for {:s}'.format(name, unit),
+                ' */',
+                'struct {:s}'.format(name),
+                '{',
+                '    static constexpr const char* name() {{ return "{:s}"; }}'.format(unit),
+                '};'])
+        return lines
+
+    # Define the concrete signal types
+    def signal_type_printer(_, __, signal: SignalDefinitionBase) -> typing.List[str]:
+        if isinstance(signal, SignalDefinitionScaled):
+            return [
+                '/**',
+                ' * @brief {:s} is the concrete signal type for the {:s}'.format(
+                    _signal_type_name(signal=signal),
+                    signal.description),
+                ' */',
+                'class {:s} : public SignalTypeScaledUnit<{:s}, {:s}>'.format(
+                    _signal_type_name(signal=signal),
+                    _resolution_type_name(signal=signal),
+                    _units_type_name(signal=signal)),
+                '{',
+                'public:',
+                '    using SignalTypeScaledUnit::SignalTypeScaledUnit;',
+                '};']
+        else:
+            return list()
+
+    codegen.add_section(section=CodegenSingle(printer=resolution_printer))
+    codegen.add_section(section=CodegenSingle(printer=units_printer))
+    codegen.add_section(section=CodegenSection(signal_printer=signal_type_printer))
+
+    # Add include parameters
+    codegen.add_include_file('signal_type_scaled_unit.h')
+
+    # Return the code generator
+    return codegen
+
+
 def _generate_signal_db_src() -> CodegenFileCppSource:
     """
     Provides the code generator required to generate the signal database file,
@@ -257,8 +576,11 @@ def _generate_signal_db_src() -> CodegenFileCppSource:
         constructor_args = [_signal_def_name(signal=signal)]
 
         if isinstance(signal, SignalDefinitionScaled):
-            signal_type = 'SignalTypeScaled'
-            constructor_args.append('{:.24e}'.format(signal.resolution))
+            signal_type = _signal_type_name(signal=signal)
+        elif isinstance(signal, SignalDefinitionData):
+            signal_type = 'SignalTypeData'
+            constructor_args.append('{0:d}'.format(signal.size))
+            constructor_args.append('&data_arena')
         elif type(signal) == SignalDefinitionBase:
             signal_type = 'SignalTypeBase'
         else:
@@ -270,6 +592,30 @@ def _generate_signal_db_src() -> CodegenFileCppSource:
             signal_type,
             _signal_var_name(signal=signal),
             ', '.join(constructor_args)))
+
+        # Add transmit configuration parameters
+        if isinstance(signal, SignalDefinitionScaled) and signal.deadband is not None:
+            src_list.append('    {0:s}.set_deadband(DeadbandMode::{1:s}, {2:.24e});'.format(
+                _signal_var_name(signal=signal),
+                signal.deadband_mode.capitalize(),
+                signal.deadband))
+
+        if isinstance(signal, SignalDefinitionData) and signal.compression != 'none':
+            src_list.append('    {0:s}.set_compression(DataCompression::{1:s});'.format(
+                _signal_var_name(signal=signal),
+                signal.compression.capitalize()))
+
+        if signal.min_interval_milliseconds > 0:
+            src_list.append('    {0:s}.set_min_interval({1:d});'.format(
+                _signal_var_name(signal=signal),
+                signal.min_interval_milliseconds))
+
+        if signal.rate_limit_rate > 0:
+            src_list.append('    rate_limiter.set_signal_limit({0:s}.signal_index(), {1:d}, {2:d});'.format(
+                _signal_def_name(signal=signal),
+                signal.rate_limit_rate,
+                signal.rate_limit_burst))
+
         src_list.append('    signal_array[{0:s}.signal_index()] = dynamic_cast<SignalTypeBase*>(&{1:});'.format(
             _signal_def_name(signal=signal),
             _signal_var_name(signal=signal)))
@@ -278,19 +624,47 @@ def _generate_signal_db_src() -> CodegenFileCppSource:
         return src_list
 
     func_sec = CodegenSection(signal_printer=signal_static_func_printer)
-    func_sec.init_callable = lambda _: [
-        'void SignalDatabase::init_signals()',
-        '{']
-    func_sec.end_callable = lambda _: [
-        '}',
-        '']
+    def init_func_printer(signal_list: SignalList) -> typing.List[str]:
+        init_list = [
+            'void SignalDatabase::init_signals()',
+            '{']
+
+        # Provide the arena for data signals, sharing the lifetime of the static signals
+        if any(isinstance(s, SignalDefinitionData) for s in signal_list.definitions.values()):
+            init_list.append('    static DataArena data_arena;')
+            init_list.append('')
+
+        return init_list
+
+    def end_func_printer(signal_list: SignalList) -> typing.List[str]:
+        end_list = list()
+
+        # Add the receive rate limits for each device
+        device_limits = signal_list.get_sorted_device_rate_limits()
+        if len(device_limits) > 0:
+            end_list.append('')
+            for device_id, rate, burst in device_limits:
+                end_list.append('    rate_limiter.set_device_limit({0:d}, {1:d}, {2:d});'.format(
+                    device_id,
+                    rate,
+                    burst))
+
+        end_list.extend([
+            '}',
+            ''])
+        return end_list
+
+    func_sec.init_callable = init_func_printer
+    func_sec.end_callable = end_func_printer
     codegen.add_section(section=func_sec)
 
     # Add required include files
     codegen.add_include_file('signal_database.h')
     codegen.add_include_file('signal_type_base.h')
     codegen.add_include_file('signal_type_scaled.h')
+    codegen.add_include_file('signal_type_data.h')
     codegen.add_include_file('gen_signal_def.h')
+    codegen.add_include_file('gen_signal_types.h')
 
     # Return the generator
     return codegen
@@ -303,7 +677,13 @@ def generate_cpp_code(signal_list: SignalList, target_dir: pathlib.Path) -> None
     :param target_dir: the target directory to put the generated code in
     """
     # Run the code generation for each individual file
-    for codegen in (_generate_signal_def_hdr(), _generate_signal_def_src(), _generate_signal_db_src()):
+    generators = (
+        _generate_signal_def_hdr(),
+        _generate_signal_def_src(),
+        _generate_signal_types_hdr(),
+        _generate_signal_db_src())
+
+    for codegen in generators:
         codegen.generate_code(
             target_dir=target_dir,
             signal_list=signal_list)
@@ -113,16 +113,18 @@ class CodegenSection(CodegenInterface):
         total_list.extend(self.init_callable(signal_list))
 
         # Loop through each signal
+        has_signal_lines = False
         for i, signal in enumerate(signal_list.definitions.values()):
             # Determine the text to write for the signal
             signal_lines = self.signal_printer(i, signal_list, signal)
 
             # Add spacing if the number of signal lines is sufficient
-            if i > 0 and len(signal_lines) > 1 and self.item_separation:
+            if has_signal_lines and len(signal_lines) > 1 and self.item_separation:
                 total_list.append('')
 
             # Write the signal lines
             total_list.extend(signal_lines)
+            has_signal_lines = has_signal_lines or len(signal_lines) > 0
 
         # Add the ending init and ending function
         total_list.extend(self.end_callable(signal_list))
@@ -25,6 +25,26 @@ import typing
 JSON_DICT_TYPE = typing.Dict[str, typing.Union[str, float, int]]
 
 
+def parse_rate_limit(limit: typing.Optional[typing.Dict[str, int]]) -> typing.Tuple[int, int]:
+    """
+    Parses a rate limit definition, in the form {"rate": records per second, "burst": records}
+    :param limit: the JSON dictionary definition for the rate limit, or None if unlimited
+    :return: the rate and burst values, or zeros if unlimited
+    """
+    if limit is None:
+        return 0, 0
+
+    rate = limit.get('rate', None)
+    burst = limit.get('burst', rate)
+
+    if not isinstance(rate, int) or rate <= 0:
+        raise ValueError('rate limit rate must be an integer > 0')
+    elif not isinstance(burst, int) or burst <= 0:
+        raise ValueError('rate limit burst must be an integer > 0')
+    else:
+        return rate, burst
+
+
 class SignalDefinitionBase:
     """
     Class to maintain the definition for a signal type
@@ -36,7 +56,10 @@ class SignalDefinitionBase:
             sub_id: int,
             name: str,
             description: str,
-            timeout_millisecond: int):
+            timeout_millisecond: int,
+            min_interval_millisecond: int = 0,
+            rate_limit_rate: int = 0,
+            rate_limit_burst: int = 0):
         """
         Creates a signal definition for the provided input parameters
         :param cat_id: the category ID for the signal
@@ -44,12 +67,33 @@ class SignalDefinitionBase:
         :param name: the name of the signal
         :param description: the description for the signal
         :param timeout_millisecond: the number of milliseconds until timeout for the signal
+        :param min_interval_millisecond: the minimum number of milliseconds between transmissions of changes
+        :param rate_limit_rate: the number of received records per second allowed for the signal, or zero if unlimited
+        :param rate_limit_burst: the number of received records that may arrive at once within the rate limit
         """
         self.cat_id = cat_id
         self.sub_id = sub_id
         self.name = name
         self.description = description
         self.timeout_milliseconds = timeout_millisecond
+        self.min_interval_milliseconds = min_interval_millisecond
+        self.rate_limit_rate = rate_limit_rate
+        self.rate_limit_burst = rate_limit_burst
+
+    def signal_index(self) -> int:
+        """
+        Provides the combined category and signal ID, as used in the signal header
+        :return: the signal index
+        """
+        return self.cat_id * 256 + self.sub_id
+
+    def wire_descriptor(self) -> str:
+        """
+        Provides a description of the parameters that define how the signal is sent, used
+        to determine the signal list fingerprint
+        :return: the wire descriptor for the signal
+        """
+        return '{:d}/{:d}:base'.format(self.cat_id, self.sub_id)
 
     @staticmethod
     def _get_base_args(sig_def: JSON_DICT_TYPE) -> JSON_DICT_TYPE:
@@ -60,6 +104,7 @@ class SignalDefinitionBase:
         """
         name = sig_def['name']
         desc = sig_def['description']
+        rate_limit = parse_rate_limit(sig_def.get('rate_limit', None))
 
         if not isinstance(name, str):
             raise ValueError('name must be provided as a string')
@@ -71,7 +116,10 @@ class SignalDefinitionBase:
                 'sub_id': int(sig_def['sub_id']),
                 'name': sig_def['name'],
                 'description': sig_def['description'],
-                'timeout_millisecond': int(sig_def['timeout'])
+                'timeout_millisecond': int(sig_def['timeout']),
+                'min_interval_millisecond': int(sig_def.get('min_interval', 0)),
+                'rate_limit_rate': rate_limit[0],
+                'rate_limit_burst': rate_limit[1]
             }
 
     @staticmethod
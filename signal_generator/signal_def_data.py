@@ -0,0 +1,99 @@
+"""
+TeaFIS is a cockpit display for aircraft
+Copyright (C) 2021  Ian O'Rourke
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+SignalDefinitionData defines the byte-array data signal definition
+"""
+
+import typing
+
+from .signal_def_base import SignalDefinitionBase
+
+
+class SignalDefinitionData(SignalDefinitionBase):
+    """
+    Class to maintain the definition for a byte-array data signal type
+    """
+
+    # Define the supported compression modes
+    COMPRESSION_MODES = ('none', 'lz')
+
+    def __init__(
+            self,
+            cat_id: int,
+            sub_id: int,
+            name: str,
+            description: str,
+            timeout_millisecond: int,
+            size: int,
+            compression: str = 'none',
+            min_interval_millisecond: int = 0,
+            rate_limit_rate: int = 0,
+            rate_limit_burst: int = 0):
+        """
+        Creates a signal definition for the provided input parameters
+        :param cat_id: the category ID for the signal
+        :param sub_id: the signal ID for the signal
+        :param name: the name of the signal
+        :param description: the description for the signal
+        :param timeout_millisecond: the number of milliseconds until timeout for the signal
+        :param size: the number of bytes in the data array
+        :param compression: the compression mode to use when sending the data array
+        :param min_interval_millisecond: the minimum number of milliseconds between transmissions of changes
+        :param rate_limit_rate: the number of received records per second allowed for the signal, or zero if unlimited
+        :param rate_limit_burst: the number of received records that may arrive at once within the rate limit
+        """
+        super().__init__(
+            cat_id=cat_id,
+            sub_id=sub_id,
+            name=name,
+            description=description,
+            timeout_millisecond=timeout_millisecond,
+            min_interval_millisecond=min_interval_millisecond,
+            rate_limit_rate=rate_limit_rate,
+            rate_limit_burst=rate_limit_burst)
+        self.size = size
+        self.compression = compression
+
+    def wire_descriptor(self) -> str:
+        """
+        Provides a description of the parameters that define how the signal is sent, used
+        to determine the signal list fingerprint
+        :return: the wire descriptor for the signal
+        """
+        return '{:d}/{:d}:data:{:d}:{:s}'.format(self.cat_id, self.sub_id, self.size, self.compression)
+
+    @staticmethod
+    def from_json_def(sig_def: typing.Dict[str, typing.Union[str, float, int]]) -> 'SignalDefinitionBase':
+        """
+        Provides a signal definition from the JSON dictionary definition
+        :param sig_def: the JSON dictionary definition for the signal
+        :return: the signal definition for the values found in the dictionary
+        """
+        size = int(sig_def['size'])
+
+        if size <= 0 or size > 2**32 - 1:
+            raise ValueError('size must be a positive 32-bit integer')
+
+        compression = sig_def.get('compression', 'none')
+        if compression not in SignalDefinitionData.COMPRESSION_MODES:
+            raise ValueError('compression "{:s}" unknown'.format(str(compression)))
+
+        return SignalDefinitionData(
+            size=size,
+            compression=compression,
+            **SignalDefinitionData._get_base_args(sig_def=sig_def))
@@ -34,6 +34,9 @@ class SignalDefinitionScaled(SignalDefinitionBase):
         'semi2deg': 180.0 / 2**31
     }
 
+    # Define the supported deadband modes
+    DEADBAND_MODES = ('absolute', 'relative')
+
     def __init__(
             self,
             cat_id: int,
@@ -42,7 +45,13 @@ class SignalDefinitionScaled(SignalDefinitionBase):
             description: str,
             timeout_millisecond: int,
             units: str,
-            resolution: float):
+            resolution: float,
+            resolution_name: typing.Optional[str] = None,
+            deadband: typing.Optional[float] = None,
+            deadband_mode: str = 'absolute',
+            min_interval_millisecond: int = 0,
+            rate_limit_rate: int = 0,
+            rate_limit_burst: int = 0):
         """
         Creates a signal definition for the provided input parameters
         :param cat_id: the category ID for the signal
@@ -52,15 +61,35 @@ class SignalDefinitionScaled(SignalDefinitionBase):
         :param timeout_millisecond: the number of milliseconds until timeout for the signal
         :param units: the unit associated with the signal
         :param resolution: the resolution to multiply network data by to get the engineering data
+        :param resolution_name: the name of the resolution from the resolution map, if provided by name
+        :param deadband: the change threshold required to transmit a new value, or None to transmit every change
+        :param deadband_mode: the deadband comparison mode, either absolute or relative to the last value sent
+        :param min_interval_millisecond: the minimum number of milliseconds between transmissions of changes
+        :param rate_limit_rate: the number of received records per second allowed for the signal, or zero if unlimited
+        :param rate_limit_burst: the number of received records that may arrive at once within the rate limit
         """
         super().__init__(
             cat_id=cat_id,
             sub_id=sub_id,
             name=name,
             description=description,
-            timeout_millisecond=timeout_millisecond)
+            timeout_millisecond=timeout_millisecond,
+            min_interval_millisecond=min_interval_millisecond,
+            rate_limit_rate=rate_limit_rate,
+            rate_limit_burst=rate_limit_burst)
         self.units = units
         self.resolution = resolution
+        self.resolution_name = resolution_name
+        self.deadband = deadband
+        self.deadband_mode = deadband_mode
+
+    def wire_descriptor(self) -> str:
+        """
+        Provides a description of the parameters that define how the signal is sent, used
+        to determine the signal list fingerprint
+        :return: the wire descriptor for the signal
+        """
+        return '{:d}/{:d}:scaled:{:.17g}'.format(self.cat_id, self.sub_id, self.resolution)
 
     @staticmethod
     def from_json_def(sig_def: typing.Dict[str, typing.Union[str, float, int]]) -> 'SignalDefinitionBase':
@@ -71,7 +100,9 @@ class SignalDefinitionScaled(SignalDefinitionBase):
         :return: the signal definition for the values found in the line
         """
         resolution = sig_def['resolution']
+        resolution_name = None
         if isinstance(resolution, str):
+            resolution_name = resolution
             resolution = SignalDefinitionScaled.RESOLUTION_MAP[resolution]
         else:
             resolution = float(resolution)
@@ -81,7 +112,20 @@ class SignalDefinitionScaled(SignalDefinitionBase):
         if not isinstance(units, str):
             raise ValueError('units flag must be provided as a string')
 
+        deadband = sig_def.get('deadband', None)
+        if deadband is not None:
+            deadband = float(deadband)
+            if deadband < 0:
+                raise ValueError('deadband must be non-negative')
+
+        deadband_mode = sig_def.get('deadband_mode', 'absolute')
+        if deadband_mode not in SignalDefinitionScaled.DEADBAND_MODES:
+            raise ValueError('deadband_mode "{:s}" unknown'.format(str(deadband_mode)))
+
         return SignalDefinitionScaled(
             units=units,
             resolution=resolution,
+            resolution_name=resolution_name,
+            deadband=deadband,
+            deadband_mode=deadband_mode,
             **SignalDefinitionScaled._get_base_args(sig_def=sig_def))
@@ -24,8 +24,33 @@ import os
 import pathlib
 import typing
 
-from .signal_def_base import SignalDefinitionBase
+from .signal_def_base import SignalDefinitionBase, parse_rate_limit
+from .signal_def_data import SignalDefinitionData
 from .signal_def_scaled import SignalDefinitionScaled
+from .signal_revision import SignalRevision, schema_fingerprint
+
+
+def definition_from_json(sig_def: typing.Dict[str, typing.Any]) -> SignalDefinitionBase:
+    """
+    Creates a signal definition of the type given in the JSON dictionary definition
+    :param sig_def: the JSON dictionary definition for the signal
+    :return: the corresponding signal definition
+    """
+    # Extract the signal type
+    sig_type = sig_def['type']
+
+    # Switch based on the signal type
+    if sig_type == 'base':
+        sig_type_obj = SignalDefinitionBase
+    elif sig_type == 'scaled':
+        sig_type_obj = SignalDefinitionScaled
+    elif sig_type == 'data':
+        sig_type_obj = SignalDefinitionData
+    else:
+        raise ValueError('Signal type "{:s}" unknown'.format(sig_type))
+
+    # Call the constructor and create the signal
+    return sig_type_obj.from_json_def(sig_def=sig_def)
 
 
 class SignalList:
@@ -36,14 +61,27 @@ class SignalList:
     def __init__(
             self,
             version: int,
-            definitions: typing.Dict[str, SignalDefinitionBase]):
+            definitions: typing.Dict[str, SignalDefinitionBase],
+            devices: typing.Optional[typing.Dict[str, int]] = None,
+            categories: typing.Optional[typing.Dict[str, int]] = None,
+            device_rate_limits: typing.Optional[typing.Dict[str, typing.Tuple[int, int]]] = None,
+            revisions: typing.Optional[typing.List[SignalRevision]] = None):
         """
         Initializes the signal list object from the provided input definitions
         :param version: the version of the signal list file
         :param definitions: the signal list definitions to use
+        :param devices: the device IDs for each device name in the signal list
+        :param categories: the category IDs for each category name in the signal list
+        :param device_rate_limits: the received record rate and burst limits for each device name
+        :param revisions: the older revisions of the signal list that can be translated to this one
         """
         self.version = version
         self.definitions: typing.Dict[str, SignalDefinitionBase] = definitions
+        self.devices: typing.Dict[str, int] = devices if devices is not None else dict()
+        self.categories: typing.Dict[str, int] = categories if categories is not None else dict()
+        self.device_rate_limits: typing.Dict[str, typing.Tuple[int, int]] = \
+            device_rate_limits if device_rate_limits is not None else dict()
+        self.revisions: typing.List[SignalRevision] = revisions if revisions is not None else list()
 
     def get_definition(self, name: str) -> SignalDefinitionBase:
         """
@@ -56,6 +94,43 @@ class SignalList:
         else:
             raise ValueError('No signal with name "{:s}" found in list'.format(name))
 
+    def get_sorted_devices(self) -> typing.List[typing.Tuple[str, int]]:
+        """
+        Provides a list of the device names and IDs, sorted by ID value
+        :return: the device name and ID list sorted by ID value
+        """
+        return sorted(self.devices.items(), key=lambda x: x[1])
+
+    def get_sorted_categories(self) -> typing.List[typing.Tuple[str, int]]:
+        """
+        Provides a list of the category names and IDs, sorted by ID value
+        :return: the category name and ID list sorted by ID value
+        """
+        return sorted(self.categories.items(), key=lambda x: x[1])
+
+    def get_sorted_device_rate_limits(self) -> typing.List[typing.Tuple[int, int, int]]:
+        """
+        Provides a list of the device rate limits, sorted by device ID value
+        :return: the device ID, rate and burst list sorted by device ID value
+        """
+        return sorted(
+            ((self.devices[name], rate, burst) for name, (rate, burst) in self.device_rate_limits.items()),
+            key=lambda x: x[0])
+
+    def get_fingerprint(self) -> int:
+        """
+        Provides the fingerprint of the signal list, which changes only when the way signals are sent changes
+        :return: the signal list fingerprint
+        """
+        return schema_fingerprint(self.definitions.values())
+
+    def get_sorted_revisions(self) -> typing.List[SignalRevision]:
+        """
+        Provides a list of the older signal list revisions, sorted by version
+        :return: the revision list sorted by version
+        """
+        return sorted(self.revisions, key=lambda x: x.version)
+
     def get_sorted_definitions(self) -> typing.List[SignalDefinitionBase]:
         """
         Provides a list of the signal definitions, sorted by ID value
@@ -82,19 +157,7 @@ class SignalList:
 
         # Read in each signal
         for sig_def in data['signals']:
-            # Extract the signal type
-            sig_type = sig_def['type']
-
-            # Switch based on the signal type
-            if sig_type == 'base':
-                sig_type_obj = SignalDefinitionBase
-            elif sig_type == 'scaled':
-                sig_type_obj = SignalDefinitionScaled
-            else:
-                raise ValueError('Signal type "{:s}" unknown'.format(sig_type))
-
-            # Call the constructor and create the signal
-            created_signal = sig_type_obj.from_json_def(sig_def=sig_def)
+            created_signal = definition_from_json(sig_def=sig_def)
 
             # Check that the signal doesn't already exist in the database
             if created_signal.name in def_list:
@@ -114,11 +177,63 @@ class SignalList:
                     if s1.cat_id == s2.cat_id and s1.sub_id == s2.sub_id:
                         raise ValueError('Cannot have two signals with the same category and signal ids')
 
+        # Read in each device, ensuring that each device has a unique ID that fits in the header
+        devices = dict()
+        for device_name, device_id in data.get('devices', dict()).items():
+            if not isinstance(device_id, int) or device_id < 0 or device_id > 255:
+                raise ValueError('Device {:s} must have an integer ID from 0 to 255'.format(device_name))
+            elif device_id in devices.values():
+                raise ValueError('Cannot have two devices with the same device id')
+            else:
+                devices[device_name] = device_id
+
+        # Read in each category, ensuring that each category has a unique ID that fits in the header
+        categories = dict()
+        for category_name, category_id in data.get('categories', dict()).items():
+            if not isinstance(category_id, int) or category_id < 0 or category_id > 255:
+                raise ValueError('Category {:s} must have an integer ID from 0 to 255'.format(category_name))
+            elif category_id in categories.values():
+                raise ValueError('Cannot have two categories with the same category id')
+            else:
+                categories[category_name] = category_id
+
+        # Read in the device rate limits, which must refer to known devices
+        device_rate_limits = dict()
+        for device_name, limit in data.get('device_rate_limits', dict()).items():
+            if device_name not in devices:
+                raise ValueError('Rate limit provided for unknown device {:s}'.format(device_name))
+            else:
+                device_rate_limits[device_name] = parse_rate_limit(limit)
+
+        # Ensure that every signal is within a known category, if categories are provided
+        if len(categories) > 0:
+            for sig in def_list.values():
+                if sig.cat_id not in categories.values():
+                    raise ValueError('Signal {:s} has unknown category id {:d}'.format(sig.name, sig.cat_id))
+
         # Check to ensure that the version is valid
         if version is None or not isinstance(version, int) or version <= 0:
             raise ValueError('Signal List version must be an integer > 0')
 
+        # Read in the older revisions that can be translated to this signal list
+        revisions = list()
+        for rev_def in data.get('revisions', list()):
+            revision = SignalRevision.from_json_def(
+                rev_def=rev_def,
+                current=def_list,
+                removed=[definition_from_json(sig_def=s) for s in rev_def.get('removed', list())])
+            if revision.version >= version:
+                raise ValueError('Revision {:d} must be older than the signal list'.format(revision.version))
+            elif revision.version in (r.version for r in revisions):
+                raise ValueError('Cannot have two revisions with the same version')
+            else:
+                revisions.append(revision)
+
         # Otherwise, return the results
         return SignalList(
             version=version,
-            definitions=def_list)
+            definitions=def_list,
+            devices=devices,
+            categories=categories,
+            device_rate_limits=device_rate_limits,
+            revisions=revisions)
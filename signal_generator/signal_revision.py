@@ -0,0 +1,161 @@
+"""
+TeaFIS is a cockpit display for aircraft
+Copyright (C) 2021  Ian O'Rourke
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+SignalRevision provides the translation from an older revision of the signal list to the
+current signal list
+"""
+
+import copy
+import typing
+
+from .signal_def_base import SignalDefinitionBase
+from .signal_def_data import SignalDefinitionData
+from .signal_def_scaled import SignalDefinitionScaled
+
+
+def schema_fingerprint(definitions: typing.Iterable[SignalDefinitionBase]) -> int:
+    """
+    Provides the 32-bit FNV-1a hash of the wire descriptors of the provided signals, in signal
+    index order. Only parameters that change how signals are sent contribute to the fingerprint
+    :param definitions: the signal definitions to determine the fingerprint for
+    :return: the signal list fingerprint
+    """
+    text = '\n'.join(s.wire_descriptor() for s in sorted(definitions, key=lambda x: x.signal_index()))
+
+    fingerprint = 0x811c9dc5
+    for b in text.encode('utf-8'):
+        fingerprint = ((fingerprint ^ b) * 0x01000193) & 0xffffffff
+    return fingerprint
+
+
+class SignalTranslation:
+    """
+    Class to maintain the translation of a single signal from an older signal list revision
+    """
+
+    def __init__(
+            self,
+            from_index: int,
+            to_index: typing.Optional[int],
+            source_resolution: typing.Optional[float] = None):
+        """
+        Creates a signal translation for the provided input parameters
+        :param from_index: the signal index within the older revision
+        :param to_index: the signal index within the current signal list, or None if the signal was removed
+        :param source_resolution: the resolution of the signal within the older revision, or None if unchanged
+        """
+        self.from_index = from_index
+        self.to_index = to_index
+        self.source_resolution = source_resolution
+
+
+class SignalRevision:
+    """
+    Class to maintain an older revision of the signal list, and the translations from it
+    """
+
+    def __init__(
+            self,
+            version: int,
+            fingerprint: int,
+            translations: typing.List[SignalTranslation]):
+        """
+        Creates a signal list revision for the provided input parameters
+        :param version: the version of the older signal list
+        :param fingerprint: the fingerprint of the older signal list
+        :param translations: the translations for signals that differ from the current signal list,
+            in ascending from_index order
+        """
+        self.version = version
+        self.fingerprint = fingerprint
+        self.translations = translations
+
+    @staticmethod
+    def from_json_def(
+            rev_def: typing.Dict[str, typing.Any],
+            current: typing.Dict[str, SignalDefinitionBase],
+            removed: typing.List[SignalDefinitionBase]) -> 'SignalRevision':
+        """
+        Provides a signal list revision from the JSON dictionary definition, which describes the
+        older revision by its differences from the current signal list, in the form
+          {"version": N, "added": [names], "changed": {name: {"cat_id", "sub_id", "resolution"}}, "removed": [signals]}
+        :param rev_def: the JSON dictionary definition for the revision
+        :param current: the current signal definitions
+        :param removed: the definitions of signals within the older revision that have since been removed
+        :return: the signal list revision
+        """
+        version = rev_def.get('version', None)
+        if not isinstance(version, int) or version <= 0:
+            raise ValueError('Signal list revision version must be an integer > 0')
+
+        # Reconstruct the older signal list from the current signal list
+        older = {name: copy.copy(sig) for name, sig in current.items()}
+
+        for name in rev_def.get('added', list()):
+            if name not in older:
+                raise ValueError('Revision {:d} adds unknown signal {:s}'.format(version, name))
+            del older[name]
+
+        for name, changes in rev_def.get('changed', dict()).items():
+            if name not in older:
+                raise ValueError('Revision {:d} changes unknown signal {:s}'.format(version, name))
+            sig = older[name]
+            sig.cat_id = int(changes.get('cat_id', sig.cat_id))
+            sig.sub_id = int(changes.get('sub_id', sig.sub_id))
+            if 'resolution' in changes:
+                if not isinstance(sig, SignalDefinitionScaled):
+                    raise ValueError('Revision {:d} changes the resolution of {:s}, which is not scaled'.format(
+                        version,
+                        name))
+                resolution = changes['resolution']
+                sig.resolution = SignalDefinitionScaled.RESOLUTION_MAP[resolution] \
+                    if isinstance(resolution, str) else float(resolution)
+
+        for sig in removed:
+            if sig.name in older:
+                raise ValueError('Revision {:d} removes current signal {:s}'.format(version, sig.name))
+            older[sig.name] = sig
+
+        indices = set(s.signal_index() for s in older.values())
+        if len(indices) != len(older):
+            raise ValueError('Revision {:d} has two signals with the same category and signal ids'.format(version))
+
+        # Determine the translation for each signal that is not sent identically in both
+        translations = list()
+        for name, sig in sorted(older.items(), key=lambda x: x[1].signal_index()):
+            target = current.get(name, None)
+            if target is None or type(target) != type(sig):
+                translations.append(SignalTranslation(from_index=sig.signal_index(), to_index=None))
+            elif isinstance(sig, SignalDefinitionData) and \
+                    (sig.size != target.size or sig.compression != target.compression):
+                translations.append(SignalTranslation(from_index=sig.signal_index(), to_index=None))
+            else:
+                source_resolution = None
+                if isinstance(sig, SignalDefinitionScaled) and sig.resolution != target.resolution:
+                    source_resolution = sig.resolution
+
+                if sig.signal_index() != target.signal_index() or source_resolution is not None:
+                    translations.append(SignalTranslation(
+                        from_index=sig.signal_index(),
+                        to_index=target.signal_index(),
+                        source_resolution=source_resolution))
+
+        return SignalRevision(
+            version=version,
+            fingerprint=schema_fingerprint(older.values()),
+            translations=translations)
@@ -0,0 +1,1452 @@
+// TeaFIS is a cockpit display for aircraft
+// Copyright (C) 2021  Ian O'Rourke
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+// signals_loadgen generates synthetic signal traffic for scale testing. Each
+// simulated device from the signal list device table publishes a set of scaled
+// signals at a fixed rate, following smooth waveforms with noise. Data signals
+// may be published as well, holding waypoint-like entries that are edited on
+// each publication, and are sent as data fragments if they do not fit within a
+// frame. Publication times may be jittered, records may be dropped or duplicated,
+// and whole frames may be dropped. Each frame starts with a frame_info record
+// holding the device frame sequence number. Frames are sent over UDP, written to
+// a recording file, or read directly into the local signal database.
+//
+// Recording files start with the magic "TFSR" and a 16-bit format version,
+// followed by one entry per frame: the 64-bit send time in nanoseconds from the
+// start of the run (as two 32-bit words, high word first), the 16-bit frame
+// length and the frame bytes. All values are big-endian.
+
+#include "data_reader.h"
+#include "data_writer.h"
+#include "gen_signal_def.h"
+#include "signal_compact.h"
+#include "signal_database.h"
+#include "signal_fragment.h"
+#include "signal_header.h"
+#include "signal_redundancy.h"
+#include "signal_type_data.h"
+#include "signal_type_scaled.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace efis_signals;
+
+// Define the recording file parameters
+static const uint32_t RECORDING_MAGIC = 0x54465352;
+static const uint16_t RECORDING_VERSION = 1;
+
+// Define the pacing parameters
+static const uint64_t SPIN_THRESHOLD_NANOS = 200000;
+static const uint64_t SLEEP_MARGIN_NANOS = 100000;
+
+// Define the waveform parameters
+static const double WAVEFORM_PI = 3.14159265358979323846;
+
+// Define the noise parameters
+static const size_t NOISE_TABLE_SIZE = 4096;
+
+// Define the generated data parameters, where each entry holds a waypoint name,
+// latitude, longitude and altitude, and the rest of the data is left empty
+static const size_t DATA_ENTRY_SIZE = 32;
+static const size_t DATA_NAME_SIZE = 8;
+static const size_t DATA_WAYPOINT_COUNT = 40;
+
+/**
+ * @brief The FastRandom struct provides an xorshift64* generator for the per-record
+ * random decisions, which are made millions of times per second
+ */
+struct FastRandom
+{
+    uint64_t state;
+
+    uint64_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    double next_uniform()
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+/**
+ * @brief The Waveform enum provides the value shapes for generated signals
+ */
+enum class Waveform
+{
+    Sine = 0,
+    Ramp = 1,
+    RandomWalk = 2
+};
+
+/**
+ * @brief The Options struct provides the command line configuration
+ */
+struct Options
+{
+    std::vector<std::string> device_names;
+    size_t device_count = 0;
+    std::vector<std::string> signal_names;
+    std::vector<std::pair<std::string, std::vector<std::string>>> device_signals;
+    std::vector<std::pair<std::string, double>> signal_rates;
+    double rate_hz = 50.0;
+    double data_rate_hz = 0.0;
+    std::string data_compression;
+    double scale = 1.0;
+    double jitter_millis = 0.0;
+    double loss = 0.0;
+    double duplicate = 0.0;
+    double frame_loss = 0.0;
+    size_t networks = 1;
+    double duration_seconds = 10.0;
+    double flush_millis = 1.0;
+    size_t mtu = 1400;
+    int wire_format = 1;
+    bool compact = false;
+    uint8_t priority = 0x80;
+    std::string output = "ingest";
+    uint64_t seed = 1;
+    bool show_statistics = false;
+};
+
+/**
+ * @brief The Device struct provides the state of a simulated device
+ */
+struct Device
+{
+    std::string name;
+    uint8_t device_id;
+    int32_t clock_offset_millis;
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> datagram;
+    DataWriter writer;
+    uint64_t frame_start_nanos;
+    size_t frame_records;
+};
+
+/**
+ * @brief The Stream struct provides the state of a single signal published by a
+ * device. Either the scaled signal or the data signal is set
+ */
+struct Stream
+{
+    std::unique_ptr<SignalTypeScaled> signal;
+    std::unique_ptr<SignalTypeData> data;
+    std::vector<uint8_t> data_values;
+    size_t device_index;
+    Waveform waveform;
+    double center;
+    double amplitude;
+    double period_seconds;
+    double phase;
+    double noise;
+    double walk_value;
+    uint64_t interval_nanos;
+    uint64_t nominal_nanos;
+};
+
+/**
+ * @brief The Event struct provides a scheduled publication of a stream
+ */
+struct Event
+{
+    uint64_t due_nanos;
+    uint32_t stream_index;
+
+    bool operator>(const Event& other) const
+    {
+        return due_nanos > other.due_nanos;
+    }
+};
+
+/**
+ * @brief The FrameCounters struct provides the counts of frames generated
+ */
+struct FrameCounters
+{
+    uint64_t frames;
+    uint64_t frames_dropped;
+    uint64_t bytes;
+};
+
+/**
+ * @brief The FrameOutput class provides the destination for generated frames
+ */
+class FrameOutput
+{
+public:
+    virtual ~FrameOutput()
+    {
+        // Empty Destructor
+    }
+
+    /**
+     * @brief send sends a single frame
+     * @param network is the index of the network to send the frame on
+     * @param frame is the frame data
+     * @param size is the frame size in bytes
+     * @param time_nanos is the send time from the start of the run
+     * @return true if the frame was sent
+     */
+    virtual bool send(
+            const size_t network,
+            const uint8_t* frame,
+            const size_t size,
+            const uint64_t time_nanos) = 0;
+
+    /**
+     * @brief finish completes the output once the run is over
+     */
+    virtual void finish()
+    {
+        // Empty by default
+    }
+};
+
+/**
+ * @brief The UdpOutput class sends each frame as a UDP datagram, using the
+ * port after the base port for the second network
+ */
+class UdpOutput : public FrameOutput
+{
+public:
+    UdpOutput() :
+        socket_handle(-1)
+    {
+        // Empty Constructor
+    }
+
+    virtual ~UdpOutput()
+    {
+        if (is_open())
+        {
+#ifdef _WIN32
+            closesocket(socket_handle);
+            WSACleanup();
+#else
+            close(socket_handle);
+#endif
+        }
+    }
+
+    bool open(
+            const std::string& host,
+            const uint16_t port)
+    {
+#ifdef _WIN32
+        WSADATA wsa_data;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+        {
+            return false;
+        }
+#endif
+
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
+        {
+            return false;
+        }
+
+        socket_handle = socket(AF_INET, SOCK_DGRAM, 0);
+        return is_open();
+    }
+
+    virtual bool send(
+            const size_t network,
+            const uint8_t* frame,
+            const size_t size,
+            const uint64_t) override
+    {
+        sockaddr_in network_address = address;
+        network_address.sin_port = htons(static_cast<uint16_t>(ntohs(address.sin_port) + network));
+
+        return sendto(
+                    socket_handle,
+                    reinterpret_cast<const char*>(frame),
+                    static_cast<int>(size),
+                    0,
+                    reinterpret_cast<const sockaddr*>(&network_address),
+                    sizeof(network_address)) == static_cast<int>(size);
+    }
+
+protected:
+    bool is_open() const
+    {
+#ifdef _WIN32
+        return socket_handle != INVALID_SOCKET;
+#else
+        return socket_handle >= 0;
+#endif
+    }
+
+protected:
+#ifdef _WIN32
+    SOCKET socket_handle;
+#else
+    int socket_handle;
+#endif
+
+    sockaddr_in address;
+};
+
+/**
+ * @brief The FileOutput class writes each frame into a recording file. Only
+ * frames sent on the first network are recorded
+ */
+class FileOutput : public FrameOutput
+{
+public:
+    bool open(const std::string& path)
+    {
+        file.open(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        uint8_t buffer[6];
+        DataWriter writer;
+        writer.set_buffer(buffer, sizeof(buffer));
+        writer.add_uint(RECORDING_MAGIC);
+        writer.add_ushort(RECORDING_VERSION);
+        file.write(reinterpret_cast<const char*>(buffer), writer.bytes_written());
+        return static_cast<bool>(file);
+    }
+
+    virtual bool send(
+            const size_t network,
+            const uint8_t* frame,
+            const size_t size,
+            const uint64_t time_nanos) override
+    {
+        if (network != 0)
+        {
+            return true;
+        }
+
+        uint8_t buffer[10];
+        DataWriter writer;
+        writer.set_buffer(buffer, sizeof(buffer));
+        writer.add_uint(static_cast<uint32_t>(time_nanos >> 32));
+        writer.add_uint(static_cast<uint32_t>(time_nanos));
+        writer.add_ushort(static_cast<uint16_t>(size));
+
+        file.write(reinterpret_cast<const char*>(buffer), writer.bytes_written());
+        file.write(reinterpret_cast<const char*>(frame), size);
+        return static_cast<bool>(file);
+    }
+
+    virtual void finish() override
+    {
+        file.flush();
+    }
+
+protected:
+    std::ofstream file;
+};
+
+/**
+ * @brief The IngestOutput class reads each frame into the local signal database,
+ * acting as a loopback transport. Frames are passed through the redundancy
+ * manager first, so that only the first copy from redundant networks is read
+ */
+class IngestOutput : public FrameOutput
+{
+public:
+    IngestOutput(const bool compact) :
+        compact(compact),
+        records_accepted(0),
+        records_rejected(0)
+    {
+        // Each compact record of at least two bytes expands to at most nine bytes
+        if (compact)
+        {
+            expanded.resize(5 * 65536);
+        }
+    }
+
+    virtual bool send(
+            const size_t network,
+            const uint8_t* frame,
+            const size_t size,
+            const uint64_t) override
+    {
+        SignalDatabase& database = SignalDatabase::get_instance();
+
+        DataReader reader;
+        reader.set_buffer(frame, size);
+
+        // Expand compact frames back into records, so that the redundancy manager
+        // can find the frame information
+        if (compact)
+        {
+            DataWriter expanded_writer;
+            expanded_writer.set_buffer(expanded.data(), expanded.size());
+            if (!CompactFrame::decode(reader, expanded_writer))
+            {
+                records_rejected += 1;
+                return true;
+            }
+
+            reader.set_buffer(expanded.data(), expanded_writer.bytes_written());
+        }
+
+        if (!redundancy.accept_frame(network, reader, get_millis()))
+        {
+            return true;
+        }
+
+        // The database skips the rest of the frame once a V1 record is rejected, as
+        // V1 records are not length-prefixed
+        while (reader.bytes_available() > 0)
+        {
+            if (database.read_data_into_dictionary(reader))
+            {
+                records_accepted += 1;
+            }
+            else
+            {
+                records_rejected += 1;
+            }
+        }
+
+        database.promote_candidates();
+        return true;
+    }
+
+    RedundancyManager redundancy;
+    bool compact;
+    std::vector<uint8_t> expanded;
+    uint64_t records_accepted;
+    uint64_t records_rejected;
+};
+
+/**
+ * @brief split splits a string on a separator character
+ * @param text is the string to split
+ * @param separator is the separator character
+ * @return the non-empty parts of the string
+ */
+static std::vector<std::string> split(
+        const std::string& text,
+        const char separator)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find(separator, start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        if (end > start)
+        {
+            parts.push_back(text.substr(start, end - start));
+        }
+
+        start = end + 1;
+    }
+    return parts;
+}
+
+/**
+ * @brief find_device finds a device in the generated signal list device table
+ * @param name is the device name to find
+ * @param device stores the device definition if found
+ * @return true if the device is found
+ */
+static bool find_device(
+        const std::string& name,
+        SignalDeviceDef& device)
+{
+    for (size_t i = 0; i < SIGNAL_DEVICE_COUNT; ++i)
+    {
+        if (name == SIGNAL_DEVICE_LIST[i].name)
+        {
+            device = SIGNAL_DEVICE_LIST[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief elapsed_nanos provides the time since the start of the run
+ * @param start is the start of the run
+ * @return the elapsed nanoseconds
+ */
+static uint64_t elapsed_nanos(const std::chrono::steady_clock::time_point& start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief wait_until waits until the target time, sleeping while the target is
+ * far away and spinning for the final stretch to keep the pacing precise
+ * @param start is the start of the run
+ * @param target_nanos is the time to wait until
+ */
+static void wait_until(
+        const std::chrono::steady_clock::time_point& start,
+        const uint64_t target_nanos)
+{
+    while (true)
+    {
+        const uint64_t now = elapsed_nanos(start);
+        if (now >= target_nanos)
+        {
+            return;
+        }
+        else if (target_nanos - now > SPIN_THRESHOLD_NANOS)
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(target_nanos - now - SLEEP_MARGIN_NANOS));
+        }
+    }
+}
+
+/**
+ * @brief stream_value provides the waveform value of a stream at a time
+ * @param stream is the stream to provide the value for
+ * @param time_seconds is the time from the start of the run
+ * @param noise_sample is a standard normal sample used for the noise
+ * @return the signal value
+ */
+static double stream_value(
+        Stream& stream,
+        const double time_seconds,
+        const double noise_sample)
+{
+    const double cycle = time_seconds / stream.period_seconds + stream.phase;
+    const double noise = stream.noise * noise_sample;
+
+    switch (stream.waveform)
+    {
+    case Waveform::Sine:
+        return stream.center + stream.amplitude * std::sin(2.0 * WAVEFORM_PI * cycle) + noise;
+    case Waveform::Ramp:
+        return stream.center + stream.amplitude * (2.0 * (cycle - std::floor(cycle)) - 1.0) + noise;
+    case Waveform::RandomWalk:
+    default:
+        // Step randomly, pulling the value back towards the center
+        stream.walk_value += noise * 10.0 - 0.01 * (stream.walk_value - stream.center);
+        return stream.walk_value;
+    }
+}
+
+/**
+ * @brief flush_frame sends the frame of a device on each network, if it contains any records
+ * @param device is the device to flush
+ * @param output is the frame output
+ * @param now_nanos is the current time from the start of the run
+ * @param options provides the network count and frame loss probability
+ * @param fast_random is the random generator used for frame loss
+ * @param counters counts the frames sent and dropped
+ */
+static void flush_frame(
+        Device& device,
+        FrameOutput& output,
+        const uint64_t now_nanos,
+        const Options& options,
+        FastRandom& fast_random,
+        FrameCounters& counters)
+{
+    DataReader records;
+    records.set_buffer(device.frame.data(), device.writer.bytes_written());
+
+    while (records.bytes_available() > 0)
+    {
+        // Send the records directly, or as one or more compact frames
+        const uint8_t* data = device.frame.data();
+        size_t size = records.bytes_available();
+
+        if (options.compact)
+        {
+            DataWriter compact_writer;
+            compact_writer.set_buffer(device.datagram.data(), device.datagram.size());
+            if (CompactFrame::encode(records, compact_writer) == 0)
+            {
+                break;
+            }
+
+            data = device.datagram.data();
+            size = compact_writer.bytes_written();
+        }
+        else
+        {
+            records.skip(size);
+        }
+
+        for (size_t network = 0; network < options.networks; ++network)
+        {
+            if (options.frame_loss > 0.0 && fast_random.next_uniform() < options.frame_loss)
+            {
+                counters.frames_dropped += 1;
+            }
+            else if (output.send(network, data, size, now_nanos))
+            {
+                counters.frames += 1;
+                counters.bytes += size;
+            }
+        }
+    }
+
+    device.writer.reset();
+    device.frame_records = 0;
+}
+
+/**
+ * @brief start_frame writes the frame information record if the frame of a device is empty
+ * @param device is the device to start the frame for
+ * @param now_nanos is the current time from the start of the run
+ * @return true if the frame has been started
+ */
+static bool start_frame(
+        Device& device,
+        const uint64_t now_nanos)
+{
+    if (device.writer.bytes_written() > 0)
+    {
+        return true;
+    }
+    else if (SignalDatabase::get_instance().write_frame_info(device.device_id, device.writer))
+    {
+        device.frame_start_nanos = now_nanos;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/**
+ * @brief write_record writes a record into the frame of a device. If the record
+ * does not fit, the frame is left as it was before the record
+ * @param device is the device to write the record for
+ * @param header is the record header
+ * @param signal is the signal providing the record payload
+ * @param max_size is the largest record size that can be sent
+ * @param now_nanos is the current time from the start of the run
+ * @return true if the record was written
+ */
+static bool write_record(
+        Device& device,
+        const SignalHeader& header,
+        const SignalTypeBase& signal,
+        const size_t max_size,
+        const uint64_t now_nanos)
+{
+    if (!start_frame(device, now_nanos))
+    {
+        return false;
+    }
+
+    const WireFormat format = SignalDatabase::get_instance().get_wire_format();
+    const size_t payload_size = signal.encoded_packet_size();
+    const size_t record_start = device.writer.bytes_written();
+    size_t payload_start = 0;
+
+    if (header.write_record_start(device.writer, format, payload_size, payload_start) &&
+            signal.serialize(device.writer) &&
+            SignalHeader::write_record_end(device.writer, format, payload_size, payload_start) &&
+            device.writer.bytes_written() - record_start <= max_size)
+    {
+        device.frame_records += 1;
+        return true;
+    }
+    else
+    {
+        device.writer.truncate(record_start);
+        return false;
+    }
+}
+
+/**
+ * @brief publish_record writes a record into the frame of a device, sending the
+ * frame first if the record does not fit within the space remaining
+ * @param device is the device to write the record for
+ * @param header is the record header
+ * @param signal is the signal providing the record payload
+ * @param output is the frame output
+ * @param now_nanos is the current time from the start of the run
+ * @param options provides the network count, MTU and frame loss probability
+ * @param fast_random is the random generator used for frame loss
+ * @param counters counts the frames sent and dropped
+ * @return true if the record was written, or false if it does not fit within a frame
+ */
+static bool publish_record(
+        Device& device,
+        const SignalHeader& header,
+        const SignalTypeBase& signal,
+        FrameOutput& output,
+        const uint64_t now_nanos,
+        const Options& options,
+        FastRandom& fast_random,
+        FrameCounters& counters)
+{
+    if (write_record(device, header, signal, options.mtu, now_nanos))
+    {
+        return true;
+    }
+    else if (device.frame_records == 0)
+    {
+        return false;
+    }
+
+    flush_frame(device, output, now_nanos, options, fast_random, counters);
+    return write_record(device, header, signal, options.mtu, now_nanos);
+}
+
+/**
+ * @brief publish_data writes the current values of a data stream into the frame of
+ * a device, as a single record if it fits within a frame, or as data fragments
+ * spread over as many frames as needed otherwise
+ * @param stream is the data stream to publish
+ * @param device is the device publishing the stream
+ * @param output is the frame output
+ * @param now_nanos is the current time from the start of the run
+ * @param options provides the network count, MTU and frame loss probability
+ * @param fast_random is the random generator used for frame loss
+ * @param counters counts the frames sent and dropped
+ * @return true if the values were written
+ */
+static bool publish_data(
+        Stream& stream,
+        Device& device,
+        FrameOutput& output,
+        const uint64_t now_nanos,
+        const Options& options,
+        FastRandom& fast_random,
+        FrameCounters& counters)
+{
+    if (publish_record(device, stream.data->get_header(), *stream.data, output, now_nanos, options, fast_random, counters))
+    {
+        return true;
+    }
+    else if (!start_frame(device, now_nanos))
+    {
+        return false;
+    }
+
+    // Each fragment must fit within a frame after the frame information record
+    SignalFragmenter fragmenter(
+                options.mtu - device.writer.bytes_written(),
+                SignalDatabase::get_instance().get_wire_format());
+    if (!fragmenter.start(*stream.data))
+    {
+        return false;
+    }
+
+    while (fragmenter.is_active())
+    {
+        if (start_frame(device, now_nanos) && fragmenter.write_fragment(device.writer))
+        {
+            device.frame_records += 1;
+        }
+        else if (device.frame_records == 0)
+        {
+            return false;
+        }
+        else
+        {
+            flush_frame(device, output, now_nanos, options, fast_random, counters);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief waypoint_count provides the number of waypoint entries held by a data stream
+ * @param stream is the data stream
+ * @return the number of waypoint entries
+ */
+static size_t waypoint_count(const Stream& stream)
+{
+    return std::min(DATA_WAYPOINT_COUNT, stream.data_values.size() / DATA_ENTRY_SIZE);
+}
+
+/**
+ * @brief init_data_values fills the start of the values of a data stream with
+ * waypoint entries, following a route from a random start point so that the
+ * values compress as a flight plan would
+ * @param stream is the data stream to fill
+ * @param rng is the random generator used for the route
+ */
+static void init_data_values(
+        Stream& stream,
+        std::mt19937_64& rng)
+{
+    stream.data_values.assign(stream.data->data_size(), 0);
+
+    uint32_t latitude = static_cast<uint32_t>(rng());
+    uint32_t longitude = static_cast<uint32_t>(rng());
+
+    for (size_t entry = 0; entry < waypoint_count(stream); ++entry)
+    {
+        const size_t offset = entry * DATA_ENTRY_SIZE;
+        snprintf(reinterpret_cast<char*>(&stream.data_values[offset]), DATA_NAME_SIZE, "WPT%04u", static_cast<unsigned>(entry));
+
+        latitude += static_cast<uint32_t>(rng() % 65536);
+        longitude += static_cast<uint32_t>(rng() % 65536);
+
+        DataWriter writer;
+        writer.set_buffer(&stream.data_values[offset + DATA_NAME_SIZE], DATA_ENTRY_SIZE - DATA_NAME_SIZE);
+        writer.add_uint(latitude);
+        writer.add_uint(longitude);
+        writer.add_ushort(static_cast<uint16_t>((rng() % 45) * 1000));
+    }
+}
+
+/**
+ * @brief update_data_values changes the altitude of a single waypoint entry of a
+ * data stream, as an edit to a flight plan would
+ * @param stream is the data stream to update
+ * @param fast_random is the random generator used to choose the change
+ */
+static void update_data_values(
+        Stream& stream,
+        FastRandom& fast_random)
+{
+    const size_t entry_count = waypoint_count(stream);
+    if (entry_count == 0)
+    {
+        return;
+    }
+
+    const size_t offset = (fast_random.next() % entry_count) * DATA_ENTRY_SIZE + DATA_NAME_SIZE + 8;
+
+    DataWriter writer;
+    writer.set_buffer(&stream.data_values[offset], 2);
+    writer.add_ushort(static_cast<uint16_t>((fast_random.next() % 45) * 1000));
+}
+
+static void print_usage(const char* name)
+{
+    printf(
+        "usage: %s [options]\n"
+        "  --devices=NAME,...             devices to simulate (default: all but \"any\")\n"
+        "  --device-count=N               simulate only the first N devices\n"
+        "  --signals=NAME,...             scaled signals each device publishes (default: every\n"
+        "                                 scaled signal, shared out between the devices)\n"
+        "  --device-signals=DEVICE:NAME,... signals for a single device\n"
+        "  --rate=HZ                      publication rate of each signal (default: 50)\n"
+        "  --signal-rate=NAME:HZ          publication rate of a single signal\n"
+        "  --data-rate=HZ                 publication rate of each data signal, shared out between\n"
+        "                                 the devices (default: 0, data signals are not published)\n"
+        "  --data-compression=none|lz     compression of the published data signals (default: as\n"
+        "                                 in the signal list). Data too large for a frame is sent\n"
+        "                                 as data fragments\n"
+        "  --scale=X                      multiply every rate by X\n"
+        "  --jitter=MS                    standard deviation of publication time jitter\n"
+        "  --loss=P                       probability of dropping a record\n"
+        "  --duplicate=P                  probability of duplicating a record\n"
+        "  --frame-loss=P                 probability of dropping a whole frame on each network\n"
+        "  --networks=N                   send every frame over N redundant networks (1 or 2)\n"
+        "  --duration=SECONDS             length of the run (default: 10)\n"
+        "  --flush=MS                     longest time a partial frame is held (default: 1)\n"
+        "  --mtu=BYTES                    largest frame size (default: 1400)\n"
+        "  --wire-format=1|2              record framing, 2 adds a length to each record (default: 1)\n"
+        "  --compact                      send compact frames, which share the header fields (implies\n"
+        "                                 --wire-format=2)\n"
+        "  --priority=N                   header priority of every record (default: 128)\n"
+        "  --output=ingest|udp:HOST:PORT|file:PATH  frame destination (default: ingest)\n"
+        "  --seed=N                       random seed\n"
+        "  --stats                        print the ingest statistics (ingest output only)\n",
+        name);
+}
+
+static bool parse_options(
+        int argc,
+        char** argv,
+        Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const size_t equals = arg.find('=');
+        const std::string key = arg.substr(0, equals);
+        const std::string value = equals != std::string::npos ? arg.substr(equals + 1) : "";
+
+        if (key == "--devices")
+        {
+            options.device_names = split(value, ',');
+        }
+        else if (key == "--device-count")
+        {
+            options.device_count = static_cast<size_t>(atoi(value.c_str()));
+        }
+        else if (key == "--signals")
+        {
+            options.signal_names = split(value, ',');
+        }
+        else if (key == "--device-signals" && value.find(':') != std::string::npos)
+        {
+            const size_t colon = value.find(':');
+            options.device_signals.push_back(std::make_pair(value.substr(0, colon), split(value.substr(colon + 1), ',')));
+        }
+        else if (key == "--rate")
+        {
+            options.rate_hz = atof(value.c_str());
+        }
+        else if (key == "--signal-rate" && value.find(':') != std::string::npos)
+        {
+            const size_t colon = value.find(':');
+            options.signal_rates.push_back(std::make_pair(value.substr(0, colon), atof(value.substr(colon + 1).c_str())));
+        }
+        else if (key == "--data-rate")
+        {
+            options.data_rate_hz = atof(value.c_str());
+        }
+        else if (key == "--data-compression")
+        {
+            options.data_compression = value;
+        }
+        else if (key == "--scale")
+        {
+            options.scale = atof(value.c_str());
+        }
+        else if (key == "--jitter")
+        {
+            options.jitter_millis = atof(value.c_str());
+        }
+        else if (key == "--loss")
+        {
+            options.loss = atof(value.c_str());
+        }
+        else if (key == "--duplicate")
+        {
+            options.duplicate = atof(value.c_str());
+        }
+        else if (key == "--frame-loss")
+        {
+            options.frame_loss = atof(value.c_str());
+        }
+        else if (key == "--networks")
+        {
+            options.networks = static_cast<size_t>(atoi(value.c_str()));
+        }
+        else if (key == "--duration")
+        {
+            options.duration_seconds = atof(value.c_str());
+        }
+        else if (key == "--flush")
+        {
+            options.flush_millis = atof(value.c_str());
+        }
+        else if (key == "--mtu")
+        {
+            options.mtu = static_cast<size_t>(atoi(value.c_str()));
+        }
+        else if (key == "--wire-format")
+        {
+            options.wire_format = atoi(value.c_str());
+        }
+        else if (key == "--compact")
+        {
+            options.compact = true;
+        }
+        else if (key == "--priority")
+        {
+            options.priority = static_cast<uint8_t>(atoi(value.c_str()));
+        }
+        else if (key == "--output")
+        {
+            options.output = value;
+        }
+        else if (key == "--seed")
+        {
+            options.seed = strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (key == "--stats")
+        {
+            options.show_statistics = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return options.rate_hz > 0.0 &&
+            options.data_rate_hz >= 0.0 &&
+            (options.data_compression.empty() || options.data_compression == "none" || options.data_compression == "lz") &&
+            options.scale > 0.0 &&
+            options.duration_seconds > 0.0 &&
+            options.networks >= 1 &&
+            options.networks <= RedundancyManager::NETWORK_COUNT &&
+            options.mtu >= 64 &&
+            options.mtu <= 65535 &&
+            (options.wire_format == 1 || options.wire_format == 2);
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (options.compact)
+    {
+        options.wire_format = 2;
+    }
+
+    SignalDatabase::get_instance().set_wire_format(static_cast<WireFormat>(options.wire_format));
+
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // Determine the simulated devices
+    std::vector<Device> devices;
+    if (options.device_names.empty())
+    {
+        for (size_t i = 0; i < SIGNAL_DEVICE_COUNT; ++i)
+        {
+            if (SIGNAL_DEVICE_LIST[i].device_id != 0)
+            {
+                options.device_names.push_back(SIGNAL_DEVICE_LIST[i].name);
+            }
+        }
+    }
+
+    if (options.device_count > 0 && options.device_count < options.device_names.size())
+    {
+        options.device_names.resize(options.device_count);
+    }
+
+    for (const std::string& name : options.device_names)
+    {
+        SignalDeviceDef device_def;
+        if (!find_device(name, device_def))
+        {
+            fprintf(stderr, "unknown device %s\n", name.c_str());
+            return 1;
+        }
+
+        Device device;
+        device.name = name;
+        device.device_id = device_def.device_id;
+        device.clock_offset_millis = static_cast<int32_t>(uniform(rng) * 100000.0);
+        // Compact frames are encoded from V2 records, which are about twice the
+        // size, so the record frame is allowed to grow past the MTU
+        device.frame.resize(options.compact ? 2 * options.mtu : options.mtu);
+        device.datagram.resize(options.compact ? options.mtu : 0);
+        device.frame_start_nanos = 0;
+        device.frame_records = 0;
+        devices.push_back(std::move(device));
+    }
+
+    for (Device& device : devices)
+    {
+        device.writer.set_buffer(device.frame.data(), device.frame.size());
+    }
+
+    // Determine the signals published by each device
+    SignalDatabase& database = SignalDatabase::get_instance();
+    std::vector<SignalDef> default_signals;
+    if (options.signal_names.empty())
+    {
+        for (size_t i = 0; i < database.size(); ++i)
+        {
+            SignalTypeBase* signal = nullptr;
+            if (database.get_signal_for_index(i, &signal) && dynamic_cast<SignalTypeScaled*>(signal) != nullptr)
+            {
+                default_signals.push_back(signal->get_header().get_signal_def());
+            }
+        }
+    }
+
+    std::vector<Stream> streams;
+    for (size_t d = 0; d < devices.size(); ++d)
+    {
+        std::vector<std::string> names = options.signal_names;
+        for (const auto& device_signal : options.device_signals)
+        {
+            if (device_signal.first == devices[d].name)
+            {
+                names = device_signal.second;
+            }
+        }
+
+        // Without a configured list, share the signals between the devices so that
+        // each signal has a single source
+        std::vector<SignalDef> defs;
+        if (names.empty())
+        {
+            for (size_t i = d; i < default_signals.size(); i += devices.size())
+            {
+                defs.push_back(default_signals[i]);
+            }
+        }
+
+        for (const std::string& name : names)
+        {
+            SignalDef def;
+            SignalTypeScaled* scaled = nullptr;
+            if (!get_signal_def_for_name(name, def) || !database.get_scaled_signal(def, &scaled))
+            {
+                fprintf(stderr, "unknown scaled signal %s\n", name.c_str());
+                return 1;
+            }
+            defs.push_back(def);
+        }
+
+        for (const SignalDef& def : defs)
+        {
+            SignalTypeScaled* database_signal = nullptr;
+            database.get_scaled_signal(def, &database_signal);
+
+            // Create a transmitting copy of the signal for the device
+            Stream stream;
+            stream.signal.reset(new SignalTypeScaled(def, database_signal->get_scale()));
+            stream.signal->set_source_type(SignalSourceType::Transmitted);
+            stream.signal->set_from_device(devices[d].device_id);
+            stream.signal->set_priority(options.priority);
+            stream.device_index = d;
+
+            // Determine the publication interval
+            std::string name;
+            get_signal_name_for_def(def, name);
+            double rate = options.rate_hz;
+            for (const auto& signal_rate : options.signal_rates)
+            {
+                if (signal_rate.first == name)
+                {
+                    rate = signal_rate.second;
+                }
+            }
+            stream.interval_nanos = static_cast<uint64_t>(1.0e9 / (rate * options.scale));
+            stream.interval_nanos = std::max<uint64_t>(stream.interval_nanos, 1);
+            stream.nominal_nanos = static_cast<uint64_t>(uniform(rng) * stream.interval_nanos);
+
+            // Choose a waveform within the range of the signal
+            stream.waveform = static_cast<Waveform>(rng() % 3);
+            stream.amplitude = stream.signal->get_scale().resolution * 65536.0 * (0.25 + 0.75 * uniform(rng));
+            stream.center = stream.amplitude * (8.0 * uniform(rng) - 4.0);
+            stream.period_seconds = 2.0 + 18.0 * uniform(rng);
+            stream.phase = uniform(rng);
+            stream.noise = stream.amplitude * 0.01;
+            stream.walk_value = stream.center;
+
+            streams.push_back(std::move(stream));
+        }
+    }
+
+    // Share the data signals between the devices, if published
+    if (options.data_rate_hz > 0.0)
+    {
+        size_t data_count = 0;
+        for (size_t i = 0; i < database.size(); ++i)
+        {
+            SignalTypeBase* signal = nullptr;
+            SignalTypeData* database_data = nullptr;
+            if (!database.get_signal_for_index(i, &signal) || (database_data = dynamic_cast<SignalTypeData*>(signal)) == nullptr)
+            {
+                continue;
+            }
+
+            const SignalDef def = signal->get_header().get_signal_def();
+            const size_t d = data_count % devices.size();
+            data_count += 1;
+
+            // Create a transmitting copy of the signal for the device
+            Stream stream;
+            stream.data.reset(new SignalTypeData(def, database_data->data_size()));
+            stream.data->set_compression(
+                        options.data_compression.empty() ? database_data->get_compression() :
+                        (options.data_compression == "lz" ? DataCompression::Lz : DataCompression::None));
+            stream.data->set_source_type(SignalSourceType::Transmitted);
+            stream.data->set_from_device(devices[d].device_id);
+            stream.data->set_priority(options.priority);
+            stream.device_index = d;
+            init_data_values(stream, rng);
+
+            std::string name;
+            get_signal_name_for_def(def, name);
+            double rate = options.data_rate_hz;
+            for (const auto& signal_rate : options.signal_rates)
+            {
+                if (signal_rate.first == name)
+                {
+                    rate = signal_rate.second;
+                }
+            }
+            stream.interval_nanos = static_cast<uint64_t>(1.0e9 / (rate * options.scale));
+            stream.interval_nanos = std::max<uint64_t>(stream.interval_nanos, 1);
+            stream.nominal_nanos = static_cast<uint64_t>(uniform(rng) * stream.interval_nanos);
+
+            streams.push_back(std::move(stream));
+        }
+    }
+
+    if (streams.empty())
+    {
+        fprintf(stderr, "no signals to publish\n");
+        return 1;
+    }
+
+    // Open the output
+    std::unique_ptr<FrameOutput> output;
+    IngestOutput* ingest_output = nullptr;
+    if (options.output == "ingest")
+    {
+        for (size_t i = 0; i < database.size(); ++i)
+        {
+            SignalTypeBase* signal = nullptr;
+            if (database.get_signal_for_index(i, &signal))
+            {
+                signal->set_source_type(SignalSourceType::Received);
+            }
+        }
+
+        database.get_statistics().set_enabled(options.show_statistics);
+        ingest_output = new IngestOutput(options.compact);
+        output.reset(ingest_output);
+    }
+    else if (options.output.compare(0, 4, "udp:") == 0 && options.output.rfind(':') > 4)
+    {
+        const size_t colon = options.output.rfind(':');
+        std::unique_ptr<UdpOutput> udp_output(new UdpOutput());
+        if (!udp_output->open(
+                    options.output.substr(4, colon - 4),
+                    static_cast<uint16_t>(atoi(options.output.substr(colon + 1).c_str()))))
+        {
+            fprintf(stderr, "unable to open %s\n", options.output.c_str());
+            return 1;
+        }
+        output = std::move(udp_output);
+    }
+    else if (options.output.compare(0, 5, "file:") == 0)
+    {
+        std::unique_ptr<FileOutput> file_output(new FileOutput());
+        if (!file_output->open(options.output.substr(5)))
+        {
+            fprintf(stderr, "unable to open %s\n", options.output.c_str());
+            return 1;
+        }
+        output = std::move(file_output);
+    }
+    else
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Schedule the first publication of every stream
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    for (size_t i = 0; i < streams.size(); ++i)
+    {
+        events.push(Event { streams[i].nominal_nanos, static_cast<uint32_t>(i) });
+    }
+
+    // Precompute normal samples for the waveform noise and publication jitter
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> noise_table(NOISE_TABLE_SIZE);
+    for (double& sample : noise_table)
+    {
+        sample = normal(rng);
+    }
+
+    FastRandom fast_random = { rng() | 1 };
+    const double jitter_nanos = options.jitter_millis * 1.0e6;
+    const uint64_t duration_nanos = static_cast<uint64_t>(options.duration_seconds * 1.0e9);
+    const uint64_t flush_nanos = static_cast<uint64_t>(options.flush_millis * 1.0e6);
+
+    uint64_t records_generated = 0;
+    uint64_t records_dropped = 0;
+    uint64_t records_duplicated = 0;
+    uint64_t records_unsent = 0;
+    FrameCounters counters = { 0, 0, 0 };
+    uint64_t max_lag_nanos = 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    uint64_t now = 0;
+
+    while (!events.empty() && events.top().due_nanos < duration_nanos)
+    {
+        const Event event = events.top();
+
+        // Only read the clock once the schedule appears to be caught up
+        if (event.due_nanos > now)
+        {
+            now = elapsed_nanos(start);
+        }
+
+        if (event.due_nanos > now)
+        {
+            // Send frames that have been held for the flush interval, then wait for the next event
+            uint64_t wake_nanos = event.due_nanos;
+            for (Device& device : devices)
+            {
+                if (device.writer.bytes_written() == 0)
+                {
+                    continue;
+                }
+                else if (now >= device.frame_start_nanos + flush_nanos)
+                {
+                    flush_frame(device, *output, now, options, fast_random, counters);
+                }
+                else
+                {
+                    wake_nanos = std::min(wake_nanos, device.frame_start_nanos + flush_nanos);
+                }
+            }
+
+            wait_until(start, wake_nanos);
+            continue;
+        }
+
+        events.pop();
+        max_lag_nanos = std::max(max_lag_nanos, now - event.due_nanos);
+
+        // Update the stream value and determine the number of copies to send
+        Stream& stream = streams[event.stream_index];
+        Device& device = devices[stream.device_index];
+
+        if (stream.data)
+        {
+            update_data_values(stream, fast_random);
+            stream.data->set_data(stream.data_values.data(), static_cast<SignalTypeData::data_size_t>(stream.data_values.size()));
+        }
+        else
+        {
+            const double noise_sample = noise_table[fast_random.next() % NOISE_TABLE_SIZE];
+            stream.signal->set_value(stream_value(stream, event.due_nanos * 1.0e-9, noise_sample));
+        }
+        records_generated += 1;
+
+        size_t copies = 1;
+        if (options.loss > 0.0 && fast_random.next_uniform() < options.loss)
+        {
+            copies = 0;
+            records_dropped += 1;
+        }
+        else if (options.duplicate > 0.0 && fast_random.next_uniform() < options.duplicate)
+        {
+            copies = 2;
+            records_duplicated += 1;
+        }
+
+        // Write the record, stamped with the simulated device clock. Records that
+        // cannot be written, even into an empty frame, are counted as unsent
+        for (size_t c = 0; c < copies; ++c)
+        {
+            bool published = false;
+            if (stream.data)
+            {
+                published = publish_data(stream, device, *output, now, options, fast_random, counters);
+            }
+            else
+            {
+                SignalHeader header = stream.signal->get_header();
+                header.timestamp += device.clock_offset_millis;
+                published = publish_record(device, header, *stream.signal, *output, now, options, fast_random, counters);
+            }
+
+            if (!published)
+            {
+                records_unsent += 1;
+            }
+        }
+
+        // Schedule the next publication from the nominal time, so that jitter does not accumulate
+        stream.nominal_nanos += stream.interval_nanos;
+        const double jittered = static_cast<double>(stream.nominal_nanos) +
+                (jitter_nanos > 0.0 ? jitter_nanos * noise_table[fast_random.next() % NOISE_TABLE_SIZE] : 0.0);
+        events.push(Event { jittered > 0.0 ? static_cast<uint64_t>(jittered) : 0, event.stream_index });
+    }
+
+    // Send any remaining partial frames
+    const uint64_t end_nanos = elapsed_nanos(start);
+    for (Device& device : devices)
+    {
+        flush_frame(device, *output, end_nanos, options, fast_random, counters);
+    }
+    output->finish();
+
+    // Report the run summary
+    const double seconds = end_nanos * 1.0e-9;
+    printf("devices,streams,records,dropped,duplicated,frames,frames_dropped,bytes,seconds,records_per_sec,max_lag_us,unsent\n");
+    printf("%zu,%zu,%llu,%llu,%llu,%llu,%llu,%llu,%.3f,%.1f,%.1f,%llu\n",
+           devices.size(),
+           streams.size(),
+           static_cast<unsigned long long>(records_generated),
+           static_cast<unsigned long long>(records_dropped),
+           static_cast<unsigned long long>(records_duplicated),
+           static_cast<unsigned long long>(counters.frames),
+           static_cast<unsigned long long>(counters.frames_dropped),
+           static_cast<unsigned long long>(counters.bytes),
+           seconds,
+           records_generated / seconds,
+           max_lag_nanos * 1.0e-3,
+           static_cast<unsigned long long>(records_unsent));
+
+    if (ingest_output != nullptr)
+    {
+        printf("ingest_accepted,ingest_rejected\n");
+        printf("%llu,%llu\n",
+               static_cast<unsigned long long>(ingest_output->records_accepted),
+               static_cast<unsigned long long>(ingest_output->records_rejected));
+
+        if (options.show_statistics)
+        {
+            database.get_statistics().dump(std::cout);
+            database.get_sequences().dump(std::cout);
+            ingest_output->redundancy.dump(std::cout, get_millis());
+        }
+    }
+
+    return 0;
+}